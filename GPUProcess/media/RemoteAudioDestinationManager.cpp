@@ -40,6 +40,12 @@
 #include <WebCore/CARingBuffer.h>
 #include <WebCore/WebAudioBufferList.h>
 #include <wtf/cocoa/MachSemaphore.h>
+#elif OS(LINUX)
+#include "Logging.h"
+#include "SharedAudioRingBuffer.h"
+#include <WebCore/AudioBus.h>
+#include <WebCore/AudioDestination.h>
+#include <WebCore/AudioIOCallback.h>
 #endif
 
 namespace WebKit {
@@ -48,6 +54,8 @@ class RemoteAudioDestination
     : public ThreadSafeRefCounted<RemoteAudioDestination>
 #if PLATFORM(COCOA)
     , public WebCore::AudioUnitRenderer
+#elif OS(LINUX)
+    , public WebCore::AudioIOCallback
 #endif
 {
 public:
@@ -74,6 +82,9 @@ public:
     {
         m_ringBuffer = makeUniqueRef<WebCore::CARingBuffer>(makeUniqueRef<ReadOnlySharedRingBufferStorage>(ipcHandle.handle), description, numberOfFrames);
     }
+#elif OS(LINUX)
+    bool createRingBufferHandle(SharedMemory::Handle& handle) { return m_ringBuffer && m_ringBuffer->createHandle(handle); }
+    size_t ringBufferSize() const { return m_ringBuffer ? m_ringBuffer->size() : 0; }
 #endif
 
     void start()
@@ -83,6 +94,14 @@ public:
             return;
 
         m_isPlaying = true;
+#elif OS(LINUX)
+        if (!m_ringBuffer || m_isPlaying)
+            return;
+
+        m_destination->start(nullptr);
+        m_isPlaying = true;
+        // Let the WebContent process get ahead by a couple of quanta before the first device callback.
+        m_ringBuffer->requestRender(initialRenderQuantaCount);
 #endif
     }
 
@@ -94,6 +113,21 @@ public:
 
         m_isPlaying = false;
 
+        if (m_protectThisDuringGracefulShutdown) {
+            RELEASE_ASSERT(refCount() == 1);
+            m_protectThisDuringGracefulShutdown = nullptr;
+        }
+#elif OS(LINUX)
+        if (!m_isPlaying)
+            return;
+
+        m_destination->stop();
+        m_isPlaying = false;
+
+        auto statistics = m_ringBuffer->statistics();
+        RELEASE_LOG(Media, "RemoteAudioDestination::stop: %" PRIu64 " underruns, %" PRIu64 " overruns, render wake-up latency average %.3f ms, maximum %.3f ms",
+            statistics.underrunCount, statistics.overrunCount, statistics.averageWakeUpLatency.milliseconds(), statistics.maximumWakeUpLatency.milliseconds());
+
         if (m_protectThisDuringGracefulShutdown) {
             RELEASE_ASSERT(refCount() == 1);
             m_protectThisDuringGracefulShutdown = nullptr;
@@ -113,6 +147,11 @@ private:
     {
 #if PLATFORM(COCOA)
         m_audioOutputUnitAdaptor.configure(hardwareSampleRate, numberOfOutputChannels);
+#elif OS(LINUX)
+        // The destination renders at sampleRate, so that is the rate the ring buffer is filled and drained at.
+        UNUSED_PARAM(hardwareSampleRate);
+        m_ringBuffer = SharedAudioRingBuffer::allocate(numberOfOutputChannels, sampleRate * ringBufferSizeInSeconds.seconds());
+        m_destination = WebCore::AudioDestination::create(*this, inputDeviceId, numberOfInputChannels, numberOfOutputChannels, sampleRate);
 #endif
     }
 
@@ -138,6 +177,31 @@ private:
 
         return status;
     }
+#elif OS(LINUX)
+    // WebCore::AudioIOCallback, called on the audio device thread.
+    void render(WebCore::AudioBus*, WebCore::AudioBus* destinationBus, size_t numberOfFrames, const WebCore::AudioIOPosition&) final
+    {
+        ASSERT(!isMainThread());
+
+        if (m_protectThisDuringGracefulShutdown || !m_isPlaying || !destinationBus || destinationBus->numberOfChannels() != m_ringBuffer->numberOfChannels()) {
+            if (destinationBus)
+                destinationBus->zero();
+            return;
+        }
+
+        Vector<float*, 8> channels;
+        for (unsigned i = 0; i < destinationBus->numberOfChannels(); ++i)
+            channels.append(destinationBus->channel(i)->mutableData());
+        m_ringBuffer->read(channels.data(), numberOfFrames);
+
+        // Ask the audio thread in the WebContent process to render as many quanta as were just consumed.
+        m_ringBuffer->requestRender((numberOfFrames + WebCore::AudioUtilities::renderQuantumSize - 1) / WebCore::AudioUtilities::renderQuantumSize);
+    }
+
+    void isPlayingDidChange() final { }
+
+    static constexpr Seconds ringBufferSizeInSeconds { 100_ms };
+    static constexpr unsigned initialRenderQuantaCount { 2 };
 #endif
 
     RemoteAudioDestinationIdentifier m_id;
@@ -150,6 +214,9 @@ private:
     UniqueRef<WebCore::CARingBuffer> m_ringBuffer;
     MachSemaphore m_renderSemaphore;
     uint64_t m_startFrame { 0 };
+#elif OS(LINUX)
+    RefPtr<SharedAudioRingBuffer> m_ringBuffer;
+    RefPtr<WebCore::AudioDestination> m_destination;
 #endif
 
     bool m_isPlaying { false };
@@ -169,6 +236,10 @@ void RemoteAudioDestinationManager::createAudioDestination(const String& inputDe
     m_audioDestinations.add(newID, destination.copyRef());
 #if PLATFORM(COCOA)
     completionHandler(newID, destination->createRenderSemaphoreSendRight());
+#elif OS(LINUX)
+    SharedMemory::Handle handle;
+    destination->createRingBufferHandle(handle);
+    completionHandler(newID, SharedMemory::IPCHandle { WTFMove(handle), destination->ringBufferSize() });
 #else
     completionHandler(newID);
 #endif
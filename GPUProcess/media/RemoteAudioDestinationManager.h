@@ -65,6 +65,8 @@ private:
 
 #if PLATFORM(COCOA)
     using CreationCompletionHandler = CompletionHandler<void(RemoteAudioDestinationIdentifier, WTF::MachSendRight)>;
+#elif OS(LINUX)
+    using CreationCompletionHandler = CompletionHandler<void(RemoteAudioDestinationIdentifier, SharedMemory::IPCHandle&&)>;
 #else
     using CreationCompletionHandler = CompletionHandler<void(RemoteAudioDestinationIdentifier)>;
 #endif
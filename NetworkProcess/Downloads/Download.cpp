@@ -79,13 +79,27 @@ Download::Download(DownloadManager& downloadManager, DownloadID downloadID, NSUR
 }
 #endif
 
+#if USE(SOUP)
+Download::Download(DownloadManager& downloadManager, DownloadID downloadID, NetworkSession& session)
+    : m_downloadManager(downloadManager)
+    , m_downloadID(downloadID)
+    , m_client(downloadManager.client())
+    , m_sessionID(session.sessionID())
+    , m_testSpeedMultiplier(session.testSpeedMultiplier())
+{
+    ASSERT(m_downloadID);
+
+    m_downloadManager.didCreateDownload();
+}
+#endif
+
 Download::~Download()
 {
     platformDestroyDownload();
     m_downloadManager.didDestroyDownload();
 }
 
-void Download::cancel(CompletionHandler<void(const IPC::DataReference&)>&& completionHandler, IgnoreDidFailCallback ignoreDidFailCallback)
+void Download::cancel(CompletionHandler<void(const IPC::DataReference&)>&& completionHandler, IgnoreDidFailCallback ignoreDidFailCallback, ProduceResumeData produceResumeData)
 {
     RELEASE_ASSERT(isMainThread());
 
@@ -105,8 +119,13 @@ void Download::cancel(CompletionHandler<void(const IPC::DataReference&)>&& compl
     };
 
     if (m_download) {
-        m_download->cancel();
-        completionHandlerWrapper({ });
+        if (produceResumeData == ProduceResumeData::No) {
+            // The partial file is only kept when it can be resumed.
+            m_download->cancel();
+            completionHandlerWrapper({ });
+            return;
+        }
+        m_download->cancelByProducingResumeData(WTFMove(completionHandlerWrapper));
         return;
     }
     platformCancelNetworkLoad(WTFMove(completionHandlerWrapper));
@@ -69,12 +69,15 @@ public:
 #if PLATFORM(COCOA)
     Download(DownloadManager&, DownloadID, NSURLSessionDownloadTask*, NetworkSession&, const String& suggestedFilename = { });
 #endif
+#if USE(SOUP)
+    Download(DownloadManager&, DownloadID, NetworkSession&);
+#endif
 
     ~Download();
 
     void resume(const IPC::DataReference& resumeData, const String& path, SandboxExtension::Handle&&);
     enum class IgnoreDidFailCallback : bool { No, Yes };
-    void cancel(CompletionHandler<void(const IPC::DataReference&)>&&, IgnoreDidFailCallback);
+    void cancel(CompletionHandler<void(const IPC::DataReference&)>&&, IgnoreDidFailCallback, ProduceResumeData);
 #if PLATFORM(COCOA)
     void publishProgress(const URL&, SandboxExtension::Handle&&);
 #endif
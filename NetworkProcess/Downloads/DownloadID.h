@@ -31,6 +31,9 @@ namespace WebKit {
 
 enum class AllowOverwrite : bool { No, Yes };
 
+// Whether a canceled download keeps its partial file around so that it can be resumed.
+enum class ProduceResumeData : bool { No, Yes };
+
 enum DownloadIdentifierType { };
 using DownloadID = ObjectIdentifier<DownloadIdentifierType>;
 
@@ -95,13 +95,17 @@ void DownloadManager::downloadDestinationDecided(DownloadID downloadID, Ref<Netw
 
 void DownloadManager::resumeDownload(PAL::SessionID sessionID, DownloadID downloadID, const IPC::DataReference& resumeData, const String& path, SandboxExtension::Handle&& sandboxExtensionHandle, CallDownloadDidStart callDownloadDidStart)
 {
-#if !PLATFORM(COCOA)
+#if !PLATFORM(COCOA) && !USE(SOUP)
     notImplemented();
 #else
     auto* networkSession = m_client.networkSession(sessionID);
     if (!networkSession)
         return;
+#if PLATFORM(COCOA)
     auto download = makeUnique<Download>(*this, downloadID, nullptr, *networkSession);
+#else
+    auto download = makeUnique<Download>(*this, downloadID, *networkSession);
+#endif
 
     download->resume(resumeData, path, WTFMove(sandboxExtensionHandle));
 
@@ -114,11 +118,11 @@ void DownloadManager::resumeDownload(PAL::SessionID sessionID, DownloadID downlo
 #endif
 }
 
-void DownloadManager::cancelDownload(DownloadID downloadID, CompletionHandler<void(const IPC::DataReference&)>&& completionHandler)
+void DownloadManager::cancelDownload(DownloadID downloadID, ProduceResumeData produceResumeData, CompletionHandler<void(const IPC::DataReference&)>&& completionHandler)
 {
     if (auto* download = m_downloads.get(downloadID)) {
         ASSERT(!m_pendingDownloads.contains(downloadID));
-        download->cancel(WTFMove(completionHandler), Download::IgnoreDidFailCallback::Yes);
+        download->cancel(WTFMove(completionHandler), Download::IgnoreDidFailCallback::Yes, produceResumeData);
         return;
     }
     if (auto pendingDownload = m_pendingDownloads.take(downloadID)) {
@@ -40,10 +40,12 @@
 namespace WebKit {
 using namespace WebCore;
 
-WebIDBConnectionToClient::WebIDBConnectionToClient(IPC::Connection& connection, WebCore::IDBConnectionIdentifier serverConnectionIdentifier)
+WebIDBConnectionToClient::WebIDBConnectionToClient(IPC::Connection& connection, WebCore::IDBConnectionIdentifier serverConnectionIdentifier, WebIDBServer& server, unsigned shardIndex)
     : m_connection(makeRef(connection))
     , m_identifier(serverConnectionIdentifier)
     , m_connectionToClient(IDBServer::IDBConnectionToClient::create(*this))
+    , m_server(server)
+    , m_shardIndex(shardIndex)
 {
 }
 
@@ -69,16 +71,23 @@ void WebIDBConnectionToClient::didDeleteDatabase(const WebCore::IDBResultData& r
 
 void WebIDBConnectionToClient::didOpenDatabase(const WebCore::IDBResultData& resultData)
 {
+    if (resultData.type() == IDBResultType::OpenDatabaseSuccess || resultData.type() == IDBResultType::OpenDatabaseUpgradeNeeded)
+        m_server.registerDatabaseConnection(resultData.databaseConnectionIdentifier(), m_identifier, m_shardIndex);
+    if (resultData.type() == IDBResultType::OpenDatabaseUpgradeNeeded)
+        m_server.registerTransaction(resultData.transactionInfo().identifier(), m_shardIndex);
+
     send(Messages::WebIDBConnectionToServer::DidOpenDatabase(resultData));
 }
 
 void WebIDBConnectionToClient::didAbortTransaction(const WebCore::IDBResourceIdentifier& transactionIdentifier, const WebCore::IDBError& error)
 {
+    m_server.unregisterTransaction(transactionIdentifier);
     send(Messages::WebIDBConnectionToServer::DidAbortTransaction(transactionIdentifier, error));
 }
 
 void WebIDBConnectionToClient::didCommitTransaction(const WebCore::IDBResourceIdentifier& transactionIdentifier, const WebCore::IDBError& error)
 {
+    m_server.unregisterTransaction(transactionIdentifier);
     send(Messages::WebIDBConnectionToServer::DidCommitTransaction(transactionIdentifier, error));
 }
 
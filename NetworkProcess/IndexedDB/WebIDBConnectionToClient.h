@@ -46,7 +46,7 @@ class WebIDBServer;
 class WebIDBConnectionToClient final : public WebCore::IDBServer::IDBConnectionToClientDelegate, public IPC::MessageSender {
     WTF_MAKE_FAST_ALLOCATED;
 public:
-    WebIDBConnectionToClient(IPC::Connection&, WebCore::IDBConnectionIdentifier);
+    WebIDBConnectionToClient(IPC::Connection&, WebCore::IDBConnectionIdentifier, WebIDBServer&, unsigned shardIndex);
 
     virtual ~WebIDBConnectionToClient();
 
@@ -89,6 +89,10 @@ private:
     Ref<IPC::Connection> m_connection;
     WebCore::IDBConnectionIdentifier m_identifier;
     Ref<WebCore::IDBServer::IDBConnectionToClient> m_connectionToClient;
+
+    // The server, used to route later requests for the connections and transactions created on this shard.
+    WebIDBServer& m_server;
+    unsigned m_shardIndex;
 };
 
 } // namespace WebKit
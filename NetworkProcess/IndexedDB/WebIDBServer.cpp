@@ -30,12 +30,30 @@
 #include "WebIDBServerMessages.h"
 #include <WebCore/SQLiteDatabaseTracker.h>
 #include <WebCore/StorageQuotaManager.h>
+#include <wtf/CrossThreadCopier.h>
 #include <wtf/threads/BinarySemaphore.h>
 
 #if ENABLE(INDEXED_DATABASE)
 
 namespace WebKit {
 
+static const unsigned maximumShardCount = 4;
+
+// Calls the callback on the main thread once every shard task holding a reference is done.
+struct CallbackAggregator final : public ThreadSafeRefCounted<CallbackAggregator> {
+    explicit CallbackAggregator(CompletionHandler<void()>&& callback)
+        : callback(WTFMove(callback))
+    {
+    }
+
+    ~CallbackAggregator()
+    {
+        callOnMainRunLoop(WTFMove(callback));
+    }
+
+    CompletionHandler<void()> callback;
+};
+
 Ref<WebIDBServer> WebIDBServer::create(PAL::SessionID sessionID, const String& directory, WebCore::IDBServer::IDBServer::StorageQuotaManagerSpaceRequester&& spaceRequester)
 {
     return adoptRef(*new WebIDBServer(sessionID, directory, WTFMove(spaceRequester)));
@@ -43,15 +61,14 @@ Ref<WebIDBServer> WebIDBServer::create(PAL::SessionID sessionID, const String& d
 
 WebIDBServer::WebIDBServer(PAL::SessionID sessionID, const String& directory, WebCore::IDBServer::IDBServer::StorageQuotaManagerSpaceRequester&& spaceRequester)
     : CrossThreadTaskHandler("com.apple.WebKit.IndexedDBServer", WTF::CrossThreadTaskHandler::AutodrainedPoolForRunLoop::Use)
+    , m_sessionID(sessionID)
+    , m_directory(directory.isolatedCopy())
+    , m_spaceRequester(WTFMove(spaceRequester))
 {
     ASSERT(RunLoop::isMain());
 
-    BinarySemaphore semaphore;
-    postTask([this, protectedThis = makeRef(*this), &semaphore, sessionID, directory = directory.isolatedCopy(), spaceRequester = WTFMove(spaceRequester)] () mutable {
-        m_server = makeUnique<WebCore::IDBServer::IDBServer>(sessionID, directory, WTFMove(spaceRequester));
-        semaphore.signal();
-    });
-    semaphore.wait();
+    // Shards are created on the WebIDBServer thread when first used.
+    m_shards.grow(std::max(1u, std::min<unsigned>(WTF::numberOfProcessorCores(), maximumShardCount)));
 }
 
 WebIDBServer::~WebIDBServer()
@@ -63,13 +80,28 @@ void WebIDBServer::getOrigins(CompletionHandler<void(HashSet<WebCore::SecurityOr
 {
     ASSERT(RunLoop::isMain());
 
-    postTask([this, protectedThis = makeRef(*this), callback = WTFMove(callback)]() mutable {
-        ASSERT(!RunLoop::isMain());
+    struct OriginsAggregator final : public ThreadSafeRefCounted<OriginsAggregator> {
+        Lock lock;
+        HashSet<WebCore::SecurityOriginData> origins;
+    };
+    auto aggregator = adoptRef(*new OriginsAggregator);
 
-        LockHolder locker(m_server->lock());
-        postTaskReply(CrossThreadTask([callback = WTFMove(callback), origins = crossThreadCopy(m_server->getOrigins())]() mutable {
-            callback(WTFMove(origins));
+    postTask([this, protectedThis = makeRef(*this), aggregator = WTFMove(aggregator), callback = WTFMove(callback)]() mutable {
+        // Databases on disk are seen by every shard, but only the shard that opened an in-memory database knows about it.
+        auto callbackAggregator = adoptRef(*new CallbackAggregator([aggregator = aggregator.copyRef(), callback = WTFMove(callback)]() mutable {
+            callback(WTFMove(aggregator->origins));
         }));
+        ensureShard(0);
+        for (unsigned shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex) {
+            if (!m_shards[shardIndex])
+                continue;
+            dispatchToShard(shardIndex, [aggregator = aggregator.copyRef(), callbackAggregator = callbackAggregator.copyRef()](auto& shard) {
+                auto origins = shard.server->getOrigins();
+                LockHolder locker(aggregator->lock);
+                for (auto& origin : origins)
+                    aggregator->origins.add(crossThreadCopy(origin));
+            });
+        }
     });
 }
 
@@ -78,13 +110,10 @@ void WebIDBServer::closeAndDeleteDatabasesModifiedSince(WallTime modificationTim
     ASSERT(RunLoop::isMain());
 
     postTask([this, protectedThis = makeRef(*this), modificationTime, callback = WTFMove(callback)]() mutable {
-        ASSERT(!RunLoop::isMain());
-
-        LockHolder locker(m_server->lock());
-        m_server->closeAndDeleteDatabasesModifiedSince(modificationTime);
-        postTaskReply(CrossThreadTask([callback = WTFMove(callback)]() mutable {
-            callback();
-        }));
+        performWithAllShardsStopped([modificationTime](auto& server) {
+            server.closeAndDeleteDatabasesModifiedSince(modificationTime);
+        });
+        postTaskReply(CrossThreadTask(WTFMove(callback)));
     });
 }
 
@@ -92,14 +121,12 @@ void WebIDBServer::closeAndDeleteDatabasesForOrigins(const Vector<WebCore::Secur
 {
     ASSERT(RunLoop::isMain());
 
-    postTask([this, protectedThis = makeRef(*this), originDatas = originDatas.isolatedCopy(), callback = WTFMove(callback)] () mutable {
-        ASSERT(!RunLoop::isMain());
-
-        LockHolder locker(m_server->lock());
-        m_server->closeAndDeleteDatabasesForOrigins(originDatas);
-        postTaskReply(CrossThreadTask([callback = WTFMove(callback)]() mutable {
-            callback();
-        }));
+    // Third-party databases live in the shard of their top origin, so every shard may have some open.
+    postTask([this, protectedThis = makeRef(*this), originDatas = originDatas.isolatedCopy(), callback = WTFMove(callback)]() mutable {
+        performWithAllShardsStopped([&originDatas](auto& server) {
+            server.closeAndDeleteDatabasesForOrigins(originDatas);
+        });
+        postTaskReply(CrossThreadTask(WTFMove(callback)));
     });
 }
 
@@ -107,11 +134,10 @@ void WebIDBServer::renameOrigin(const WebCore::SecurityOriginData& oldOrigin, co
 {
     ASSERT(RunLoop::isMain());
 
-    postTask([this, protectedThis = makeRef(*this), oldOrigin = oldOrigin.isolatedCopy(), newOrigin = newOrigin.isolatedCopy(), callback = WTFMove(callback)] () mutable {
-        ASSERT(!RunLoop::isMain());
-
-        LockHolder locker(m_server->lock());
-        m_server->renameOrigin(oldOrigin, newOrigin);
+    postTask([this, protectedThis = makeRef(*this), oldOrigin = oldOrigin.isolatedCopy(), newOrigin = newOrigin.isolatedCopy(), callback = WTFMove(callback)]() mutable {
+        performWithAllShardsStopped([&oldOrigin, &newOrigin](auto& server) {
+            server.renameOrigin(oldOrigin, newOrigin);
+        });
         postTaskReply(CrossThreadTask(WTFMove(callback)));
     });
 }
@@ -123,9 +149,17 @@ void WebIDBServer::suspend()
     if (m_isSuspended)
         return;
 
-    m_isSuspended = true;
-    m_server->lock().lock();
-    m_server->stopDatabaseActivitiesOnMainThread();
+    Vector<Shard*> shards;
+    {
+        // Shards created from now on start suspended.
+        LockHolder locker(m_shardsLock);
+        m_isSuspended = true;
+        shards = createdShards();
+    }
+    for (auto* shard : shards) {
+        shard->server->lock().lock();
+        shard->server->stopDatabaseActivitiesOnMainThread();
+    }
 }
 
 void WebIDBServer::resume()
@@ -135,236 +169,277 @@ void WebIDBServer::resume()
     if (!m_isSuspended)
         return;
 
-    m_isSuspended = false;
-    m_server->lock().unlock();
+    Vector<Shard*> shards;
+    {
+        LockHolder locker(m_shardsLock);
+        m_isSuspended = false;
+        shards = createdShards();
+    }
+    for (auto* shard : shards)
+        shard->server->lock().unlock();
 }
 
 void WebIDBServer::openDatabase(const WebCore::IDBRequestData& requestData)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->openDatabase(requestData);
+    dispatchToShard(shardIndexForOrigin(requestData.databaseIdentifier().origin()), [requestData = requestData.isolatedCopy()](auto& shard) {
+        shard.server->openDatabase(requestData);
+    });
 }
 
 void WebIDBServer::deleteDatabase(const WebCore::IDBRequestData& requestData)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->deleteDatabase(requestData);
+    dispatchToShard(shardIndexForOrigin(requestData.databaseIdentifier().origin()), [requestData = requestData.isolatedCopy()](auto& shard) {
+        shard.server->deleteDatabase(requestData);
+    });
 }
 
 void WebIDBServer::abortTransaction(const WebCore::IDBResourceIdentifier& transactionIdentifier)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->abortTransaction(transactionIdentifier);
+    dispatchToTransactionShard(transactionIdentifier, [transactionIdentifier = transactionIdentifier.isolatedCopy()](auto& shard) {
+        shard.server->abortTransaction(transactionIdentifier);
+    });
 }
 
 void WebIDBServer::commitTransaction(const WebCore::IDBResourceIdentifier& transactionIdentifier)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->commitTransaction(transactionIdentifier);
+    dispatchToTransactionShard(transactionIdentifier, [transactionIdentifier = transactionIdentifier.isolatedCopy()](auto& shard) {
+        shard.server->commitTransaction(transactionIdentifier);
+    });
 }
 
 void WebIDBServer::didFinishHandlingVersionChangeTransaction(uint64_t databaseConnectionIdentifier, const WebCore::IDBResourceIdentifier& transactionIdentifier)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->didFinishHandlingVersionChangeTransaction(databaseConnectionIdentifier, transactionIdentifier);
+    dispatchToDatabaseConnectionShard(databaseConnectionIdentifier, [databaseConnectionIdentifier, transactionIdentifier = transactionIdentifier.isolatedCopy()](auto& shard) {
+        shard.server->didFinishHandlingVersionChangeTransaction(databaseConnectionIdentifier, transactionIdentifier);
+    });
 }
 
 void WebIDBServer::createObjectStore(const WebCore::IDBRequestData& requestData, const WebCore::IDBObjectStoreInfo& objectStoreInfo)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->createObjectStore(requestData, objectStoreInfo);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), objectStoreInfo = objectStoreInfo.isolatedCopy()](auto& shard) {
+        shard.server->createObjectStore(requestData, objectStoreInfo);
+    });
 }
 
 void WebIDBServer::deleteObjectStore(const WebCore::IDBRequestData& requestData, const String& objectStoreName)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->deleteObjectStore(requestData, objectStoreName);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), objectStoreName = objectStoreName.isolatedCopy()](auto& shard) {
+        shard.server->deleteObjectStore(requestData, objectStoreName);
+    });
 }
 
 void WebIDBServer::renameObjectStore(const WebCore::IDBRequestData& requestData, uint64_t objectStoreIdentifier, const String& newName)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->renameObjectStore(requestData, objectStoreIdentifier, newName);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), objectStoreIdentifier, newName = newName.isolatedCopy()](auto& shard) {
+        shard.server->renameObjectStore(requestData, objectStoreIdentifier, newName);
+    });
 }
 
 void WebIDBServer::clearObjectStore(const WebCore::IDBRequestData& requestData, uint64_t objectStoreIdentifier)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->clearObjectStore(requestData, objectStoreIdentifier);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), objectStoreIdentifier](auto& shard) {
+        shard.server->clearObjectStore(requestData, objectStoreIdentifier);
+    });
 }
 
 void WebIDBServer::createIndex(const WebCore::IDBRequestData& requestData, const WebCore::IDBIndexInfo& indexInfo)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->createIndex(requestData, indexInfo);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), indexInfo = indexInfo.isolatedCopy()](auto& shard) {
+        shard.server->createIndex(requestData, indexInfo);
+    });
 }
 
 void WebIDBServer::deleteIndex(const WebCore::IDBRequestData& requestData, uint64_t objectStoreIdentifier, const String& indexName)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->deleteIndex(requestData, objectStoreIdentifier, indexName);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), objectStoreIdentifier, indexName = indexName.isolatedCopy()](auto& shard) {
+        shard.server->deleteIndex(requestData, objectStoreIdentifier, indexName);
+    });
 }
 
 void WebIDBServer::renameIndex(const WebCore::IDBRequestData& requestData, uint64_t objectStoreIdentifier, uint64_t indexIdentifier, const String& newName)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->renameIndex(requestData, objectStoreIdentifier, indexIdentifier, newName);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), objectStoreIdentifier, indexIdentifier, newName = newName.isolatedCopy()](auto& shard) {
+        shard.server->renameIndex(requestData, objectStoreIdentifier, indexIdentifier, newName);
+    });
 }
 
 void WebIDBServer::putOrAdd(const WebCore::IDBRequestData& requestData, const WebCore::IDBKeyData& keyData, const WebCore::IDBValue& value, WebCore::IndexedDB::ObjectStoreOverwriteMode overWriteMode)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->putOrAdd(requestData, keyData, value, overWriteMode);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), keyData = keyData.isolatedCopy(), value = value.isolatedCopy(), overWriteMode](auto& shard) {
+        shard.server->putOrAdd(requestData, keyData, value, overWriteMode);
+    });
 }
 
 void WebIDBServer::getRecord(const WebCore::IDBRequestData& requestData, const WebCore::IDBGetRecordData& getRecordData)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->getRecord(requestData, getRecordData);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), getRecordData = getRecordData.isolatedCopy()](auto& shard) {
+        shard.server->getRecord(requestData, getRecordData);
+    });
 }
 
 void WebIDBServer::getAllRecords(const WebCore::IDBRequestData& requestData, const WebCore::IDBGetAllRecordsData& getAllRecordsData)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->getAllRecords(requestData, getAllRecordsData);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), getAllRecordsData = getAllRecordsData.isolatedCopy()](auto& shard) {
+        shard.server->getAllRecords(requestData, getAllRecordsData);
+    });
 }
 
 void WebIDBServer::getCount(const WebCore::IDBRequestData& requestData, const WebCore::IDBKeyRangeData& keyRangeData)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->getCount(requestData, keyRangeData);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), keyRangeData = keyRangeData.isolatedCopy()](auto& shard) {
+        shard.server->getCount(requestData, keyRangeData);
+    });
 }
 
 void WebIDBServer::deleteRecord(const WebCore::IDBRequestData& requestData, const WebCore::IDBKeyRangeData& keyRangeData)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->deleteRecord(requestData, keyRangeData);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), keyRangeData = keyRangeData.isolatedCopy()](auto& shard) {
+        shard.server->deleteRecord(requestData, keyRangeData);
+    });
 }
 
 void WebIDBServer::openCursor(const WebCore::IDBRequestData& requestData, const WebCore::IDBCursorInfo& cursorInfo)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->openCursor(requestData, cursorInfo);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), cursorInfo = cursorInfo.isolatedCopy()](auto& shard) {
+        shard.server->openCursor(requestData, cursorInfo);
+    });
 }
 
 void WebIDBServer::iterateCursor(const WebCore::IDBRequestData& requestData, const WebCore::IDBIterateCursorData& iterateCursorData)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->iterateCursor(requestData, iterateCursorData);
+    dispatchToTransactionShard(requestData.transactionIdentifier(), [requestData = requestData.isolatedCopy(), iterateCursorData = iterateCursorData.isolatedCopy()](auto& shard) {
+        shard.server->iterateCursor(requestData, iterateCursorData);
+    });
 }
 
 void WebIDBServer::establishTransaction(uint64_t databaseConnectionIdentifier, const WebCore::IDBTransactionInfo& transactionInfo)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->establishTransaction(databaseConnectionIdentifier, transactionInfo);
+    Optional<unsigned> shardIndex;
+    {
+        LockHolder locker(m_routingLock);
+        auto iterator = m_databaseConnectionShards.find(databaseConnectionIdentifier);
+        if (iterator == m_databaseConnectionShards.end())
+            return;
+        shardIndex = iterator->value.first;
+        m_transactionShards.set(transactionInfo.identifier(), *shardIndex);
+    }
+
+    dispatchToShard(*shardIndex, [databaseConnectionIdentifier, transactionInfo = transactionInfo.isolatedCopy()](auto& shard) {
+        shard.server->establishTransaction(databaseConnectionIdentifier, transactionInfo);
+    });
 }
 
 void WebIDBServer::databaseConnectionPendingClose(uint64_t databaseConnectionIdentifier)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->databaseConnectionPendingClose(databaseConnectionIdentifier);
+    dispatchToDatabaseConnectionShard(databaseConnectionIdentifier, [databaseConnectionIdentifier](auto& shard) {
+        shard.server->databaseConnectionPendingClose(databaseConnectionIdentifier);
+    });
 }
 
 void WebIDBServer::databaseConnectionClosed(uint64_t databaseConnectionIdentifier)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->databaseConnectionClosed(databaseConnectionIdentifier);
+    dispatchToDatabaseConnectionShard(databaseConnectionIdentifier, [databaseConnectionIdentifier](auto& shard) {
+        shard.server->databaseConnectionClosed(databaseConnectionIdentifier);
+    });
+    unregisterDatabaseConnection(databaseConnectionIdentifier);
 }
 
 void WebIDBServer::abortOpenAndUpgradeNeeded(uint64_t databaseConnectionIdentifier, const WebCore::IDBResourceIdentifier& transactionIdentifier)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->abortOpenAndUpgradeNeeded(databaseConnectionIdentifier, transactionIdentifier);
+    dispatchToDatabaseConnectionShard(databaseConnectionIdentifier, [databaseConnectionIdentifier, transactionIdentifier = transactionIdentifier.isolatedCopy()](auto& shard) {
+        shard.server->abortOpenAndUpgradeNeeded(databaseConnectionIdentifier, transactionIdentifier);
+    });
 }
 
 void WebIDBServer::didFireVersionChangeEvent(uint64_t databaseConnectionIdentifier, const WebCore::IDBResourceIdentifier& requestIdentifier, WebCore::IndexedDB::ConnectionClosedOnBehalfOfServer connectionClosed)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->didFireVersionChangeEvent(databaseConnectionIdentifier, requestIdentifier, connectionClosed);
+    dispatchToDatabaseConnectionShard(databaseConnectionIdentifier, [databaseConnectionIdentifier, requestIdentifier = requestIdentifier.isolatedCopy(), connectionClosed](auto& shard) {
+        shard.server->didFireVersionChangeEvent(databaseConnectionIdentifier, requestIdentifier, connectionClosed);
+    });
 }
 
 void WebIDBServer::openDBRequestCancelled(const WebCore::IDBRequestData& requestData)
 {
     ASSERT(!RunLoop::isMain());
 
-    LockHolder locker(m_server->lock());
-    m_server->openDBRequestCancelled(requestData);
+    dispatchToShard(shardIndexForOrigin(requestData.databaseIdentifier().origin()), [requestData = requestData.isolatedCopy()](auto& shard) {
+        shard.server->openDBRequestCancelled(requestData);
+    });
 }
 
 void WebIDBServer::getAllDatabaseNamesAndVersions(IPC::Connection& connection, const WebCore::IDBResourceIdentifier& requestIdentifier, const WebCore::ClientOrigin& origin)
 {
     ASSERT(!RunLoop::isMain());
 
-    auto* webIDBConnection = m_connectionMap.get(connection.uniqueID());
-    ASSERT(webIDBConnection);
+    dispatchToShard(shardIndexForOrigin(origin), [connectionID = connection.uniqueID(), requestIdentifier = requestIdentifier.isolatedCopy(), origin = origin.isolatedCopy()](auto& shard) {
+        auto* webIDBConnection = shard.connectionMap.get(connectionID);
+        ASSERT(webIDBConnection);
 
-    LockHolder locker(m_server->lock());
-    m_server->getAllDatabaseNamesAndVersions(webIDBConnection->identifier(), requestIdentifier, origin);
+        shard.server->getAllDatabaseNamesAndVersions(webIDBConnection->identifier(), requestIdentifier, origin);
+    });
 }
 
 void WebIDBServer::addConnection(IPC::Connection& connection, WebCore::ProcessIdentifier processIdentifier)
 {
     ASSERT(RunLoop::isMain());
 
-    postTask([this, protectedThis = makeRef(*this), protectedConnection = makeRefPtr(connection), processIdentifier] {
-        auto[iter, isNewEntry] = m_connectionMap.ensure(protectedConnection->uniqueID(), [&] {
-            return makeUnique<WebIDBConnectionToClient>(*protectedConnection, processIdentifier);
-        });
-
-        ASSERT_UNUSED(isNewEntry, isNewEntry);
-
-        LockHolder locker(m_server->lock());
-        m_server->registerConnection(iter->value->connectionToClient());
+    postTask([this, protectedConnection = makeRefPtr(connection), processIdentifier]() mutable {
+        auto& connection = *protectedConnection;
+        m_shardConnections.add(connection.uniqueID(), std::make_pair(WTFMove(protectedConnection), processIdentifier));
+        for (unsigned shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex) {
+            if (m_shards[shardIndex])
+                registerConnection(shardIndex, connection, processIdentifier);
+        }
     });
-    m_connections.add(&connection);
+    m_connections.add(&connection, processIdentifier);
     connection.addThreadMessageReceiver(Messages::WebIDBServer::messageReceiverName(), this);
 }
 
@@ -372,16 +447,182 @@ void WebIDBServer::removeConnection(IPC::Connection& connection)
 {
     ASSERT(RunLoop::isMain());
 
-    m_connections.remove(&connection);
+    auto processIdentifier = m_connections.take(&connection);
     connection.removeThreadMessageReceiver(Messages::WebIDBServer::messageReceiverName());
-    postTask([this, protectedThis = makeRef(*this), connectionID = connection.uniqueID()] {
-        auto connection = m_connectionMap.take(connectionID);
 
-        ASSERT(connection);
+    // Go through the WebIDBServer thread, so that each shard gets the messages that thread already forwarded for
+    // this connection first. addConnection() registered the connection on every shard from that thread as well,
+    // and a shard only forgets its routes once it has run every task that can add them.
+    postTask([this, connectionID = connection.uniqueID(), processIdentifier] {
+        m_shardConnections.remove(connectionID);
+        for (unsigned shardIndex = 0; shardIndex < m_shards.size(); ++shardIndex) {
+            if (!m_shards[shardIndex])
+                continue;
+            dispatchToShard(shardIndex, [this, shardIndex, connectionID, processIdentifier](auto& shard) {
+                auto connection = shard.connectionMap.take(connectionID);
+
+                ASSERT(connection);
+
+                shard.server->unregisterConnection(connection->connectionToClient());
+                unregisterConnection(processIdentifier, shardIndex);
+            });
+        }
+    });
+}
 
-        LockHolder locker(m_server->lock());
-        m_server->unregisterConnection(connection->connectionToClient());
+void WebIDBServer::registerConnection(unsigned shardIndex, IPC::Connection& connection, WebCore::ProcessIdentifier processIdentifier)
+{
+    ASSERT(!RunLoop::isMain());
+
+    dispatchToShard(shardIndex, [this, shardIndex, protectedConnection = makeRefPtr(connection), processIdentifier](auto& shard) {
+        auto[iter, isNewEntry] = shard.connectionMap.ensure(protectedConnection->uniqueID(), [&] {
+            return makeUnique<WebIDBConnectionToClient>(*protectedConnection, processIdentifier, *this, shardIndex);
+        });
+
+        ASSERT_UNUSED(isNewEntry, isNewEntry);
+
+        shard.server->registerConnection(iter->value->connectionToClient());
+    });
+}
+
+void WebIDBServer::registerDatabaseConnection(uint64_t databaseConnectionIdentifier, WebCore::IDBConnectionIdentifier connectionIdentifier, unsigned shardIndex)
+{
+    LockHolder locker(m_routingLock);
+    m_databaseConnectionShards.set(databaseConnectionIdentifier, std::make_pair(shardIndex, connectionIdentifier));
+}
+
+void WebIDBServer::unregisterDatabaseConnection(uint64_t databaseConnectionIdentifier)
+{
+    LockHolder locker(m_routingLock);
+    m_databaseConnectionShards.remove(databaseConnectionIdentifier);
+}
+
+void WebIDBServer::registerTransaction(const WebCore::IDBResourceIdentifier& transactionIdentifier, unsigned shardIndex)
+{
+    LockHolder locker(m_routingLock);
+    m_transactionShards.set(transactionIdentifier.isolatedCopy(), shardIndex);
+}
+
+void WebIDBServer::unregisterTransaction(const WebCore::IDBResourceIdentifier& transactionIdentifier)
+{
+    LockHolder locker(m_routingLock);
+    m_transactionShards.remove(transactionIdentifier);
+}
+
+void WebIDBServer::unregisterConnection(WebCore::IDBConnectionIdentifier connectionIdentifier, unsigned shardIndex)
+{
+    // The server drops the connection's transactions and database connections without telling the client.
+    LockHolder locker(m_routingLock);
+    m_databaseConnectionShards.removeIf([&](auto& entry) {
+        return entry.value.first == shardIndex && entry.value.second == connectionIdentifier;
+    });
+    m_transactionShards.removeIf([&](auto& entry) {
+        return entry.value == shardIndex && entry.key.connectionIdentifier() == connectionIdentifier;
+    });
+}
+
+unsigned WebIDBServer::shardIndexForOrigin(const WebCore::ClientOrigin& origin) const
+{
+    return WebCore::SecurityOriginDataHash::hash(origin.topOrigin) % m_shards.size();
+}
+
+WebIDBServer::Shard& WebIDBServer::ensureShard(unsigned shardIndex)
+{
+    ASSERT(!RunLoop::isMain());
+
+    // Only this thread creates shards, so it can read m_shards without locking.
+    if (auto* shard = m_shards[shardIndex].get())
+        return *shard;
+
+    auto shard = makeUnique<Shard>(WorkQueue::create("com.apple.WebKit.IndexedDBServer.Shard"));
+    // The quota manager is per origin, and each origin belongs to a single shard.
+    shard->server = makeUnique<WebCore::IDBServer::IDBServer>(m_sessionID, m_directory, [this](const WebCore::ClientOrigin& origin, uint64_t spaceRequested) {
+        return m_spaceRequester(origin, spaceRequested);
     });
+
+    {
+        LockHolder locker(m_shardsLock);
+        if (m_isSuspended)
+            shard->server->lock().lock();
+        m_shards[shardIndex] = WTFMove(shard);
+    }
+
+    for (auto& connection : m_shardConnections.values())
+        registerConnection(shardIndex, *connection.first, connection.second);
+
+    return *m_shards[shardIndex];
+}
+
+Vector<WebIDBServer::Shard*> WebIDBServer::createdShards() const
+{
+    ASSERT(m_shardsLock.isHeld());
+
+    Vector<Shard*> shards;
+    for (auto& shard : m_shards) {
+        if (shard)
+            shards.append(shard.get());
+    }
+    return shards;
+}
+
+void WebIDBServer::dispatchToShard(unsigned shardIndex, Function<void(Shard&)>&& task)
+{
+    auto& shard = ensureShard(shardIndex);
+    shard.queue->dispatch([&shard, task = WTFMove(task)] {
+        LockHolder locker(shard.server->lock());
+        task(shard);
+    });
+}
+
+void WebIDBServer::performWithAllShardsStopped(const Function<void(WebCore::IDBServer::IDBServer&)>& task)
+{
+    ASSERT(!RunLoop::isMain());
+
+    // All the shards share the database directory, and removing or moving the files of a database that another shard
+    // has open would break it. Hold every shard, so that each one has closed the databases involved before any of
+    // them runs again. A server only needs its lock to be held, which is also how suspend() uses them.
+    ensureShard(0);
+    Vector<Shard*> shards;
+    {
+        LockHolder locker(m_shardsLock);
+        shards = createdShards();
+    }
+    for (auto* shard : shards)
+        shard->server->lock().lock();
+    for (auto* shard : shards)
+        task(*shard->server);
+    for (auto* shard : shards)
+        shard->server->lock().unlock();
+}
+
+void WebIDBServer::dispatchToTransactionShard(const WebCore::IDBResourceIdentifier& transactionIdentifier, Function<void(Shard&)>&& task)
+{
+    Optional<unsigned> shardIndex;
+    {
+        LockHolder locker(m_routingLock);
+        auto iterator = m_transactionShards.find(transactionIdentifier);
+        if (iterator != m_transactionShards.end())
+            shardIndex = iterator->value;
+    }
+
+    // Like IDBServer, ignore requests for transactions that no longer exist.
+    if (shardIndex)
+        dispatchToShard(*shardIndex, WTFMove(task));
+}
+
+void WebIDBServer::dispatchToDatabaseConnectionShard(uint64_t databaseConnectionIdentifier, Function<void(Shard&)>&& task)
+{
+    Optional<unsigned> shardIndex;
+    {
+        LockHolder locker(m_routingLock);
+        auto iterator = m_databaseConnectionShards.find(databaseConnectionIdentifier);
+        if (iterator != m_databaseConnectionShards.end())
+            shardIndex = iterator->value.first;
+    }
+
+    // Like IDBServer, ignore requests for database connections that no longer exist.
+    if (shardIndex)
+        dispatchToShard(*shardIndex, WTFMove(task));
 }
 
 void WebIDBServer::postTask(Function<void()>&& task)
@@ -401,7 +642,7 @@ void WebIDBServer::close()
     ASSERT(RunLoop::isMain());
 
     // Remove the references held by IPC::Connection.
-    for (auto* connection : m_connections)
+    for (auto* connection : m_connections.keys())
         connection->removeThreadMessageReceiver(Messages::WebIDBServer::messageReceiverName());
 
     CrossThreadTaskHandler::setCompletionCallback([protectedThis = makeRef(*this)]() mutable {
@@ -410,8 +651,23 @@ void WebIDBServer::close()
     });
 
     postTask([this]() mutable {
-        m_connectionMap.clear();
-        m_server = nullptr;
+        // Messages already forwarded to the shards are handled before their servers go away.
+        for (auto& shard : m_shards) {
+            if (!shard)
+                continue;
+            BinarySemaphore semaphore;
+            shard->queue->dispatch([shard = shard.get(), &semaphore] {
+                shard->connectionMap.clear();
+                shard->server = nullptr;
+                semaphore.signal();
+            });
+            semaphore.wait();
+        }
+        {
+            LockHolder locker(m_shardsLock);
+            m_shards.clear();
+        }
+        m_shardConnections.clear();
 
         CrossThreadTaskHandler::kill();
     });
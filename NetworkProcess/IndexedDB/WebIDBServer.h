@@ -33,6 +33,8 @@
 #include <WebCore/IDBServer.h>
 #include <WebCore/StorageQuotaManager.h>
 #include <wtf/CrossThreadTaskHandler.h>
+#include <wtf/Lock.h>
+#include <wtf/WorkQueue.h>
 
 namespace WebCore {
 class StorageQuotaManager;
@@ -43,6 +45,10 @@ class IDBServer;
 
 namespace WebKit {
 
+// Messages are decoded on the WebIDBServer thread and forwarded to one of a bounded set of shards, each an
+// IDBServer with its own serial queue, created on first use. Databases are sharded by top origin, so that a slow
+// origin only delays the origins sharing its shard. Transactions and database connections are routed to the shard
+// that created them. Operations on the database files as a whole run with every shard stopped.
 class WebIDBServer final : public CrossThreadTaskHandler, public IPC::Connection::ThreadMessageReceiverRefCounted {
 public:
     static Ref<WebIDBServer> create(PAL::SessionID, const String& directory, WebCore::IDBServer::IDBServer::StorageQuotaManagerSpaceRequester&&);
@@ -91,17 +97,55 @@ public:
     void close();
 
     bool hasConnection() const { return !m_connections.isEmpty(); }
+
+    // Called by WebIDBConnectionToClient, on the shard's queue, as the server creates and finishes them.
+    void registerDatabaseConnection(uint64_t databaseConnectionIdentifier, WebCore::IDBConnectionIdentifier, unsigned shardIndex);
+    void registerTransaction(const WebCore::IDBResourceIdentifier& transactionIdentifier, unsigned shardIndex);
+    void unregisterTransaction(const WebCore::IDBResourceIdentifier& transactionIdentifier);
+
 private:
     WebIDBServer(PAL::SessionID, const String& directory, WebCore::IDBServer::IDBServer::StorageQuotaManagerSpaceRequester&&);
     ~WebIDBServer();
 
-    void postTask(WTF::Function<void()>&&);
+    struct Shard {
+        WTF_MAKE_STRUCT_FAST_ALLOCATED;
+        explicit Shard(Ref<WorkQueue>&& queue)
+            : queue(WTFMove(queue))
+        {
+        }
 
-    std::unique_ptr<WebCore::IDBServer::IDBServer> m_server;
+        Ref<WorkQueue> queue;
+        std::unique_ptr<WebCore::IDBServer::IDBServer> server;
+        HashMap<IPC::Connection::UniqueID, std::unique_ptr<WebIDBConnectionToClient>> connectionMap;
+    };
+
+    void postTask(WTF::Function<void()>&&);
+    Shard& ensureShard(unsigned shardIndex);
+    Vector<Shard*> createdShards() const;
+    void registerConnection(unsigned shardIndex, IPC::Connection&, WebCore::ProcessIdentifier);
+    void dispatchToShard(unsigned shardIndex, WTF::Function<void(Shard&)>&&);
+    void performWithAllShardsStopped(const WTF::Function<void(WebCore::IDBServer::IDBServer&)>&);
+    void dispatchToTransactionShard(const WebCore::IDBResourceIdentifier& transactionIdentifier, WTF::Function<void(Shard&)>&&);
+    void dispatchToDatabaseConnectionShard(uint64_t databaseConnectionIdentifier, WTF::Function<void(Shard&)>&&);
+    unsigned shardIndexForOrigin(const WebCore::ClientOrigin&) const;
+    void unregisterDatabaseConnection(uint64_t databaseConnectionIdentifier);
+    void unregisterConnection(WebCore::IDBConnectionIdentifier, unsigned shardIndex);
+
+    PAL::SessionID m_sessionID;
+    String m_directory;
+    WebCore::IDBServer::IDBServer::StorageQuotaManagerSpaceRequester m_spaceRequester;
+
+    // Only the WebIDBServer thread creates shards; other threads read m_shards under m_shardsLock.
+    mutable Lock m_shardsLock;
+    Vector<std::unique_ptr<Shard>> m_shards;
     bool m_isSuspended { false };
+    HashMap<IPC::Connection::UniqueID, std::pair<RefPtr<IPC::Connection>, WebCore::ProcessIdentifier>> m_shardConnections;
+
+    Lock m_routingLock;
+    HashMap<uint64_t, std::pair<unsigned, WebCore::IDBConnectionIdentifier>> m_databaseConnectionShards;
+    HashMap<WebCore::IDBResourceIdentifier, unsigned> m_transactionShards;
 
-    HashMap<IPC::Connection::UniqueID, std::unique_ptr<WebIDBConnectionToClient>> m_connectionMap;
-    HashSet<IPC::Connection*> m_connections;
+    HashMap<IPC::Connection*, WebCore::ProcessIdentifier> m_connections;
 };
 
 } // namespace WebKit
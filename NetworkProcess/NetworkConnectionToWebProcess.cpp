@@ -467,6 +467,16 @@ void NetworkConnectionToWebProcess::scheduleResourceLoad(NetworkResourceLoadPara
 #endif
 }
 
+void NetworkConnectionToWebProcess::scheduleResourceLoads(NetworkResourceLoadParameters::Batch&& batch)
+{
+    // Start the most important loads first, keeping the web process order among loads of the same priority.
+    std::stable_sort(batch.loads.begin(), batch.loads.end(), [](auto& a, auto& b) {
+        return a.request.priority() > b.request.priority();
+    });
+    for (auto& loadParameters : batch.loads)
+        scheduleResourceLoad(WTFMove(loadParameters));
+}
+
 void NetworkConnectionToWebProcess::performSynchronousLoad(NetworkResourceLoadParameters&& loadParameters, Messages::NetworkConnectionToWebProcess::PerformSynchronousLoad::DelayedReply&& reply)
 {
     RELEASE_LOG_IF_ALLOWED(Loading, "performSynchronousLoad: (parentPID=%d, pageProxyID=%" PRIu64 ", webPageID=%" PRIu64 ", frameID=%" PRIu64 ", resourceID=%" PRIu64 ")", loadParameters.parentPID, loadParameters.webPageProxyID.toUInt64(), loadParameters.webPageID.toUInt64(), loadParameters.webFrameID.toUInt64(), loadParameters.identifier);
@@ -35,6 +35,8 @@
 namespace WebKit {
 using namespace WebCore;
 
+static const unsigned maximumDecisionCacheSizePerController = 512;
+
 NetworkContentRuleListManager::NetworkContentRuleListManager(NetworkProcess& networkProcess)
     : m_networkProcess(networkProcess)
 {
@@ -66,14 +68,47 @@ void NetworkContentRuleListManager::contentExtensionsBackend(UserContentControll
     m_networkProcess.parentProcessConnection()->send(Messages::NetworkProcessProxy::ContentExtensionRules { identifier }, 0);
 }
 
+void NetworkContentRuleListManager::processContentRuleListsForLoad(UserContentControllerIdentifier identifier, const URL& url, const URL& mainDocumentURL, ResultsCallback&& callback)
+{
+    contentExtensionsBackend(identifier, [this, identifier, url, mainDocumentURL, callback = WTFMove(callback)](auto& backend) mutable {
+        auto& decisionCache = m_decisionCaches.ensure(identifier, [] {
+            return DecisionCache { };
+        }).iterator->value;
+
+        // Unless a list matches the whole top URL, the rules only depend on the main document's host, so all the pages
+        // of a top origin share their decisions.
+        DecisionCache::Key key { url.string(), decisionCache.contentRuleListsMatchingTopURL.isEmpty() ? mainDocumentURL.protocolHostAndPort() : mainDocumentURL.string() };
+        auto iterator = decisionCache.results.find(key);
+        if (iterator != decisionCache.results.end()) {
+            callback(iterator->value);
+            return;
+        }
+
+        if (decisionCache.results.size() >= maximumDecisionCacheSizePerController)
+            decisionCache.results.remove(decisionCache.results.random());
+
+        auto results = backend.processContentRuleListsForPingLoad(url, mainDocumentURL);
+        callback(decisionCache.results.add(WTFMove(key), WTFMove(results)).iterator->value);
+    });
+}
+
 void NetworkContentRuleListManager::addContentRuleLists(UserContentControllerIdentifier identifier, Vector<std::pair<String, WebCompiledContentRuleListData>>&& contentRuleLists)
 {
     auto& backend = *m_contentExtensionBackends.ensure(identifier, [] {
         return makeUnique<WebCore::ContentExtensions::ContentExtensionsBackend>();
     }).iterator->value;
+    auto& decisionCache = m_decisionCaches.ensure(identifier, [] {
+        return DecisionCache { };
+    }).iterator->value;
+    decisionCache.results.clear();
 
     for (auto&& contentRuleList : contentRuleLists) {
         auto compiledContentRuleList = WebCompiledContentRuleList::create(WTFMove(contentRuleList.second));
+        const ContentExtensions::CompiledContentExtension& compiledContentExtension = compiledContentRuleList.get();
+        if (compiledContentExtension.topURLFiltersBytecodeLength() && !compiledContentExtension.conditionsApplyOnlyToDomain())
+            decisionCache.contentRuleListsMatchingTopURL.add(contentRuleList.first);
+        else
+            decisionCache.contentRuleListsMatchingTopURL.remove(contentRuleList.first);
         backend.addContentExtension(contentRuleList.first, WTFMove(compiledContentRuleList), ContentExtensions::ContentExtension::ShouldCompileCSS::No);
     }
 
@@ -89,6 +124,11 @@ void NetworkContentRuleListManager::removeContentRuleList(UserContentControllerI
     if (iterator == m_contentExtensionBackends.end())
         return;
 
+    auto decisionCache = m_decisionCaches.find(identifier);
+    if (decisionCache != m_decisionCaches.end()) {
+        decisionCache->value.results.clear();
+        decisionCache->value.contentRuleListsMatchingTopURL.remove(name);
+    }
     iterator->value->removeContentExtension(name);
 }
 
@@ -98,11 +138,13 @@ void NetworkContentRuleListManager::removeAllContentRuleLists(UserContentControl
     if (iterator == m_contentExtensionBackends.end())
         return;
 
+    m_decisionCaches.remove(identifier);
     iterator->value->removeAllContentExtensions();
 }
 
 void NetworkContentRuleListManager::remove(UserContentControllerIdentifier identifier)
 {
+    m_decisionCaches.remove(identifier);
     m_contentExtensionBackends.remove(identifier);
 }
 
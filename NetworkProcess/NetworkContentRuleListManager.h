@@ -30,6 +30,7 @@
 #include "UserContentControllerIdentifier.h"
 #include "WebCompiledContentRuleListData.h"
 #include <WebCore/ContentExtensionsBackend.h>
+#include <WebCore/ContentRuleListResults.h>
 
 namespace IPC {
 class Connection;
@@ -50,12 +51,26 @@ public:
     using BackendCallback = CompletionHandler<void(WebCore::ContentExtensions::ContentExtensionsBackend&)>;
     void contentExtensionsBackend(UserContentControllerIdentifier, BackendCallback&&);
 
+    // ContentExtensionsBackend::processContentRuleListsForPingLoad(), with repeated requests for the same URL from the
+    // same top origin answered from a bounded cache until the controller's rule lists change.
+    using ResultsCallback = CompletionHandler<void(const WebCore::ContentRuleListResults&)>;
+    void processContentRuleListsForLoad(UserContentControllerIdentifier, const URL&, const URL& mainDocumentURL, ResultsCallback&&);
+
 private:
     void addContentRuleLists(UserContentControllerIdentifier, Vector<std::pair<String, WebCompiledContentRuleListData>>&&);
     void removeContentRuleList(UserContentControllerIdentifier, const String& name);
     void removeAllContentRuleLists(UserContentControllerIdentifier);
     void remove(UserContentControllerIdentifier);
 
+    struct DecisionCache {
+        // Keyed by the request URL and the top origin, or the full main document URL while one of the rule lists
+        // has top URL conditions that do not only apply to the domain.
+        using Key = std::pair<String, String>;
+        HashMap<Key, WebCore::ContentRuleListResults> results;
+        HashSet<String> contentRuleListsMatchingTopURL;
+    };
+    HashMap<UserContentControllerIdentifier, DecisionCache> m_decisionCaches;
+
     HashMap<UserContentControllerIdentifier, std::unique_ptr<WebCore::ContentExtensions::ContentExtensionsBackend>> m_contentExtensionBackends;
     HashMap<UserContentControllerIdentifier, Vector<BackendCallback>> m_pendingCallbacks;
     NetworkProcess& m_networkProcess;
@@ -87,6 +87,18 @@ NetworkDataTask::NetworkDataTask(NetworkSession& session, NetworkDataTaskClient&
     }
 }
 
+NetworkDataTask::NetworkDataTask(NetworkSession& session, DownloadID downloadID, const ResourceRequest& request, StoredCredentialsPolicy storedCredentialsPolicy)
+    : m_session(makeWeakPtr(session))
+    , m_pendingDownloadID(downloadID)
+    , m_partition(request.cachePartition())
+    , m_storedCredentialsPolicy(storedCredentialsPolicy)
+    , m_lastHTTPMethod(request.httpMethod())
+    , m_firstRequest(request)
+{
+    ASSERT(RunLoop::isMain());
+    ASSERT(m_pendingDownloadID);
+}
+
 NetworkDataTask::~NetworkDataTask()
 {
     ASSERT(RunLoop::isMain());
@@ -137,6 +149,12 @@ void NetworkDataTask::didReceiveResponse(ResourceResponse&& response, Negotiated
         completionHandler(PolicyAction::Ignore);
 }
 
+void NetworkDataTask::cancelByProducingResumeData(CompletionHandler<void(const IPC::DataReference&)>&& completionHandler)
+{
+    cancel();
+    completionHandler({ });
+}
+
 bool NetworkDataTask::shouldCaptureExtraNetworkLoadMetrics() const
 {
     return m_client ? m_client->shouldCaptureExtraNetworkLoadMetrics() : false;
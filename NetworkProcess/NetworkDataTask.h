@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "DataReference.h"
 #include "DownloadID.h"
 #include "SandboxExtension.h"
 #include <WebCore/Credential.h>
@@ -91,6 +92,7 @@ public:
     virtual void cancel() = 0;
     virtual void resume() = 0;
     virtual void invalidateAndCancel() = 0;
+    virtual void cancelByProducingResumeData(CompletionHandler<void(const IPC::DataReference&)>&&);
 
     void didReceiveResponse(WebCore::ResourceResponse&&, NegotiatedLegacyTLS, ResponseCompletionHandler&&);
     bool shouldCaptureExtraNetworkLoadMetrics() const;
@@ -122,6 +124,8 @@ public:
 
     virtual void setPendingDownloadLocation(const String& filename, SandboxExtension::Handle&&, bool /*allowOverwrite*/) { m_pendingDownloadLocation = filename; }
     const String& pendingDownloadLocation() const { return m_pendingDownloadLocation; }
+    void setPendingDownloadProducesResumeDataOnFailure(ProduceResumeData produceResumeData) { m_pendingDownloadProducesResumeDataOnFailure = produceResumeData; }
+    ProduceResumeData pendingDownloadProducesResumeDataOnFailure() const { return m_pendingDownloadProducesResumeDataOnFailure; }
     bool isDownload() const { return !!m_pendingDownloadID; }
 
     const WebCore::ResourceRequest& firstRequest() const { return m_firstRequest; }
@@ -140,6 +144,8 @@ public:
 
 protected:
     NetworkDataTask(NetworkSession&, NetworkDataTaskClient&, const WebCore::ResourceRequest&, WebCore::StoredCredentialsPolicy, bool shouldClearReferrerOnHTTPSToHTTPRedirect, bool dataTaskIsForMainFrameNavigation);
+    // Used by tasks that resume a download, which report to the download directly and have no client.
+    NetworkDataTask(NetworkSession&, DownloadID, const WebCore::ResourceRequest&, WebCore::StoredCredentialsPolicy);
 
     enum FailureType {
         BlockedFailure,
@@ -164,6 +170,7 @@ protected:
     WebCore::StoredCredentialsPolicy m_storedCredentialsPolicy { WebCore::StoredCredentialsPolicy::DoNotUse };
     String m_lastHTTPMethod;
     String m_pendingDownloadLocation;
+    ProduceResumeData m_pendingDownloadProducesResumeDataOnFailure { ProduceResumeData::Yes };
     WebCore::ResourceRequest m_firstRequest;
     bool m_shouldClearReferrerOnHTTPSToHTTPRedirect { true };
     String m_suggestedFilename;
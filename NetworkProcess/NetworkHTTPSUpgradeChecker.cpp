@@ -27,111 +27,129 @@
 #include "NetworkHTTPSUpgradeChecker.h"
 
 #include "Logging.h"
-#include <WebCore/SQLiteDatabase.h>
-#include <WebCore/SQLiteStatement.h>
 #include <pal/SessionID.h>
-#include <wtf/CompletionHandler.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/RunLoop.h>
+#include <wtf/text/StringView.h>
 
 #undef RELEASE_LOG_IF_ALLOWED
-#undef RELEASE_LOG_ERROR_IF_ALLOWED
 #define RELEASE_LOG_IF_ALLOWED(sessionID, fmt, ...) RELEASE_LOG_IF(sessionID.isAlwaysOnLoggingAllowed(), Network, "%p - NetworkHTTPSUpgradeChecker::" fmt, this, ##__VA_ARGS__)
-#define RELEASE_LOG_ERROR_IF_ALLOWED(sessionID, fmt, ...) RELEASE_LOG_ERROR_IF(sessionID.isAlwaysOnLoggingAllowed(), Network, "%p - NetworkHTTPSUpgradeChecker::" fmt, this, ##__VA_ARGS__)
 
 namespace WebKit {
 
-constexpr auto httpsUpgradeCheckerQuery = "SELECT host FROM hosts WHERE host = ?"_s;
+// Must match the layout written by generate-https-upgrade-database.sh.
+constexpr char upgradeListMagic[] = { 'W', 'K', 'H', 'U' };
+constexpr uint32_t upgradeListVersion = 2;
+constexpr size_t upgradeListHeaderSize = sizeof(upgradeListMagic) + sizeof(uint32_t) + sizeof(uint64_t);
 
-static const String& networkHTTPSUpgradeCheckerDatabasePath()
+static const String& networkHTTPSUpgradeCheckerListPath()
 {
-    static NeverDestroyed<String> networkHTTPSUpgradeCheckerDatabasePath;
+    static NeverDestroyed<String> networkHTTPSUpgradeCheckerListPath;
 #if PLATFORM(COCOA)
-    if (networkHTTPSUpgradeCheckerDatabasePath.get().isNull()) {
+    if (networkHTTPSUpgradeCheckerListPath.get().isNull()) {
         CFBundleRef webKitBundle = CFBundleGetBundleWithIdentifier(CFSTR("com.apple.WebKit"));
-        auto resourceURL = adoptCF(CFBundleCopyResourceURL(webKitBundle, CFSTR("HTTPSUpgradeList"), CFSTR("db"), nullptr));
-        if (resourceURL)
-            networkHTTPSUpgradeCheckerDatabasePath.get() = CFURLGetString(resourceURL.get());
+        auto resourceURL = adoptCF(CFBundleCopyResourceURL(webKitBundle, CFSTR("HTTPSUpgradeList"), CFSTR("dat"), nullptr));
+        if (resourceURL) {
+            auto path = adoptCF(CFURLCopyFileSystemPath(resourceURL.get(), kCFURLPOSIXPathStyle));
+            networkHTTPSUpgradeCheckerListPath.get() = path.get();
+        }
     }
 #endif // PLATFORM(COCOA)
-    return networkHTTPSUpgradeCheckerDatabasePath;
+    return networkHTTPSUpgradeCheckerListPath;
 }
 
-NetworkHTTPSUpgradeChecker::NetworkHTTPSUpgradeChecker()
-    : m_workQueue(WorkQueue::create("HTTPS Upgrade Checker Thread"))
+template<typename T>
+static T readLittleEndian(const uint8_t* data)
 {
-    ASSERT(RunLoop::isMain());
-
-    m_workQueue->dispatch([this] {
-        auto path = networkHTTPSUpgradeCheckerDatabasePath();
-        if (path.isEmpty()) {
-            RELEASE_LOG_ERROR(Network, "%p - NetworkHTTPSUpgradeChecker failed to initialize because the database path is empty", this);
-            return;
-        }
-
-        m_database = makeUnique<WebCore::SQLiteDatabase>();
-        bool isDatabaseOpen = m_database->open(path, WebCore::SQLiteDatabase::OpenMode::ReadOnly);
-        if (!isDatabaseOpen) {
-#if PLATFORM(COCOA)
-            RELEASE_LOG_ERROR(Network, "%p - NetworkHTTPSUpgradeChecker::open failed, error message: %{public}s, database path: %{public}s", this, m_database->lastErrorMsg(), path.utf8().data());
+    T value;
+    memcpy(&value, data, sizeof(value));
+#if CPU(BIG_ENDIAN)
+    if constexpr (sizeof(T) == sizeof(uint64_t))
+        value = __builtin_bswap64(value);
+    else
+        value = __builtin_bswap32(value);
 #endif
-            ASSERT_NOT_REACHED();
-            return;
-        }
-
-        // Since we are using a workerQueue, the sequential dispatch blocks may be called by different threads.
-        m_database->disableThreadingChecks();
-
-        m_statement = makeUnique<WebCore::SQLiteStatement>(*m_database, httpsUpgradeCheckerQuery);
-        int isStatementPrepared = (m_statement->prepare() == SQLITE_OK);
-        ASSERT(isStatementPrepared);
-        if (!isStatementPrepared)
-            return;
-
-        m_didSetupCompleteSuccessfully = true;
-    });
+    return value;
 }
 
-NetworkHTTPSUpgradeChecker::~NetworkHTTPSUpgradeChecker()
+// 64-bit FNV-1a, the fingerprint function of generate-https-upgrade-database.sh.
+static Optional<uint64_t> hostFingerprint(StringView host)
 {
-    if (m_database)
-        m_workQueue->dispatch([database = WTFMove(m_database), statement = WTFMove(m_statement)] { });
+    uint64_t value = 0xcbf29ce484222325;
+    for (auto character : host.codeUnits()) {
+        // The list is IDNA encoded, so a host with non-ASCII characters can't be in it.
+        if (!isASCII(character))
+            return WTF::nullopt;
+        value = (value ^ character) * 0x100000001b3;
+    }
+    return value;
 }
 
-void NetworkHTTPSUpgradeChecker::query(String&& host, PAL::SessionID sessionID, CompletionHandler<void(bool)>&& callback)
+NetworkHTTPSUpgradeChecker::NetworkHTTPSUpgradeChecker()
 {
     ASSERT(RunLoop::isMain());
 
-    m_workQueue->dispatch([this, host = host.isolatedCopy(), sessionID, callback = WTFMove(callback)] () mutable {
-        ASSERT(m_didSetupCompleteSuccessfully);
+    auto path = networkHTTPSUpgradeCheckerListPath();
+    if (path.isEmpty()) {
+        RELEASE_LOG_ERROR(Network, "%p - NetworkHTTPSUpgradeChecker failed to initialize because the list path is empty", this);
+        return;
+    }
+
+    bool success;
+    m_mappedFile = FileSystem::MappedFileData(path, FileSystem::MappedFileMode::Private, success);
+    if (!success) {
+        RELEASE_LOG_ERROR(Network, "%p - NetworkHTTPSUpgradeChecker failed to map the list at %{public}s", this, path.utf8().data());
+        ASSERT_NOT_REACHED();
+        return;
+    }
 
-        int bindTextResult = m_statement->bindText(1, WTFMove(host));
-        ASSERT_UNUSED(bindTextResult, bindTextResult == SQLITE_OK);
+    auto* data = static_cast<const uint8_t*>(m_mappedFile.data());
+    size_t size = m_mappedFile.size();
+    if (size < upgradeListHeaderSize || memcmp(data, upgradeListMagic, sizeof(upgradeListMagic)) || readLittleEndian<uint32_t>(data + sizeof(upgradeListMagic)) != upgradeListVersion) {
+        RELEASE_LOG_ERROR(Network, "%p - NetworkHTTPSUpgradeChecker failed to initialize because the list has an unexpected format", this);
+        ASSERT_NOT_REACHED();
+        return;
+    }
 
-        int stepResult = m_statement->step();
-        if (stepResult != SQLITE_ROW && stepResult != SQLITE_DONE) {
-#if PLATFORM(COCOA)
-            RELEASE_LOG_ERROR_IF_ALLOWED(sessionID, "step failed with error code %d, error message: %{public}s, database path: %{public}s", stepResult, m_database->lastErrorMsg(), networkHTTPSUpgradeCheckerDatabasePath().utf8().data());
-#else
-            UNUSED_VARIABLE(sessionID);
-#endif
-            ASSERT_NOT_REACHED();
-            RunLoop::main().dispatch([callback = WTFMove(callback)] () mutable {
-                callback(false);
-            });
-            return;
-        }
+    uint64_t count = readLittleEndian<uint64_t>(data + sizeof(upgradeListMagic) + sizeof(uint32_t));
+    if (count > (size - upgradeListHeaderSize) / sizeof(uint64_t)) {
+        RELEASE_LOG_ERROR(Network, "%p - NetworkHTTPSUpgradeChecker failed to initialize because the list is truncated", this);
+        ASSERT_NOT_REACHED();
+        return;
+    }
 
-        int resetResult = m_statement->reset();
-        ASSERT_UNUSED(resetResult, resetResult == SQLITE_OK);
+    m_fingerprintCount = count;
+    m_fingerprints = data + upgradeListHeaderSize;
+}
+
+NetworkHTTPSUpgradeChecker::~NetworkHTTPSUpgradeChecker() = default;
 
-        bool foundHost = (stepResult == SQLITE_ROW);
-        RELEASE_LOG_IF_ALLOWED(sessionID, "query - Ran successfully. Result = %s", (foundHost ? "true" : "false"));
-        RunLoop::main().dispatch([foundHost, callback = WTFMove(callback)] () mutable {
-            callback(foundHost);
-        });
-    });
+bool NetworkHTTPSUpgradeChecker::query(StringView host, PAL::SessionID sessionID) const
+{
+    ASSERT(didSetupCompleteSuccessfully());
+
+    auto fingerprint = hostFingerprint(host);
+    if (!fingerprint)
+        return false;
+
+    size_t low = 0;
+    size_t high = m_fingerprintCount;
+    bool foundHost = false;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        uint64_t value = readLittleEndian<uint64_t>(m_fingerprints + middle * sizeof(uint64_t));
+        if (value == *fingerprint) {
+            foundHost = true;
+            break;
+        }
+        if (value < *fingerprint)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    RELEASE_LOG_IF_ALLOWED(sessionID, "query - Ran successfully. Result = %s", (foundHost ? "true" : "false"));
+    return foundHost;
 }
 
 } // namespace WebKit
-
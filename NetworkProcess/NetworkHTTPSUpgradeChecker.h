@@ -25,15 +25,8 @@
 
 #pragma once
 
-#include <atomic>
+#include <wtf/FileSystem.h>
 #include <wtf/Forward.h>
-#include <wtf/UniqueRef.h>
-#include <wtf/WorkQueue.h>
-
-namespace WebCore {
-class SQLiteDatabase;
-class SQLiteStatement;
-}
 
 namespace PAL {
 class SessionID;
@@ -41,24 +34,23 @@ class SessionID;
 
 namespace WebKit {
 
+// Looks up hosts in the fingerprint set generated from HTTPSUpgradeList.txt by generate-https-upgrade-database.sh.
+// The set is memory-mapped and probed with a binary search, so lookups are synchronous and safe from any thread.
 class NetworkHTTPSUpgradeChecker {
     WTF_MAKE_FAST_ALLOCATED;
 public:
     NetworkHTTPSUpgradeChecker();
     ~NetworkHTTPSUpgradeChecker();
 
-    // Returns `true` after internal setup is successfully completed. If there is an error with setup, or if setup is in-progress, it will return `false`.
-    bool didSetupCompleteSuccessfully() const { return m_didSetupCompleteSuccessfully; };
+    // Returns `true` if the upgrade list was successfully mapped.
+    bool didSetupCompleteSuccessfully() const { return !!m_fingerprints; };
 
-    // Queries database after setup is complete.
-    void query(String&&, PAL::SessionID, CompletionHandler<void(bool)>&&);
+    bool query(StringView host, PAL::SessionID) const;
 
 private:
-    Ref<WorkQueue> m_workQueue;
-    std::unique_ptr<WebCore::SQLiteDatabase> m_database;
-    std::unique_ptr<WebCore::SQLiteStatement> m_statement;
-    std::atomic<bool> m_didSetupCompleteSuccessfully { false };
+    FileSystem::MappedFileData m_mappedFile;
+    const uint8_t* m_fingerprints { nullptr };
+    size_t m_fingerprintCount { 0 };
 };
 
 } // namespace WebKit
-
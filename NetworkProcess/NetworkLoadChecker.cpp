@@ -226,21 +226,18 @@ void NetworkLoadChecker::applyHTTPSUpgradeIfNeeded(ResourceRequest&& request, Co
 
     auto& httpsUpgradeChecker = m_networkProcess->networkHTTPSUpgradeChecker();
 
-    // Do not wait for httpsUpgradeChecker to complete its setup.
     if (!httpsUpgradeChecker.didSetupCompleteSuccessfully()) {
         handler(WTFMove(request));
         return;
     }
 
-    httpsUpgradeChecker.query(url.host().toString(), m_sessionID, [request = WTFMove(request), handler = WTFMove(handler)] (bool foundHost) mutable {
-        if (foundHost) {
-            auto newURL = request.url();
-            newURL.setProtocol("https");
-            request.setURL(newURL);
-        }
+    if (httpsUpgradeChecker.query(url.host(), m_sessionID)) {
+        auto newURL = request.url();
+        newURL.setProtocol("https");
+        request.setURL(newURL);
+    }
 
-        handler(WTFMove(request));
-    });
+    handler(WTFMove(request));
 #else
     handler(WTFMove(request));
 #endif
@@ -489,13 +486,13 @@ void NetworkLoadChecker::processContentRuleListsForLoad(ResourceRequest&& reques
         return;
     }
 
-    m_networkProcess->networkContentRuleListManager().contentExtensionsBackend(*m_userContentControllerIdentifier, [this, weakThis = makeWeakPtr(this), request = WTFMove(request), callback = WTFMove(callback)](auto& backend) mutable {
+    auto url = request.url();
+    m_networkProcess->networkContentRuleListManager().processContentRuleListsForLoad(*m_userContentControllerIdentifier, url, m_mainDocumentURL, [weakThis = makeWeakPtr(this), request = WTFMove(request), callback = WTFMove(callback)](auto& results) mutable {
         if (!weakThis) {
             callback(makeUnexpected(ResourceError { ResourceError::Type::Cancellation }));
             return;
         }
 
-        auto results = backend.processContentRuleListsForPingLoad(request.url(), m_mainDocumentURL);
         WebCore::ContentExtensions::applyResultsToRequest(ContentRuleListResults { results }, nullptr, request);
         callback(ContentExtensionResult { WTFMove(request), results });
     });
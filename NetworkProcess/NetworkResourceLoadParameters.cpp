@@ -31,8 +31,31 @@
 namespace WebKit {
 using namespace WebCore;
 
-void NetworkResourceLoadParameters::encode(IPC::Encoder& encoder) const
+auto NetworkResourceLoadParameters::fieldsSharedWith(const NetworkResourceLoadParameters& other) const -> OptionSet<SharedField>
 {
+    // Origins are compared by pointer, since loads from the same document share its SecurityOrigin objects.
+    OptionSet<SharedField> sharedFields;
+    if (sourceOrigin == other.sourceOrigin)
+        sharedFields.add(SharedField::SourceOrigin);
+    if (topOrigin == other.topOrigin)
+        sharedFields.add(SharedField::TopOrigin);
+    if (frameAncestorOrigins == other.frameAncestorOrigins)
+        sharedFields.add(SharedField::FrameAncestorOrigins);
+#if ENABLE(CONTENT_EXTENSIONS)
+    if (mainDocumentURL == other.mainDocumentURL && userContentControllerIdentifier == other.userContentControllerIdentifier)
+        sharedFields.add(SharedField::MainDocumentURL);
+#endif
+    return sharedFields;
+}
+
+void NetworkResourceLoadParameters::encode(IPC::Encoder& encoder, const NetworkResourceLoadParameters* previous) const
+{
+    OptionSet<SharedField> sharedFields;
+    if (previous) {
+        sharedFields = fieldsSharedWith(*previous);
+        encoder << sharedFields;
+    }
+
     encoder << identifier;
     encoder << webPageProxyID;
     encoder << webPageID;
@@ -88,12 +111,16 @@ void NetworkResourceLoadParameters::encode(IPC::Encoder& encoder) const
     encoder << shouldRelaxThirdPartyCookieBlocking;
     encoder << maximumBufferingTime;
 
-    encoder << static_cast<bool>(sourceOrigin);
-    if (sourceOrigin)
-        encoder << *sourceOrigin;
-    encoder << static_cast<bool>(topOrigin);
-    if (sourceOrigin)
-        encoder << *topOrigin;
+    if (!sharedFields.contains(SharedField::SourceOrigin)) {
+        encoder << static_cast<bool>(sourceOrigin);
+        if (sourceOrigin)
+            encoder << *sourceOrigin;
+    }
+    if (!sharedFields.contains(SharedField::TopOrigin)) {
+        encoder << static_cast<bool>(topOrigin);
+        if (topOrigin)
+            encoder << *topOrigin;
+    }
     encoder << options;
     encoder << cspResponseHeaders;
     encoder << originalRequestHeaders;
@@ -104,7 +131,8 @@ void NetworkResourceLoadParameters::encode(IPC::Encoder& encoder) const
 
     encoder << shouldEnableCrossOriginResourcePolicy;
 
-    encoder << frameAncestorOrigins;
+    if (!sharedFields.contains(SharedField::FrameAncestorOrigins))
+        encoder << frameAncestorOrigins;
     encoder << isHTTPSUpgradeEnabled;
     encoder << pageHasResourceLoadClient;
     encoder << parentFrameID;
@@ -117,17 +145,28 @@ void NetworkResourceLoadParameters::encode(IPC::Encoder& encoder) const
 #endif
 
 #if ENABLE(CONTENT_EXTENSIONS)
-    encoder << mainDocumentURL;
-    encoder << userContentControllerIdentifier;
+    if (!sharedFields.contains(SharedField::MainDocumentURL)) {
+        encoder << mainDocumentURL;
+        encoder << userContentControllerIdentifier;
+    }
 #endif
     
     encoder << isNavigatingToAppBoundDomain;
 }
 
-Optional<NetworkResourceLoadParameters> NetworkResourceLoadParameters::decode(IPC::Decoder& decoder)
+Optional<NetworkResourceLoadParameters> NetworkResourceLoadParameters::decode(IPC::Decoder& decoder, const NetworkResourceLoadParameters* previous)
 {
     NetworkResourceLoadParameters result;
 
+    OptionSet<SharedField> sharedFields;
+    if (previous) {
+        Optional<OptionSet<SharedField>> decodedSharedFields;
+        decoder >> decodedSharedFields;
+        if (!decodedSharedFields)
+            return WTF::nullopt;
+        sharedFields = *decodedSharedFields;
+    }
+
     if (!decoder.decode(result.identifier))
         return WTF::nullopt;
         
@@ -203,22 +242,30 @@ Optional<NetworkResourceLoadParameters> NetworkResourceLoadParameters::decode(IP
     if (!decoder.decode(result.maximumBufferingTime))
         return WTF::nullopt;
 
-    bool hasSourceOrigin;
-    if (!decoder.decode(hasSourceOrigin))
-        return WTF::nullopt;
-    if (hasSourceOrigin) {
-        result.sourceOrigin = SecurityOrigin::decode(decoder);
-        if (!result.sourceOrigin)
+    if (sharedFields.contains(SharedField::SourceOrigin))
+        result.sourceOrigin = previous->sourceOrigin;
+    else {
+        bool hasSourceOrigin;
+        if (!decoder.decode(hasSourceOrigin))
             return WTF::nullopt;
+        if (hasSourceOrigin) {
+            result.sourceOrigin = SecurityOrigin::decode(decoder);
+            if (!result.sourceOrigin)
+                return WTF::nullopt;
+        }
     }
 
-    bool hasTopOrigin;
-    if (!decoder.decode(hasTopOrigin))
-        return WTF::nullopt;
-    if (hasTopOrigin) {
-        result.topOrigin = SecurityOrigin::decode(decoder);
-        if (!result.topOrigin)
+    if (sharedFields.contains(SharedField::TopOrigin))
+        result.topOrigin = previous->topOrigin;
+    else {
+        bool hasTopOrigin;
+        if (!decoder.decode(hasTopOrigin))
             return WTF::nullopt;
+        if (hasTopOrigin) {
+            result.topOrigin = SecurityOrigin::decode(decoder);
+            if (!result.topOrigin)
+                return WTF::nullopt;
+        }
     }
 
     Optional<FetchOptions> options;
@@ -247,7 +294,9 @@ Optional<NetworkResourceLoadParameters> NetworkResourceLoadParameters::decode(IP
         return WTF::nullopt;
     result.shouldEnableCrossOriginResourcePolicy = *shouldEnableCrossOriginResourcePolicy;
 
-    if (!decoder.decode(result.frameAncestorOrigins))
+    if (sharedFields.contains(SharedField::FrameAncestorOrigins))
+        result.frameAncestorOrigins = previous->frameAncestorOrigins;
+    else if (!decoder.decode(result.frameAncestorOrigins))
         return WTF::nullopt;
 
     Optional<bool> isHTTPSUpgradeEnabled;
@@ -295,14 +344,19 @@ Optional<NetworkResourceLoadParameters> NetworkResourceLoadParameters::decode(IP
 #endif
 
 #if ENABLE(CONTENT_EXTENSIONS)
-    if (!decoder.decode(result.mainDocumentURL))
-        return WTF::nullopt;
+    if (sharedFields.contains(SharedField::MainDocumentURL)) {
+        result.mainDocumentURL = previous->mainDocumentURL;
+        result.userContentControllerIdentifier = previous->userContentControllerIdentifier;
+    } else {
+        if (!decoder.decode(result.mainDocumentURL))
+            return WTF::nullopt;
 
-    Optional<Optional<UserContentControllerIdentifier>> userContentControllerIdentifier;
-    decoder >> userContentControllerIdentifier;
-    if (!userContentControllerIdentifier)
-        return WTF::nullopt;
-    result.userContentControllerIdentifier = *userContentControllerIdentifier;
+        Optional<Optional<UserContentControllerIdentifier>> userContentControllerIdentifier;
+        decoder >> userContentControllerIdentifier;
+        if (!userContentControllerIdentifier)
+            return WTF::nullopt;
+        result.userContentControllerIdentifier = *userContentControllerIdentifier;
+    }
 #endif
 
     Optional<Optional<NavigatingToAppBoundDomain>> isNavigatingToAppBoundDomain;
@@ -313,5 +367,32 @@ Optional<NetworkResourceLoadParameters> NetworkResourceLoadParameters::decode(IP
 
     return result;
 }
-    
+
+void NetworkResourceLoadParameters::Batch::encode(IPC::Encoder& encoder) const
+{
+    encoder << static_cast<uint64_t>(loads.size());
+    const NetworkResourceLoadParameters* previous = nullptr;
+    for (auto& load : loads) {
+        load.encode(encoder, previous);
+        previous = &load;
+    }
+}
+
+auto NetworkResourceLoadParameters::Batch::decode(IPC::Decoder& decoder) -> Optional<Batch>
+{
+    Optional<uint64_t> size;
+    decoder >> size;
+    if (!size)
+        return WTF::nullopt;
+
+    Batch result;
+    for (uint64_t i = 0; i < *size; ++i) {
+        auto load = NetworkResourceLoadParameters::decode(decoder, result.loads.isEmpty() ? nullptr : &result.loads.last());
+        if (!load)
+            return WTF::nullopt;
+        result.loads.append(WTFMove(*load));
+    }
+    return result;
+}
+
 } // namespace WebKit
@@ -45,8 +45,11 @@ typedef uint64_t ResourceLoadIdentifier;
 
 class NetworkResourceLoadParameters : public NetworkLoadParameters {
 public:
-    void encode(IPC::Encoder&) const;
-    static Optional<NetworkResourceLoadParameters> decode(IPC::Decoder&);
+    void encode(IPC::Encoder& encoder) const { encode(encoder, nullptr); }
+    static Optional<NetworkResourceLoadParameters> decode(IPC::Decoder& decoder) { return decode(decoder, nullptr); }
+
+    // Loads scheduled during the same run loop iteration, sent in one message.
+    struct Batch;
 
     ResourceLoadIdentifier identifier { 0 };
     Vector<RefPtr<SandboxExtension>> requestBodySandboxExtensions; // Created automatically for the sender.
@@ -77,6 +80,27 @@ public:
 #endif
     
     Optional<NavigatingToAppBoundDomain> isNavigatingToAppBoundDomain { NavigatingToAppBoundDomain::No };
+
+private:
+    // Fields that are usually the same for every load of a document. Inside a batch, they are only encoded
+    // when they differ from the previous load.
+    enum class SharedField : uint8_t {
+        SourceOrigin = 1 << 0,
+        TopOrigin = 1 << 1,
+        FrameAncestorOrigins = 1 << 2,
+        MainDocumentURL = 1 << 3,
+    };
+    OptionSet<SharedField> fieldsSharedWith(const NetworkResourceLoadParameters&) const;
+
+    void encode(IPC::Encoder&, const NetworkResourceLoadParameters* previous) const;
+    static Optional<NetworkResourceLoadParameters> decode(IPC::Decoder&, const NetworkResourceLoadParameters* previous);
+};
+
+struct NetworkResourceLoadParameters::Batch {
+    Vector<NetworkResourceLoadParameters> loads;
+
+    void encode(IPC::Encoder&) const;
+    static Optional<Batch> decode(IPC::Decoder&);
 };
 
 } // namespace WebKit
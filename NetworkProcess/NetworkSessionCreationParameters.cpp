@@ -64,6 +64,7 @@ void NetworkSessionCreationParameters::encode(IPC::Encoder& encoder) const
     encoder << persistentCredentialStorageEnabled;
     encoder << ignoreTLSErrors;
     encoder << proxySettings;
+    encoder << downloadSegmentCount;
 #endif
 #if USE(CURL)
     encoder << cookiePersistentStorageFile;
@@ -187,6 +188,11 @@ Optional<NetworkSessionCreationParameters> NetworkSessionCreationParameters::dec
     decoder >> proxySettings;
     if (!proxySettings)
         return WTF::nullopt;
+
+    Optional<unsigned> downloadSegmentCount;
+    decoder >> downloadSegmentCount;
+    if (!downloadSegmentCount)
+        return WTF::nullopt;
 #endif
 
 #if USE(CURL)
@@ -306,6 +312,7 @@ Optional<NetworkSessionCreationParameters> NetworkSessionCreationParameters::dec
         , WTFMove(*persistentCredentialStorageEnabled)
         , WTFMove(*ignoreTLSErrors)
         , WTFMove(*proxySettings)
+        , WTFMove(*downloadSegmentCount)
 #endif
 #if USE(CURL)
         , WTFMove(*cookiePersistentStorageFile)
@@ -77,6 +77,7 @@ struct NetworkSessionCreationParameters {
     bool persistentCredentialStorageEnabled { true };
     bool ignoreTLSErrors { false };
     WebCore::SoupNetworkProxySettings proxySettings;
+    unsigned downloadSegmentCount { 1 };
 #endif
 #if USE(CURL)
     String cookiePersistentStorageFile;
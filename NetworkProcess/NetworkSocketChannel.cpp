@@ -32,6 +32,7 @@
 #include "WebCoreArgumentCoders.h"
 #include "WebSocketChannelMessages.h"
 #include "WebSocketTask.h"
+#include <wtf/CallbackAggregator.h>
 
 namespace WebKit {
 using namespace WebCore;
@@ -51,6 +52,7 @@ NetworkSocketChannel::NetworkSocketChannel(NetworkConnectionToWebProcess& connec
     , m_identifier(identifier)
     , m_session(makeWeakPtr(session))
     , m_errorTimer(*this, &NetworkSocketChannel::sendDelayedError)
+    , m_receivedFramesTimer(*this, &NetworkSocketChannel::flushReceivedFrames)
 {
     if (!m_session)
         return;
@@ -71,14 +73,37 @@ NetworkSocketChannel::~NetworkSocketChannel()
         m_socket->cancel();
 }
 
-void NetworkSocketChannel::sendString(const IPC::DataReference& message, CompletionHandler<void()>&& callback)
+void NetworkSocketChannel::sendFrame(WebSocketFrameBatch::FrameType type, const uint8_t* data, size_t length, CompletionHandler<void()>&& callback)
 {
-    m_socket->sendString(message, WTFMove(callback));
+    switch (type) {
+    case WebSocketFrameBatch::FrameType::Text:
+        m_socket->sendString({ data, length }, WTFMove(callback));
+        return;
+    case WebSocketFrameBatch::FrameType::Binary:
+        m_socket->sendData({ data, length }, WTFMove(callback));
+        return;
+    }
 }
 
-void NetworkSocketChannel::sendData(const IPC::DataReference& data, CompletionHandler<void()>&& callback)
+void NetworkSocketChannel::sendFrames(WebSocketFrameBatch&& frames, CompletionHandler<void()>&& callback)
 {
-    m_socket->sendData(data, WTFMove(callback));
+    // Replies once for the whole batch, when the socket is done with its last frame.
+    auto callbackAggregator = CallbackAggregator::create(WTFMove(callback));
+    frames.forEachFrame([&](auto type, auto* data, size_t length) {
+        sendFrame(type, data, length, [callbackAggregator] { });
+    });
+}
+
+void NetworkSocketChannel::sendFrameInSharedMemory(WebSocketFrameBatch::FrameType type, SharedMemory::IPCHandle&& ipcHandle, CompletionHandler<void()>&& callback)
+{
+    if (ipcHandle.handle.isNull())
+        return callback();
+
+    auto sharedMemory = SharedMemory::map(ipcHandle.handle, SharedMemory::Protection::ReadOnly);
+    if (!sharedMemory || ipcHandle.dataSize > sharedMemory->size())
+        return callback();
+
+    sendFrame(type, static_cast<const uint8_t*>(sharedMemory->data()), ipcHandle.dataSize, WTFMove(callback));
 }
 
 void NetworkSocketChannel::finishClosingIfPossible()
@@ -105,16 +130,55 @@ void NetworkSocketChannel::didConnect(const String& subprotocol, const String& e
 
 void NetworkSocketChannel::didReceiveText(const String& text)
 {
-    send(Messages::WebSocketChannel::DidReceiveText { text });
+    auto utf8 = text.utf8();
+    m_receivedFrames.append(WebSocketFrameBatch::FrameType::Text, reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length());
+    if (m_receivedFrames.byteLength() >= WebSocketFrameBatch::maximumByteLength) {
+        flushReceivedFrames();
+        return;
+    }
+
+    if (!m_receivedFramesTimer.isActive())
+        m_receivedFramesTimer.startOneShot(0_s);
 }
 
 void NetworkSocketChannel::didReceiveBinaryData(const uint8_t* data, size_t length)
 {
-    send(Messages::WebSocketChannel::DidReceiveBinaryData { { data, length } });
+    if (length >= WebSocketFrameBatch::largeFrameThreshold) {
+        if (auto sharedMemory = SharedMemory::allocate(length)) {
+            SharedMemory::Handle handle;
+            if (sharedMemory->createHandle(handle, SharedMemory::Protection::ReadOnly)) {
+                memcpy(sharedMemory->data(), data, length);
+                flushReceivedFrames();
+                send(Messages::WebSocketChannel::DidReceiveBinaryDataInSharedMemory { SharedMemory::IPCHandle { WTFMove(handle), length } });
+                return;
+            }
+        }
+    }
+
+    m_receivedFrames.append(WebSocketFrameBatch::FrameType::Binary, data, length);
+    if (m_receivedFrames.byteLength() >= WebSocketFrameBatch::maximumByteLength) {
+        flushReceivedFrames();
+        return;
+    }
+
+    if (!m_receivedFramesTimer.isActive())
+        m_receivedFramesTimer.startOneShot(0_s);
+}
+
+void NetworkSocketChannel::flushReceivedFrames()
+{
+    m_receivedFramesTimer.stop();
+    if (m_receivedFrames.isEmpty())
+        return;
+
+    send(Messages::WebSocketChannel::DidReceiveFrames { m_receivedFrames });
+    m_receivedFrames.clear();
 }
 
 void NetworkSocketChannel::didClose(unsigned short code, const String& reason)
 {
+    flushReceivedFrames();
+
     if (m_errorTimer.isActive()) {
         m_closeInfo = std::make_pair(code, reason);
         return;
@@ -125,6 +189,7 @@ void NetworkSocketChannel::didClose(unsigned short code, const String& reason)
 
 void NetworkSocketChannel::didReceiveMessageError(const String& errorMessage)
 {
+    flushReceivedFrames();
     m_errorMessage = errorMessage;
     m_errorTimer.startOneShot(NetworkProcess::randomClosedPortDelay());
 }
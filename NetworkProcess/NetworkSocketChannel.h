@@ -28,6 +28,8 @@
 #include "DataReference.h"
 #include "MessageReceiver.h"
 #include "MessageSender.h"
+#include "SharedMemory.h"
+#include "WebSocketFrameBatch.h"
 #include <WebCore/Timer.h>
 #include <WebCore/WebSocketIdentifier.h>
 #include <pal/SessionID.h>
@@ -71,8 +73,10 @@ private:
     void didSendHandshakeRequest(WebCore::ResourceRequest&&);
     void didReceiveHandshakeResponse(WebCore::ResourceResponse&&);
 
-    void sendString(const IPC::DataReference&, CompletionHandler<void()>&&);
-    void sendData(const IPC::DataReference&, CompletionHandler<void()>&&);
+    void sendFrames(WebSocketFrameBatch&&, CompletionHandler<void()>&&);
+    void sendFrameInSharedMemory(WebSocketFrameBatch::FrameType, SharedMemory::IPCHandle&&, CompletionHandler<void()>&&);
+    void sendFrame(WebSocketFrameBatch::FrameType, const uint8_t* data, size_t length, CompletionHandler<void()>&&);
+    void flushReceivedFrames();
     void close(int32_t code, const String& reason);
     void sendDelayedError();
 
@@ -91,6 +95,8 @@ private:
     enum class State { Open, Closing, Closed };
     State m_state { State::Open };
     WebCore::Timer m_errorTimer;
+    WebSocketFrameBatch m_receivedFrames;
+    WebCore::Timer m_receivedFramesTimer;
     String m_errorMessage;
     Optional<std::pair<unsigned short, String>> m_closeInfo;
 };
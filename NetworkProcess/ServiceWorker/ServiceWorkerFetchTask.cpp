@@ -158,6 +158,16 @@ void ServiceWorkerFetchTask::didReceiveData(const IPC::DataReference& data, int6
     sendToClient(Messages::WebResourceLoader::DidReceiveData { data, encodedDataLength });
 }
 
+void ServiceWorkerFetchTask::didReceiveDataInSharedMemory(SharedMemory::IPCHandle&& ipcHandle, int64_t encodedDataLength)
+{
+    if (m_isDone)
+        return;
+
+    ASSERT(!m_timeoutTimer.isActive());
+    // The body bytes go straight from the service worker process to the client process, we only forward the handle.
+    sendToClient(Messages::WebResourceLoader::DidReceiveDataInSharedMemory { ipcHandle, encodedDataLength });
+}
+
 void ServiceWorkerFetchTask::didReceiveFormData(const IPC::FormDataReference& formData)
 {
     if (m_isDone)
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DownloadSegmentSoup.h"
+
+#include <libsoup/soup.h>
+#include <wtf/glib/GUniquePtr.h>
+#include <wtf/glib/RunLoopSourcePriority.h>
+
+namespace WebKit {
+
+static const size_t gDownloadSegmentBufferSize = 64 * KB;
+
+RefPtr<DownloadSegmentSoup> DownloadSegmentSoup::create(Client& client, GFile* file, const DownloadByteRange& range, GError** error)
+{
+    GRefPtr<GFileIOStream> fileStream = adoptGRef(g_file_open_readwrite(file, nullptr, error));
+    if (!fileStream)
+        return nullptr;
+
+    if (range.start && !g_seekable_seek(G_SEEKABLE(fileStream.get()), range.start, G_SEEK_SET, nullptr, error))
+        return nullptr;
+
+    return adoptRef(*new DownloadSegmentSoup(client, WTFMove(fileStream), range));
+}
+
+DownloadSegmentSoup::DownloadSegmentSoup(Client& client, GRefPtr<GFileIOStream>&& fileStream, const DownloadByteRange& range)
+    : m_client(client)
+    , m_range(range)
+    , m_fileStream(WTFMove(fileStream))
+    , m_cancellable(adoptGRef(g_cancellable_new()))
+{
+}
+
+DownloadSegmentSoup::~DownloadSegmentSoup()
+{
+    closeStreams();
+}
+
+void DownloadSegmentSoup::start(SoupSession* session, SoupMessage* soupMessage, GRefPtr<GInputStream>&& inputStream)
+{
+    ASSERT(m_state == State::Created || m_state == State::Running);
+    m_state = State::Running;
+    m_session = session;
+    m_soupMessage = soupMessage;
+    m_inputStream = WTFMove(inputStream);
+    for (auto& buffer : m_buffers)
+        buffer.grow(gDownloadSegmentBufferSize);
+
+    continueTransfer();
+}
+
+void DownloadSegmentSoup::startWithRequest(SoupSession* session, GRefPtr<SoupMessage>&& soupMessage)
+{
+    ASSERT(m_state == State::Created);
+    m_state = State::Running;
+    m_session = session;
+    m_soupMessage = WTFMove(soupMessage);
+    soup_message_headers_set_range(m_soupMessage->request_headers, m_range.start, m_range.end ? *m_range.end : -1);
+
+    RefPtr<DownloadSegmentSoup> protectedThis(this);
+    soup_session_send_async(m_session.get(), m_soupMessage.get(), m_cancellable.get(),
+        reinterpret_cast<GAsyncReadyCallback>(sendRequestCallback), protectedThis.leakRef());
+}
+
+void DownloadSegmentSoup::cancel()
+{
+    if (m_state != State::Created && m_state != State::Running)
+        return;
+
+    m_state = State::Canceled;
+    g_cancellable_cancel(m_cancellable.get());
+    closeStreams();
+}
+
+void DownloadSegmentSoup::sendRequestCallback(SoupSession* session, GAsyncResult* result, DownloadSegmentSoup* segment)
+{
+    RefPtr<DownloadSegmentSoup> protectedThis = adoptRef(segment);
+    if (segment->m_state != State::Running)
+        return;
+
+    GUniqueOutPtr<GError> error;
+    GRefPtr<GInputStream> inputStream = adoptGRef(soup_session_send_finish(session, result, &error.outPtr()));
+    if (error) {
+        segment->didFail(FailureType::Network, String::fromUTF8(error->message));
+        return;
+    }
+    segment->didSendRequest(WTFMove(inputStream));
+}
+
+void DownloadSegmentSoup::didSendRequest(GRefPtr<GInputStream>&& inputStream)
+{
+    // A full response means the server ignored the Range or the If-Range validator no longer
+    // matches; either way the bytes can't be placed at this segment's offset.
+    goffset rangeStart, rangeEnd, totalLength;
+    if (m_soupMessage->status_code != SOUP_STATUS_PARTIAL_CONTENT
+        || !soup_message_headers_get_content_range(m_soupMessage->response_headers, &rangeStart, &rangeEnd, &totalLength)
+        || static_cast<uint64_t>(rangeStart) != m_range.start) {
+        m_inputStream = WTFMove(inputStream);
+        didFail(FailureType::Network, String::fromUTF8(m_soupMessage->reason_phrase));
+        return;
+    }
+
+    start(m_session.get(), m_soupMessage.get(), WTFMove(inputStream));
+}
+
+void DownloadSegmentSoup::continueTransfer()
+{
+    ASSERT(m_state == State::Running);
+
+    // Buffers are written in the same order they were filled.
+    if (!m_isWriting && m_pendingWriteSizes[m_writeBufferIndex])
+        write(m_writeBufferIndex);
+
+    if (!m_isReading && !m_inputFinished && !m_pendingWriteSizes[m_readBufferIndex])
+        read();
+
+    if (m_inputFinished && !m_isReading && !m_isWriting)
+        didFinish();
+}
+
+void DownloadSegmentSoup::readCallback(GInputStream* inputStream, GAsyncResult* result, DownloadSegmentSoup* segment)
+{
+    RefPtr<DownloadSegmentSoup> protectedThis = adoptRef(segment);
+    if (segment->m_state != State::Running)
+        return;
+    ASSERT(inputStream == segment->m_inputStream.get());
+
+    GUniqueOutPtr<GError> error;
+    gssize bytesRead = g_input_stream_read_finish(inputStream, result, &error.outPtr());
+    if (error)
+        segment->didFail(FailureType::Network, String::fromUTF8(error->message));
+    else
+        segment->didRead(bytesRead);
+}
+
+void DownloadSegmentSoup::read()
+{
+    size_t bytesToRead = gDownloadSegmentBufferSize;
+    if (m_range.end)
+        bytesToRead = std::min<uint64_t>(bytesToRead, *m_range.end - m_range.start + 1 - m_bytesRead);
+    if (!bytesToRead) {
+        m_inputFinished = true;
+        return;
+    }
+
+    m_isReading = true;
+    RefPtr<DownloadSegmentSoup> protectedThis(this);
+    g_input_stream_read_async(m_inputStream.get(), m_buffers[m_readBufferIndex].data(), bytesToRead, RunLoopSourcePriority::AsyncIONetwork, m_cancellable.get(),
+        reinterpret_cast<GAsyncReadyCallback>(readCallback), protectedThis.leakRef());
+}
+
+void DownloadSegmentSoup::didRead(size_t bytesRead)
+{
+    m_isReading = false;
+    if (!bytesRead) {
+        if (m_range.end && m_range.start + m_bytesRead <= *m_range.end) {
+            didFail(FailureType::Network, "The connection was closed before the whole range was received"_s);
+            return;
+        }
+        m_reachedEndOfStream = true;
+        m_inputFinished = true;
+    } else {
+        m_bytesRead += bytesRead;
+        m_pendingWriteSizes[m_readBufferIndex] = bytesRead;
+        m_readBufferIndex = !m_readBufferIndex;
+    }
+
+    continueTransfer();
+}
+
+void DownloadSegmentSoup::writeCallback(GOutputStream* outputStream, GAsyncResult* result, DownloadSegmentSoup* segment)
+{
+    RefPtr<DownloadSegmentSoup> protectedThis = adoptRef(segment);
+    if (segment->m_state != State::Running)
+        return;
+
+    GUniqueOutPtr<GError> error;
+    gsize bytesWritten;
+    g_output_stream_write_all_finish(outputStream, result, &bytesWritten, &error.outPtr());
+    if (error)
+        segment->didFail(FailureType::Destination, String::fromUTF8(error->message));
+    else
+        segment->didWrite(bytesWritten);
+}
+
+void DownloadSegmentSoup::write(unsigned bufferIndex)
+{
+    m_isWriting = true;
+    RefPtr<DownloadSegmentSoup> protectedThis(this);
+    GOutputStream* outputStream = g_io_stream_get_output_stream(G_IO_STREAM(m_fileStream.get()));
+    g_output_stream_write_all_async(outputStream, m_buffers[bufferIndex].data(), m_pendingWriteSizes[bufferIndex], RunLoopSourcePriority::AsyncIONetwork, m_cancellable.get(),
+        reinterpret_cast<GAsyncReadyCallback>(writeCallback), protectedThis.leakRef());
+}
+
+void DownloadSegmentSoup::didWrite(size_t bytesWritten)
+{
+    ASSERT(bytesWritten == m_pendingWriteSizes[m_writeBufferIndex]);
+    m_isWriting = false;
+    m_pendingWriteSizes[m_writeBufferIndex] = 0;
+    m_writeBufferIndex = !m_writeBufferIndex;
+    m_bytesWritten += bytesWritten;
+
+    m_client.downloadSegmentDidWriteData(*this, bytesWritten);
+    if (m_state != State::Running)
+        return;
+
+    continueTransfer();
+}
+
+void DownloadSegmentSoup::didFinish()
+{
+    closeStreams();
+    m_state = State::Finished;
+    m_client.downloadSegmentDidFinish(*this);
+}
+
+void DownloadSegmentSoup::didFail(FailureType failureType, const String& localizedDescription)
+{
+    m_state = State::Failed;
+    g_cancellable_cancel(m_cancellable.get());
+    closeStreams();
+    m_client.downloadSegmentDidFail(*this, failureType, localizedDescription);
+}
+
+void DownloadSegmentSoup::closeStreams()
+{
+    if (m_inputStream) {
+        // Closing a response body that still has unread data would drain it synchronously,
+        // which happens when the range ends before the resource does.
+        if (!m_reachedEndOfStream && m_soupMessage)
+            soup_session_cancel_message(m_session.get(), m_soupMessage.get(), SOUP_STATUS_CANCELLED);
+        g_input_stream_close(m_inputStream.get(), nullptr, nullptr);
+        m_inputStream = nullptr;
+    }
+    m_soupMessage = nullptr;
+
+    if (m_fileStream) {
+        g_io_stream_close(G_IO_STREAM(m_fileStream.get()), nullptr, nullptr);
+        m_fileStream = nullptr;
+    }
+}
+
+} // namespace WebKit
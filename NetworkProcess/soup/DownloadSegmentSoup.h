@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <array>
+#include <wtf/Optional.h>
+#include <wtf/RefCounted.h>
+#include <wtf/Vector.h>
+#include <wtf/glib/GRefPtr.h>
+#include <wtf/text/WTFString.h>
+
+typedef struct _SoupMessage SoupMessage;
+typedef struct _SoupSession SoupSession;
+
+namespace WebKit {
+
+struct DownloadByteRange {
+    uint64_t start { 0 };
+    // Inclusive, unset when the range extends to the end of the resource.
+    Optional<uint64_t> end;
+};
+
+// Writes one byte range of a download to its offset in the destination file. The next chunk is
+// read from the network while the previous one is being written, using two alternating buffers.
+class DownloadSegmentSoup : public RefCounted<DownloadSegmentSoup> {
+public:
+    enum class FailureType : bool { Network, Destination };
+
+    class Client {
+    public:
+        virtual void downloadSegmentDidWriteData(DownloadSegmentSoup&, uint64_t bytesWritten) = 0;
+        virtual void downloadSegmentDidFinish(DownloadSegmentSoup&) = 0;
+        virtual void downloadSegmentDidFail(DownloadSegmentSoup&, FailureType, const String& localizedDescription) = 0;
+
+    protected:
+        virtual ~Client() = default;
+    };
+
+    static RefPtr<DownloadSegmentSoup> create(Client&, GFile*, const DownloadByteRange&, GError**);
+    ~DownloadSegmentSoup();
+
+    // Transfers the range from the body of a response that starts at the first byte of the range.
+    void start(SoupSession*, SoupMessage*, GRefPtr<GInputStream>&&);
+    // Sends the given message with a Range header for this segment and transfers the partial response.
+    void startWithRequest(SoupSession*, GRefPtr<SoupMessage>&&);
+    void cancel();
+
+    bool isFinished() const { return m_state == State::Finished; }
+    // The part of the range that hasn't been written to the file yet.
+    DownloadByteRange remainingRange() const { return { m_range.start + m_bytesWritten, m_range.end }; }
+
+private:
+    DownloadSegmentSoup(Client&, GRefPtr<GFileIOStream>&&, const DownloadByteRange&);
+
+    static void sendRequestCallback(SoupSession*, GAsyncResult*, DownloadSegmentSoup*);
+    void didSendRequest(GRefPtr<GInputStream>&&);
+
+    static void readCallback(GInputStream*, GAsyncResult*, DownloadSegmentSoup*);
+    void read();
+    void didRead(size_t bytesRead);
+
+    static void writeCallback(GOutputStream*, GAsyncResult*, DownloadSegmentSoup*);
+    void write(unsigned bufferIndex);
+    void didWrite(size_t bytesWritten);
+
+    void continueTransfer();
+    void didFinish();
+    void didFail(FailureType, const String& localizedDescription);
+    void closeStreams();
+
+    enum class State { Created, Running, Finished, Failed, Canceled };
+
+    Client& m_client;
+    State m_state { State::Created };
+    DownloadByteRange m_range;
+    GRefPtr<GFileIOStream> m_fileStream;
+    GRefPtr<GInputStream> m_inputStream;
+    GRefPtr<SoupSession> m_session;
+    GRefPtr<SoupMessage> m_soupMessage;
+    GRefPtr<GCancellable> m_cancellable;
+    std::array<Vector<char>, 2> m_buffers;
+    // Number of bytes waiting to be written (or being written) from each buffer.
+    std::array<size_t, 2> m_pendingWriteSizes { { 0, 0 } };
+    unsigned m_readBufferIndex { 0 };
+    unsigned m_writeBufferIndex { 0 };
+    bool m_isReading { false };
+    bool m_isWriting { false };
+    bool m_inputFinished { false };
+    bool m_reachedEndOfStream { false };
+    uint64_t m_bytesRead { 0 };
+    uint64_t m_bytesWritten { 0 };
+};
+
+} // namespace WebKit
@@ -45,11 +45,99 @@
 #include <WebCore/TextEncoding.h>
 #include <wtf/MainThread.h>
 #include <wtf/glib/RunLoopSourcePriority.h>
+#include <wtf/persistence/PersistentDecoder.h>
+#include <wtf/persistence/PersistentEncoder.h>
+#include <wtf/text/StringConcatenateNumbers.h>
 
 namespace WebKit {
 using namespace WebCore;
 
 static const size_t gDefaultReadBufferSize = 8192;
+static const uint64_t gMinimumDownloadSegmentSize = 1 * MB;
+static const uint32_t downloadResumeDataVersion = 1;
+
+struct DownloadResumeData {
+    ResourceRequest request;
+    String validator;
+    String suggestedFilename;
+    Vector<DownloadByteRange> remainingRanges;
+};
+
+static Optional<DownloadResumeData> decodeDownloadResumeData(const IPC::DataReference& resumeData)
+{
+    WTF::Persistence::Decoder decoder(resumeData.data(), resumeData.size());
+
+    Optional<uint32_t> version;
+    decoder >> version;
+    if (!version || *version != downloadResumeDataVersion)
+        return WTF::nullopt;
+
+    Optional<String> url;
+    decoder >> url;
+    if (!url)
+        return WTF::nullopt;
+
+    Optional<String> firstPartyForCookies;
+    decoder >> firstPartyForCookies;
+    if (!firstPartyForCookies)
+        return WTF::nullopt;
+
+    Optional<String> userAgent;
+    decoder >> userAgent;
+    if (!userAgent)
+        return WTF::nullopt;
+
+    Optional<String> validator;
+    decoder >> validator;
+    if (!validator)
+        return WTF::nullopt;
+
+    Optional<String> suggestedFilename;
+    decoder >> suggestedFilename;
+    if (!suggestedFilename)
+        return WTF::nullopt;
+
+    Optional<uint64_t> rangeCount;
+    decoder >> rangeCount;
+    if (!rangeCount || !*rangeCount)
+        return WTF::nullopt;
+
+    Vector<DownloadByteRange> remainingRanges;
+    for (uint64_t i = 0; i < *rangeCount; ++i) {
+        Optional<uint64_t> start;
+        decoder >> start;
+        Optional<bool> hasEnd;
+        decoder >> hasEnd;
+        Optional<uint64_t> end;
+        decoder >> end;
+        if (!start || !hasEnd || !end || (*hasEnd && *end < *start))
+            return WTF::nullopt;
+
+        DownloadByteRange range { *start, WTF::nullopt };
+        if (*hasEnd)
+            range.end = *end;
+        remainingRanges.append(WTFMove(range));
+    }
+
+    if (!decoder.verifyChecksum())
+        return WTF::nullopt;
+
+    ResourceRequest request { URL(URL(), *url) };
+    request.setFirstPartyForCookies(URL(URL(), *firstPartyForCookies));
+    if (!userAgent->isEmpty())
+        request.setHTTPUserAgent(*userAgent);
+
+    return DownloadResumeData { WTFMove(request), WTFMove(*validator), WTFMove(*suggestedFilename), WTFMove(remainingRanges) };
+}
+
+RefPtr<NetworkDataTask> NetworkDataTaskSoup::createForResumedDownload(NetworkSession& session, DownloadID downloadID, const IPC::DataReference& resumeData, const String& destinationPath)
+{
+    auto downloadResumeData = decodeDownloadResumeData(resumeData);
+    if (!downloadResumeData || !downloadResumeData->request.url().protocolIsInHTTPFamily() || destinationPath.isEmpty())
+        return nullptr;
+
+    return adoptRef(*new NetworkDataTaskSoup(session, downloadID, WTFMove(*downloadResumeData), destinationPath));
+}
 
 NetworkDataTaskSoup::NetworkDataTaskSoup(NetworkSession& session, NetworkDataTaskClient& client, const ResourceRequest& requestWithCredentials, FrameIdentifier frameID, PageIdentifier pageID, StoredCredentialsPolicy storedCredentialsPolicy, ContentSniffingPolicy shouldContentSniff, WebCore::ContentEncodingSniffingPolicy, bool shouldClearReferrerOnHTTPSToHTTPRedirect, bool dataTaskIsForMainFrameNavigation)
     : NetworkDataTask(session, client, requestWithCredentials, storedCredentialsPolicy, shouldClearReferrerOnHTTPSToHTTPRedirect, dataTaskIsForMainFrameNavigation)
@@ -79,6 +167,40 @@ NetworkDataTaskSoup::NetworkDataTaskSoup(NetworkSession& session, NetworkDataTas
     createRequest(WTFMove(request), WasBlockingCookies::No);
 }
 
+NetworkDataTaskSoup::NetworkDataTaskSoup(NetworkSession& session, DownloadID downloadID, DownloadResumeData&& resumeData, const String& destinationPath)
+    : NetworkDataTask(session, downloadID, resumeData.request, StoredCredentialsPolicy::Use)
+    , m_shouldContentSniff(ContentSniffingPolicy::DoNotSniffContent)
+    , m_pendingDownloadRanges(WTFMove(resumeData.remainingRanges))
+    , m_downloadValidator(WTFMove(resumeData.validator))
+    , m_downloadSupportsByteRanges(true)
+    , m_timeoutSource(RunLoop::main(), this, &NetworkDataTaskSoup::timeoutFired)
+{
+    m_session->registerNetworkDataTask(*this);
+
+    m_pendingDownloadLocation = destinationPath;
+    m_suggestedFilename = WTFMove(resumeData.suggestedFilename);
+    m_startTime = MonotonicTime::now();
+
+    CString downloadDestinationPath = destinationPath.utf8();
+    m_downloadDestinationFile = adoptGRef(g_file_new_for_path(downloadDestinationPath.data()));
+    GUniquePtr<char> intermediatePath(g_strdup_printf("%s.wkdownload", downloadDestinationPath.data()));
+    m_downloadIntermediateFile = adoptGRef(g_file_new_for_path(intermediatePath.get()));
+
+    // Without the partial file there's nothing to resume from, so the whole resource is requested again.
+    if (!g_file_query_exists(m_downloadIntermediateFile.get(), nullptr)) {
+        m_pendingDownloadRanges = { DownloadByteRange { 0, WTF::nullopt } };
+        m_downloadValidator = String();
+    }
+
+    auto request = m_firstRequest;
+    const auto& range = m_pendingDownloadRanges.first();
+    if (range.start || range.end) {
+        request.setHTTPHeaderField(HTTPHeaderName::Range, range.end ? makeString("bytes=", range.start, '-', *range.end) : makeString("bytes=", range.start, '-'));
+        request.setHTTPHeaderField(HTTPHeaderName::IfRange, m_downloadValidator);
+    }
+    createRequest(WTFMove(request), WasBlockingCookies::No);
+}
+
 NetworkDataTaskSoup::~NetworkDataTaskSoup()
 {
     clearRequest();
@@ -139,6 +261,9 @@ void NetworkDataTaskSoup::createRequest(ResourceRequest&& request, WasBlockingCo
     unsigned messageFlags = SOUP_MESSAGE_NO_REDIRECT;
 
     m_currentRequest.updateSoupMessage(soupMessage.get(), m_session->blobRegistry());
+    // The ranges of a resumed download refer to the bytes stored on disk, so the body can't be decoded on the fly.
+    if (isDownload() && !m_client)
+        soup_message_disable_feature(soupMessage.get(), SOUP_TYPE_CONTENT_DECODER);
     if (m_shouldContentSniff == ContentSniffingPolicy::DoNotSniffContent)
         soup_message_disable_feature(soupMessage.get(), SOUP_TYPE_CONTENT_SNIFFER);
     if (m_user.isEmpty() && m_password.isEmpty() && m_storedCredentialsPolicy == StoredCredentialsPolicy::DoNotUse) {
@@ -205,7 +330,7 @@ void NetworkDataTaskSoup::clearRequest()
     m_soupRequest = nullptr;
     m_inputStream = nullptr;
     m_multipartInputStream = nullptr;
-    m_downloadOutputStream = nullptr;
+    cancelDownloadSegments();
     g_cancellable_cancel(m_cancellable.get());
     m_cancellable = nullptr;
     m_isBlockingCookies = false;
@@ -265,8 +390,24 @@ void NetworkDataTaskSoup::cancel()
 
     g_cancellable_cancel(m_cancellable.get());
 
-    if (isDownload())
+    if (isDownload()) {
+        cancelDownloadSegments();
         cleanDownloadFiles();
+    }
+}
+
+void NetworkDataTaskSoup::cancelByProducingResumeData(CompletionHandler<void(const IPC::DataReference&)>&& completionHandler)
+{
+    auto resumeData = m_state == State::Canceling || m_state == State::Completed ? Vector<uint8_t>() : createDownloadResumeData();
+    if (resumeData.isEmpty()) {
+        cancel();
+        completionHandler({ });
+        return;
+    }
+
+    // Unlike cancel(), this leaves the partial file in place for the download to be resumed.
+    clearRequest();
+    completionHandler(resumeData);
 }
 
 void NetworkDataTaskSoup::invalidateAndCancel()
@@ -282,12 +423,16 @@ NetworkDataTask::State NetworkDataTaskSoup::state() const
 
 void NetworkDataTaskSoup::timeoutFired()
 {
-    if (m_state == State::Canceling || m_state == State::Completed || !m_client) {
+    if (m_state == State::Canceling || m_state == State::Completed || (!m_client && !isDownload())) {
         clearRequest();
         return;
     }
 
     RefPtr<NetworkDataTaskSoup> protectedThis(this);
+    if (!m_client) {
+        didFail(ResourceError::timeoutError(m_firstRequest.url()));
+        return;
+    }
     invalidateAndCancel();
     dispatchDidCompleteWithError(ResourceError::timeoutError(m_firstRequest.url()));
 }
@@ -318,7 +463,7 @@ void NetworkDataTaskSoup::sendRequestCallback(SoupRequest* soupRequest, GAsyncRe
         return;
     }
 
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client) {
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload())) {
         task->clearRequest();
         return;
     }
@@ -352,6 +497,15 @@ void NetworkDataTaskSoup::didSendRequest(GRefPtr<GInputStream>&& inputStream)
             return;
         }
 
+        if (!m_client) {
+            // Only resumed downloads get here without a client.
+            ASSERT(isDownload());
+            m_inputStream = WTFMove(inputStream);
+            m_networkLoadMetrics.responseStart = MonotonicTime::now() - m_startTime;
+            didReceiveResumedDownloadResponse();
+            return;
+        }
+
         if (m_response.isMultipart())
             m_multipartInputStream = adoptGRef(soup_multipart_input_stream_new(m_soupMessage.get(), inputStream.get()));
         else
@@ -428,7 +582,7 @@ void NetworkDataTaskSoup::dispatchDidCompleteWithError(const ResourceError& erro
 
 gboolean NetworkDataTaskSoup::tlsConnectionAcceptCertificateCallback(GTlsConnection* connection, GTlsCertificate* certificate, GTlsCertificateFlags errors, NetworkDataTaskSoup* task)
 {
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client) {
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload())) {
         task->clearRequest();
         return FALSE;
     }
@@ -449,6 +603,10 @@ bool NetworkDataTaskSoup::tlsConnectionAcceptCertificate(GTlsCertificate* certif
         return true;
 
     RefPtr<NetworkDataTaskSoup> protectedThis(this);
+    if (!m_client) {
+        didFail(error.value());
+        return false;
+    }
     invalidateAndCancel();
     dispatchDidCompleteWithError(error.value());
     return false;
@@ -484,7 +642,7 @@ void NetworkDataTaskSoup::authenticateCallback(SoupSession* session, SoupMessage
     if (soupMessage != task->m_soupMessage.get() && (soupMessage->status_code != SOUP_STATUS_PROXY_AUTHENTICATION_REQUIRED || !task->m_currentRequest.url().protocolIs("https")))
         return;
 
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client) {
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload())) {
         task->clearRequest();
         return;
     }
@@ -533,7 +691,7 @@ void NetworkDataTaskSoup::authenticate(AuthenticationChallenge&& challenge)
         auto protectionSpace = challenge.protectionSpace();
         m_session->networkStorageSession()->getCredentialFromPersistentStorage(protectionSpace, m_cancellable.get(),
             [this, protectedThis = makeRef(*this), authChallenge = WTFMove(challenge)] (Credential&& credential) mutable {
-                if (m_state == State::Canceling || m_state == State::Completed || !m_client) {
+                if (m_state == State::Canceling || m_state == State::Completed || (!m_client && !isDownload())) {
                     clearRequest();
                     return;
                 }
@@ -547,7 +705,7 @@ void NetworkDataTaskSoup::authenticate(AuthenticationChallenge&& challenge)
 
 void NetworkDataTaskSoup::continueAuthenticate(AuthenticationChallenge&& challenge)
 {
-    m_client->didReceiveChallenge(AuthenticationChallenge(challenge), NegotiatedLegacyTLS::No, [this, protectedThis = makeRef(*this), challenge](AuthenticationChallengeDisposition disposition, const Credential& credential) {
+    ChallengeCompletionHandler completionHandler = [this, protectedThis = makeRef(*this), challenge](AuthenticationChallengeDisposition disposition, const Credential& credential) {
         if (m_state == State::Canceling || m_state == State::Completed) {
             clearRequest();
             return;
@@ -578,13 +736,23 @@ void NetworkDataTaskSoup::continueAuthenticate(AuthenticationChallenge&& challen
         }
 
         soup_session_unpause_message(static_cast<NetworkSessionSoup&>(*m_session).soupSession(), challenge.soupMessage());
-    });
+    };
+
+    if (!m_client) {
+        // Resumed downloads have no client, the download handles the challenge itself.
+        auto* download = m_session->networkProcess().downloadManager().download(m_pendingDownloadID);
+        ASSERT(download);
+        download->didReceiveChallenge(challenge, WTFMove(completionHandler));
+        return;
+    }
+
+    m_client->didReceiveChallenge(AuthenticationChallenge(challenge), NegotiatedLegacyTLS::No, WTFMove(completionHandler));
 }
 
 void NetworkDataTaskSoup::skipInputStreamForRedirectionCallback(GInputStream* inputStream, GAsyncResult* result, NetworkDataTaskSoup* task)
 {
     RefPtr<NetworkDataTaskSoup> protectedThis = adoptRef(task);
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client) {
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload())) {
         task->clearRequest();
         return;
     }
@@ -715,8 +883,7 @@ void NetworkDataTaskSoup::continueHTTPRedirection()
 
     clearRequest();
 
-    auto response = ResourceResponse(m_response);
-    m_client->willPerformHTTPRedirection(WTFMove(response), WTFMove(request), [this, protectedThis = makeRef(*this), isCrossOrigin, wasBlockingCookies, userAgent = WTFMove(userAgent)](const ResourceRequest& newRequest) {
+    RedirectCompletionHandler completionHandler = [this, protectedThis = makeRef(*this), isCrossOrigin, wasBlockingCookies, userAgent = WTFMove(userAgent)](const ResourceRequest& newRequest) {
         if (newRequest.isNull() || m_state == State::Canceling)
             return;
 
@@ -737,7 +904,16 @@ void NetworkDataTaskSoup::continueHTTPRedirection()
             m_state = State::Suspended;
             resume();
         }
-    });
+    };
+
+    // Resumed downloads have no client to ask, they follow redirects like the original load did.
+    if (!m_client) {
+        completionHandler(WTFMove(request));
+        return;
+    }
+
+    auto response = ResourceResponse(m_response);
+    m_client->willPerformHTTPRedirection(WTFMove(response), WTFMove(request), WTFMove(completionHandler));
 }
 
 void NetworkDataTaskSoup::readCallback(GInputStream* inputStream, GAsyncResult* result, NetworkDataTaskSoup* task)
@@ -777,14 +953,9 @@ void NetworkDataTaskSoup::read()
 void NetworkDataTaskSoup::didRead(gssize bytesRead)
 {
     m_readBuffer.shrink(bytesRead);
-    if (m_downloadOutputStream) {
-        ASSERT(isDownload());
-        writeDownload();
-    } else {
-        ASSERT(m_client);
-        m_client->didReceiveData(SharedBuffer::create(WTFMove(m_readBuffer)));
-        read();
-    }
+    ASSERT(m_client);
+    m_client->didReceiveData(SharedBuffer::create(WTFMove(m_readBuffer)));
+    read();
 }
 
 void NetworkDataTaskSoup::didFinishRead()
@@ -797,11 +968,6 @@ void NetworkDataTaskSoup::didFinishRead()
         return;
     }
 
-    if (m_downloadOutputStream) {
-        didFinishDownload();
-        return;
-    }
-
     clearRequest();
     ASSERT(m_client);
     dispatchDidCompleteWithError({ });
@@ -862,7 +1028,7 @@ void NetworkDataTaskSoup::didFinishRequestNextPart()
 
 void NetworkDataTaskSoup::gotHeadersCallback(SoupMessage* soupMessage, NetworkDataTaskSoup* task)
 {
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client) {
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload())) {
         task->clearRequest();
         return;
     }
@@ -925,6 +1091,9 @@ void NetworkDataTaskSoup::download()
         return;
     }
 
+    // The timeout covers getting the response, not transferring the whole download.
+    stopTimeout();
+
     CString downloadDestinationPath = m_pendingDownloadLocation.utf8();
     m_downloadDestinationFile = adoptGRef(g_file_new_for_path(downloadDestinationPath.data()));
     GRefPtr<GFileOutputStream> outputStream;
@@ -940,12 +1109,11 @@ void NetworkDataTaskSoup::download()
 
     GUniquePtr<char> intermediatePath(g_strdup_printf("%s.wkdownload", downloadDestinationPath.data()));
     m_downloadIntermediateFile = adoptGRef(g_file_new_for_path(intermediatePath.get()));
-    outputStream = adoptGRef(g_file_replace(m_downloadIntermediateFile.get(), nullptr, TRUE, G_FILE_CREATE_NONE, nullptr, &error.outPtr()));
-    if (!outputStream) {
-        didFailDownload(downloadDestinationError(m_response, error->message));
+    m_downloadSupportsByteRanges = responseSupportsByteRanges();
+    m_downloadValidator = downloadValidatorForResponse();
+    auto ranges = downloadRangesForResponse();
+    if (!prepareDownloadIntermediateFile(ranges.size() > 1 ? m_response.expectedContentLength() : 0))
         return;
-    }
-    m_downloadOutputStream = adoptGRef(G_OUTPUT_STREAM(outputStream.leakRef()));
 
     auto& downloadManager = m_session->networkProcess().downloadManager();
     auto download = makeUnique<Download>(downloadManager, m_pendingDownloadID, *this, *m_session, suggestedFilename());
@@ -954,50 +1122,265 @@ void NetworkDataTaskSoup::download()
     downloadPtr->didCreateDestination(m_pendingDownloadLocation);
 
     ASSERT(!m_client);
-    read();
+    startDownloadSegments(WTFMove(ranges));
 }
 
-void NetworkDataTaskSoup::writeDownloadCallback(GOutputStream* outputStream, GAsyncResult* result, NetworkDataTaskSoup* task)
+void NetworkDataTaskSoup::didReceiveResumedDownloadResponse()
 {
-    RefPtr<NetworkDataTaskSoup> protectedThis = adoptRef(task);
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->isDownload()) {
-        task->clearRequest();
+    ASSERT(m_soupMessage);
+    ASSERT(!m_pendingDownloadRanges.isEmpty());
+    stopTimeout();
+
+    auto statusCode = m_response.httpStatusCode();
+    if (statusCode == SOUP_STATUS_PARTIAL_CONTENT) {
+        goffset rangeStart, rangeEnd, totalLength;
+        if (!soup_message_headers_get_content_range(m_soupMessage->response_headers, &rangeStart, &rangeEnd, &totalLength) || static_cast<uint64_t>(rangeStart) != m_pendingDownloadRanges[0].start) {
+            didFailDownload(downloadNetworkError(m_response.url(), m_response.httpStatusText()));
+            return;
+        }
+
+        startDownloadSegments(std::exchange(m_pendingDownloadRanges, { }));
         return;
     }
-    ASSERT(outputStream == task->m_downloadOutputStream.get());
 
-    GUniqueOutPtr<GError> error;
-    gsize bytesWritten;
-    g_output_stream_write_all_finish(outputStream, result, &bytesWritten, &error.outPtr());
-    if (error)
-        task->didFailDownload(downloadDestinationError(task->m_response, error->message));
+    if (!SOUP_STATUS_IS_SUCCESSFUL(statusCode)) {
+        // Server errors are usually transient, so the download can still be resumed later.
+        didFailDownload(downloadNetworkError(m_response.url(), m_response.httpStatusText()), SOUP_STATUS_IS_SERVER_ERROR(statusCode) ? createDownloadResumeData() : Vector<uint8_t>());
+        return;
+    }
+
+    // The server sent the whole resource, either because it changed since the download was
+    // interrupted or because it ignored the range, so the download starts over.
+    m_pendingDownloadRanges.clear();
+    m_downloadSupportsByteRanges = responseSupportsByteRanges();
+    m_downloadValidator = downloadValidatorForResponse();
+    auto ranges = downloadRangesForResponse();
+    if (!prepareDownloadIntermediateFile(ranges.size() > 1 ? m_response.expectedContentLength() : 0))
+        return;
+
+    startDownloadSegments(WTFMove(ranges));
+}
+
+bool NetworkDataTaskSoup::responseSupportsByteRanges() const
+{
+    if (!m_soupMessage || !equalLettersIgnoringASCIICase(m_currentRequest.httpMethod(), "get"))
+        return false;
+
+    // Offsets must refer to the representation written to disk, which isn't the case when libsoup decodes the body.
+    auto contentEncoding = m_response.httpHeaderField(HTTPHeaderName::ContentEncoding);
+    if (!contentEncoding.isEmpty() && !equalLettersIgnoringASCIICase(contentEncoding, "identity"))
+        return false;
+
+    if (m_response.httpStatusCode() != SOUP_STATUS_PARTIAL_CONTENT && !equalLettersIgnoringASCIICase(m_response.httpHeaderField(HTTPHeaderName::AcceptRanges), "bytes"))
+        return false;
+
+    return !downloadValidatorForResponse().isEmpty();
+}
+
+String NetworkDataTaskSoup::downloadValidatorForResponse() const
+{
+    // If-Range only accepts strong entity tags.
+    auto entityTag = m_response.httpHeaderField(HTTPHeaderName::ETag);
+    if (!entityTag.isEmpty() && !entityTag.startsWith("W/"))
+        return entityTag;
+    return m_response.httpHeaderField(HTTPHeaderName::LastModified);
+}
+
+Vector<DownloadByteRange> NetworkDataTaskSoup::downloadRangesForResponse() const
+{
+    // Segments are sent directly to the session, so they can't answer authentication challenges.
+    // Downloads that needed credentials are never split.
+    bool hasCredentials = !m_user.isEmpty() || !m_password.isEmpty() || m_currentRequest.url().hasCredentials()
+        || (m_soupMessage && soup_message_headers_get_one(m_soupMessage->request_headers, "Authorization"));
+
+    auto contentLength = m_response.expectedContentLength();
+    uint64_t segmentCount = static_cast<NetworkSessionSoup&>(*m_session).downloadSegmentCount();
+    if (segmentCount > 1 && !hasCredentials && m_downloadSupportsByteRanges && m_response.httpStatusCode() == SOUP_STATUS_OK && contentLength > 0)
+        segmentCount = std::min<uint64_t>(segmentCount, contentLength / gMinimumDownloadSegmentSize);
     else
-        task->didWriteDownload(bytesWritten);
+        segmentCount = 1;
+
+    if (segmentCount <= 1)
+        return { DownloadByteRange { 0, WTF::nullopt } };
+
+    uint64_t segmentSize = contentLength / segmentCount;
+    Vector<DownloadByteRange> ranges;
+    ranges.reserveInitialCapacity(segmentCount);
+    for (uint64_t i = 0; i < segmentCount; ++i) {
+        uint64_t start = i * segmentSize;
+        uint64_t end = i == segmentCount - 1 ? contentLength - 1 : start + segmentSize - 1;
+        ranges.uncheckedAppend(DownloadByteRange { start, end });
+    }
+    return ranges;
 }
 
-void NetworkDataTaskSoup::writeDownload()
+bool NetworkDataTaskSoup::prepareDownloadIntermediateFile(uint64_t preallocatedSize)
 {
-    RefPtr<NetworkDataTaskSoup> protectedThis(this);
-    g_output_stream_write_all_async(m_downloadOutputStream.get(), m_readBuffer.data(), m_readBuffer.size(), RunLoopSourcePriority::AsyncIONetwork, m_cancellable.get(),
-        reinterpret_cast<GAsyncReadyCallback>(writeDownloadCallback), protectedThis.leakRef());
+    // Segments write at their own offsets, so the file gets its final size up front.
+    GUniqueOutPtr<GError> error;
+    GRefPtr<GFileOutputStream> outputStream = adoptGRef(g_file_replace(m_downloadIntermediateFile.get(), nullptr, FALSE, G_FILE_CREATE_NONE, nullptr, &error.outPtr()));
+    if (outputStream && preallocatedSize)
+        g_seekable_truncate(G_SEEKABLE(outputStream.get()), preallocatedSize, nullptr, &error.outPtr());
+    if (error) {
+        didFailDownload(downloadDestinationError(m_response, error->message));
+        return false;
+    }
+
+    g_output_stream_close(G_OUTPUT_STREAM(outputStream.get()), nullptr, nullptr);
+    return true;
+}
+
+void NetworkDataTaskSoup::startDownloadSegments(Vector<DownloadByteRange>&& ranges)
+{
+    ASSERT(!ranges.isEmpty());
+    ASSERT(m_inputStream);
+    ASSERT(m_downloadSegments.isEmpty());
+
+    for (const auto& range : ranges) {
+        GUniqueOutPtr<GError> error;
+        auto segment = DownloadSegmentSoup::create(*this, m_downloadIntermediateFile.get(), range, &error.outPtr());
+        if (!segment) {
+            m_downloadSegments.clear();
+            didFailDownload(downloadDestinationError(m_response, error->message));
+            return;
+        }
+        m_downloadSegments.append(segment.releaseNonNull());
+    }
+
+    // The first segment keeps reading the response we already have, the others are requested
+    // separately so that they are transferred over connections of their own.
+    SoupSession* soupSession = static_cast<NetworkSessionSoup&>(*m_session).soupSession();
+    m_downloadSegments[0]->start(soupSession, m_soupMessage.get(), WTFMove(m_inputStream));
+    for (size_t i = 1; i < m_downloadSegments.size(); ++i)
+        m_downloadSegments[i]->startWithRequest(soupSession, createDownloadSegmentMessage());
 }
 
-void NetworkDataTaskSoup::didWriteDownload(gsize bytesWritten)
+static gboolean downloadSegmentAcceptCertificateCallback(GTlsConnection* connection, GTlsCertificate* certificate, GTlsCertificateFlags errors, NetworkSessionSoup* session)
+{
+    auto* soupMessage = static_cast<SoupMessage*>(g_object_get_data(G_OBJECT(connection), "wk-soup-message"));
+    return !session->soupNetworkSession().checkTLSErrors(soupURIToURL(soup_message_get_uri(soupMessage)), certificate, errors);
+}
+
+static void downloadSegmentNetworkEventCallback(SoupMessage* soupMessage, GSocketClientEvent event, GIOStream* connection, NetworkSessionSoup* session)
+{
+    if (event != G_SOCKET_CLIENT_TLS_HANDSHAKING)
+        return;
+
+    g_object_set_data(G_OBJECT(connection), "wk-soup-message", soupMessage);
+    g_signal_connect(connection, "accept-certificate", G_CALLBACK(downloadSegmentAcceptCertificateCallback), session);
+}
+
+GRefPtr<SoupMessage> NetworkDataTaskSoup::createDownloadSegmentMessage() const
+{
+    ASSERT(m_soupMessage);
+    ASSERT(!m_downloadValidator.isEmpty());
+
+    GRefPtr<SoupMessage> soupMessage = adoptGRef(soup_message_new_from_uri(SOUP_METHOD_GET, soup_message_get_uri(m_soupMessage.get())));
+    soup_message_headers_foreach(m_soupMessage->request_headers, [](const char* name, const char* value, gpointer userData) {
+        soup_message_headers_append(static_cast<SoupMessageHeaders*>(userData), name, value);
+    }, soupMessage->request_headers);
+
+    // Cookies are added again by the cookie jar when the message is sent, and the body must not be
+    // encoded since the range refers to the bytes stored on disk.
+    soup_message_headers_remove(soupMessage->request_headers, "Cookie");
+    soup_message_headers_remove(soupMessage->request_headers, "Accept-Encoding");
+    soup_message_headers_remove(soupMessage->request_headers, "Range");
+    soup_message_headers_replace(soupMessage->request_headers, "If-Range", m_downloadValidator.utf8().data());
+    soup_message_disable_feature(soupMessage.get(), SOUP_TYPE_CONTENT_DECODER);
+    if (m_isBlockingCookies)
+        soup_message_disable_feature(soupMessage.get(), SOUP_TYPE_COOKIE_JAR);
+
+    // The cookie jar and third party cookie blocking decide from the same first party and site for cookies as the original request.
+    soup_message_set_first_party(soupMessage.get(), soup_message_get_first_party(m_soupMessage.get()));
+#if SOUP_CHECK_VERSION(2, 69, 90)
+    soup_message_set_site_for_cookies(soupMessage.get(), soup_message_get_site_for_cookies(m_soupMessage.get()));
+    soup_message_set_is_top_level_navigation(soupMessage.get(), soup_message_get_is_top_level_navigation(m_soupMessage.get()));
+#endif
+#if SOUP_CHECK_VERSION(2, 67, 1)
+    // The URI is the one the original request ended up with, after any HSTS upgrade, so it must be used as is.
+    soup_message_disable_feature(soupMessage.get(), SOUP_TYPE_HSTS_ENFORCER);
+#endif
+
+    soup_message_set_flags(soupMessage.get(), soup_message_get_flags(m_soupMessage.get()));
+    soup_message_set_priority(soupMessage.get(), soup_message_get_priority(m_soupMessage.get()));
+    g_signal_connect(soupMessage.get(), "network-event", G_CALLBACK(downloadSegmentNetworkEventCallback), &static_cast<NetworkSessionSoup&>(*m_session));
+    return soupMessage;
+}
+
+void NetworkDataTaskSoup::cancelDownloadSegments()
+{
+    for (auto& segment : m_downloadSegments)
+        segment->cancel();
+}
+
+Vector<uint8_t> NetworkDataTaskSoup::createDownloadResumeData() const
+{
+    // Resuming relies on If-Range to detect that the resource changed, and on the partial file still being there.
+    if (!m_downloadSupportsByteRanges || m_downloadValidator.isEmpty() || !m_downloadIntermediateFile)
+        return { };
+
+    Vector<DownloadByteRange> remainingRanges;
+    if (m_downloadSegments.isEmpty())
+        remainingRanges = m_pendingDownloadRanges;
+    else {
+        for (auto& segment : m_downloadSegments) {
+            if (!segment->isFinished())
+                remainingRanges.append(segment->remainingRange());
+        }
+    }
+    if (remainingRanges.isEmpty())
+        return { };
+
+    WTF::Persistence::Encoder encoder;
+    encoder << downloadResumeDataVersion;
+    encoder << m_currentRequest.url().string();
+    encoder << m_currentRequest.firstPartyForCookies().string();
+    encoder << m_currentRequest.httpUserAgent();
+    encoder << m_downloadValidator;
+    encoder << suggestedFilename();
+    encoder << static_cast<uint64_t>(remainingRanges.size());
+    for (const auto& range : remainingRanges) {
+        encoder << range.start;
+        encoder << !!range.end;
+        encoder << range.end.valueOr(0);
+    }
+    encoder.encodeChecksum();
+
+    return Vector<uint8_t>(encoder.buffer(), encoder.bufferSize());
+}
+
+void NetworkDataTaskSoup::downloadSegmentDidWriteData(DownloadSegmentSoup&, uint64_t bytesWritten)
 {
-    ASSERT(bytesWritten == m_readBuffer.size());
     auto* download = m_session->networkProcess().downloadManager().download(m_pendingDownloadID);
     ASSERT(download);
     download->didReceiveData(bytesWritten, 0, 0);
-    read();
+}
+
+void NetworkDataTaskSoup::downloadSegmentDidFinish(DownloadSegmentSoup&)
+{
+    if (m_downloadSegments.findMatching([](auto& segment) { return !segment->isFinished(); }) != notFound)
+        return;
+
+    RefPtr<NetworkDataTaskSoup> protectedThis(this);
+    didFinishDownload();
+}
+
+void NetworkDataTaskSoup::downloadSegmentDidFail(DownloadSegmentSoup&, DownloadSegmentSoup::FailureType failureType, const String& localizedDescription)
+{
+    RefPtr<NetworkDataTaskSoup> protectedThis(this);
+    switch (failureType) {
+    case DownloadSegmentSoup::FailureType::Network:
+        didFailDownload(downloadNetworkError(m_response.url(), localizedDescription), createDownloadResumeData());
+        break;
+    case DownloadSegmentSoup::FailureType::Destination:
+        didFailDownload(downloadDestinationError(m_response, localizedDescription));
+        break;
+    }
 }
 
 void NetworkDataTaskSoup::didFinishDownload()
 {
     ASSERT(!m_response.isNull());
-    ASSERT(m_downloadOutputStream);
-    g_output_stream_close(m_downloadOutputStream.get(), nullptr, nullptr);
-    m_downloadOutputStream = nullptr;
-
     ASSERT(m_downloadDestinationFile);
     ASSERT(m_downloadIntermediateFile);
     GUniqueOutPtr<GError> error;
@@ -1018,16 +1401,19 @@ void NetworkDataTaskSoup::didFinishDownload()
     download->didFinish();
 }
 
-void NetworkDataTaskSoup::didFailDownload(const ResourceError& error)
+void NetworkDataTaskSoup::didFailDownload(const ResourceError& error, const Vector<uint8_t>& resumeData)
 {
     clearRequest();
-    cleanDownloadFiles();
+    // A resumed download continues writing to the partial file, so it is only kept when the client can resume.
+    bool keepsResumeData = !resumeData.isEmpty() && m_pendingDownloadProducesResumeDataOnFailure == ProduceResumeData::Yes;
+    if (!keepsResumeData)
+        cleanDownloadFiles();
     if (m_client)
         dispatchDidCompleteWithError(error);
     else {
         auto* download = m_session->networkProcess().downloadManager().download(m_pendingDownloadID);
         ASSERT(download);
-        download->didFail(error, IPC::DataReference());
+        download->didFail(error, keepsResumeData ? resumeData : Vector<uint8_t>());
     }
 }
 
@@ -1046,7 +1432,7 @@ void NetworkDataTaskSoup::cleanDownloadFiles()
 void NetworkDataTaskSoup::didFail(const ResourceError& error)
 {
     if (isDownload()) {
-        didFailDownload(downloadNetworkError(error.failingURL(), error.localizedDescription()));
+        didFailDownload(downloadNetworkError(error.failingURL(), error.localizedDescription()), createDownloadResumeData());
         return;
     }
 
@@ -1057,7 +1443,7 @@ void NetworkDataTaskSoup::didFail(const ResourceError& error)
 
 void NetworkDataTaskSoup::networkEventCallback(SoupMessage* soupMessage, GSocketClientEvent event, GIOStream* stream, NetworkDataTaskSoup* task)
 {
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client)
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload()))
         return;
 
     ASSERT(task->m_soupMessage.get() == soupMessage);
@@ -1104,7 +1490,7 @@ void NetworkDataTaskSoup::networkEvent(GSocketClientEvent event, GIOStream* stre
 
 void NetworkDataTaskSoup::startingCallback(SoupMessage* soupMessage, NetworkDataTaskSoup* task)
 {
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client)
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload()))
         return;
 
     ASSERT(task->m_soupMessage.get() == soupMessage);
@@ -1138,7 +1524,7 @@ void NetworkDataTaskSoup::protocolUpgradedViaHSTS(SoupMessage* soupMessage)
 
 void NetworkDataTaskSoup::hstsEnforced(SoupHSTSEnforcer*, SoupMessage* soupMessage, NetworkDataTaskSoup* task)
 {
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client) {
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload())) {
         task->clearRequest();
         return;
     }
@@ -1158,7 +1544,7 @@ void NetworkDataTaskSoup::restartedCallback(SoupMessage* soupMessage, NetworkDat
 {
     // Called each time the message is going to be sent again except the first time.
     // This happens when libsoup handles HTTP authentication.
-    if (task->state() == State::Canceling || task->state() == State::Completed || !task->m_client)
+    if (task->state() == State::Canceling || task->state() == State::Completed || (!task->m_client && !task->isDownload()))
         return;
 
     ASSERT(task->m_soupMessage.get() == soupMessage);
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "DownloadSegmentSoup.h"
 #include "NetworkDataTask.h"
 #include <WebCore/FrameIdentifier.h>
 #include <WebCore/NetworkLoadMetrics.h>
@@ -36,21 +37,27 @@
 
 namespace WebKit {
 
-class NetworkDataTaskSoup final : public NetworkDataTask {
+struct DownloadResumeData;
+
+class NetworkDataTaskSoup final : public NetworkDataTask, private DownloadSegmentSoup::Client {
 public:
     static Ref<NetworkDataTask> create(NetworkSession& session, NetworkDataTaskClient& client, const WebCore::ResourceRequest& request, WebCore::FrameIdentifier frameID, WebCore::PageIdentifier pageID, WebCore::StoredCredentialsPolicy storedCredentialsPolicy, WebCore::ContentSniffingPolicy shouldContentSniff, WebCore::ContentEncodingSniffingPolicy shouldContentEncodingSniff, bool shouldClearReferrerOnHTTPSToHTTPRedirect, bool dataTaskIsForMainFrameNavigation)
     {
         return adoptRef(*new NetworkDataTaskSoup(session, client, request, frameID, pageID, storedCredentialsPolicy, shouldContentSniff, shouldContentEncodingSniff, shouldClearReferrerOnHTTPSToHTTPRedirect, dataTaskIsForMainFrameNavigation));
     }
 
+    static RefPtr<NetworkDataTask> createForResumedDownload(NetworkSession&, DownloadID, const IPC::DataReference& resumeData, const String& destinationPath);
+
     ~NetworkDataTaskSoup();
 
 private:
     NetworkDataTaskSoup(NetworkSession&, NetworkDataTaskClient&, const WebCore::ResourceRequest&, WebCore::FrameIdentifier, WebCore::PageIdentifier, WebCore::StoredCredentialsPolicy, WebCore::ContentSniffingPolicy, WebCore::ContentEncodingSniffingPolicy, bool shouldClearReferrerOnHTTPSToHTTPRedirect, bool dataTaskIsForMainFrameNavigation);
+    NetworkDataTaskSoup(NetworkSession&, DownloadID, DownloadResumeData&&, const String& destinationPath);
 
     void cancel() override;
     void resume() override;
     void invalidateAndCancel() override;
+    void cancelByProducingResumeData(CompletionHandler<void(const IPC::DataReference&)>&&) override;
     NetworkDataTask::State state() const override;
 
     void setPendingDownloadLocation(const String&, SandboxExtension::Handle&&, bool /*allowOverwrite*/) override;
@@ -100,13 +107,24 @@ private:
     void didWriteBodyData(uint64_t bytesSent);
 
     void download();
-    static void writeDownloadCallback(GOutputStream*, GAsyncResult*, NetworkDataTaskSoup*);
-    void writeDownload();
-    void didWriteDownload(gsize bytesWritten);
-    void didFailDownload(const WebCore::ResourceError&);
+    void didReceiveResumedDownloadResponse();
+    bool responseSupportsByteRanges() const;
+    String downloadValidatorForResponse() const;
+    Vector<DownloadByteRange> downloadRangesForResponse() const;
+    bool prepareDownloadIntermediateFile(uint64_t preallocatedSize);
+    void startDownloadSegments(Vector<DownloadByteRange>&&);
+    GRefPtr<SoupMessage> createDownloadSegmentMessage() const;
+    void cancelDownloadSegments();
+    Vector<uint8_t> createDownloadResumeData() const;
+    void didFailDownload(const WebCore::ResourceError&, const Vector<uint8_t>& resumeData = { });
     void didFinishDownload();
     void cleanDownloadFiles();
 
+    // DownloadSegmentSoup::Client
+    void downloadSegmentDidWriteData(DownloadSegmentSoup&, uint64_t bytesWritten) override;
+    void downloadSegmentDidFinish(DownloadSegmentSoup&) override;
+    void downloadSegmentDidFail(DownloadSegmentSoup&, DownloadSegmentSoup::FailureType, const String& localizedDescription) override;
+
     void didFail(const WebCore::ResourceError&);
 
     static void networkEventCallback(SoupMessage*, GSocketClientEvent, GIOStream*, NetworkDataTaskSoup*);
@@ -145,7 +163,11 @@ private:
     uint64_t m_bodyDataTotalBytesSent { 0 };
     GRefPtr<GFile> m_downloadDestinationFile;
     GRefPtr<GFile> m_downloadIntermediateFile;
-    GRefPtr<GOutputStream> m_downloadOutputStream;
+    Vector<Ref<DownloadSegmentSoup>> m_downloadSegments;
+    // Ranges still missing from the intermediate file of a resumed download, until its response arrives.
+    Vector<DownloadByteRange> m_pendingDownloadRanges;
+    String m_downloadValidator;
+    bool m_downloadSupportsByteRanges { false };
     bool m_allowOverwriteDownload { false };
     WebCore::NetworkLoadMetrics m_networkLoadMetrics;
     MonotonicTime m_startTime;
@@ -172,6 +172,12 @@ void NetworkProcess::setPersistentCredentialStorageEnabled(PAL::SessionID sessio
         static_cast<NetworkSessionSoup&>(*session).setPersistentCredentialStorageEnabled(enabled);
 }
 
+void NetworkProcess::setDownloadSegmentCount(PAL::SessionID sessionID, unsigned segmentCount)
+{
+    if (auto* session = networkSession(sessionID))
+        static_cast<NetworkSessionSoup&>(*session).setDownloadSegmentCount(segmentCount);
+}
+
 void NetworkProcess::platformProcessDidTransitionToForeground()
 {
     notImplemented();
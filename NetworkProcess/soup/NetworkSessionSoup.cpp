@@ -43,6 +43,7 @@ NetworkSessionSoup::NetworkSessionSoup(NetworkProcess& networkProcess, NetworkSe
     : NetworkSession(networkProcess, parameters)
     , m_networkSession(makeUnique<SoupNetworkSession>(m_sessionID))
     , m_persistentCredentialStorageEnabled(parameters.persistentCredentialStorageEnabled)
+    , m_downloadSegmentCount(std::max(parameters.downloadSegmentCount, 1U))
 {
     auto* storageSession = networkStorageSession();
     ASSERT(storageSession);
@@ -58,6 +58,9 @@ public:
     void setPersistentCredentialStorageEnabled(bool enabled) { m_persistentCredentialStorageEnabled = enabled; }
     bool persistentCredentialStorageEnabled() const { return m_persistentCredentialStorageEnabled; }
 
+    void setDownloadSegmentCount(unsigned segmentCount) { m_downloadSegmentCount = std::max(segmentCount, 1U); }
+    unsigned downloadSegmentCount() const { return m_downloadSegmentCount; }
+
     void setIgnoreTLSErrors(bool);
     void setProxySettings(WebCore::SoupNetworkProxySettings&&);
 
@@ -67,6 +70,7 @@ private:
 
     std::unique_ptr<WebCore::SoupNetworkSession> m_networkSession;
     bool m_persistentCredentialStorageEnabled { true };
+    unsigned m_downloadSegmentCount { 1 };
 };
 
 } // namespace WebKit
@@ -41,17 +41,17 @@ MessageReceiverMap::~MessageReceiverMap()
 
 void MessageReceiverMap::addMessageReceiver(ReceiverName messageReceiverName, MessageReceiver& messageReceiver)
 {
-    ASSERT(!m_globalMessageReceivers.contains(messageReceiverName));
+    ASSERT(!globalMessageReceiver(messageReceiverName));
 
     messageReceiver.willBeAddedToMessageReceiverMap();
-    m_globalMessageReceivers.set(messageReceiverName, &messageReceiver);
+    globalMessageReceiver(messageReceiverName) = &messageReceiver;
 }
 
 void MessageReceiverMap::addMessageReceiver(ReceiverName messageReceiverName, uint64_t destinationID, MessageReceiver& messageReceiver)
 {
     ASSERT(destinationID);
     ASSERT(!m_messageReceivers.contains(std::make_pair(messageReceiverName, destinationID)));
-    ASSERT(!m_globalMessageReceivers.contains(messageReceiverName));
+    ASSERT(!globalMessageReceiver(messageReceiverName));
 
     messageReceiver.willBeAddedToMessageReceiverMap();
     m_messageReceivers.set(std::make_pair(messageReceiverName, destinationID), &messageReceiver);
@@ -59,12 +59,11 @@ void MessageReceiverMap::addMessageReceiver(ReceiverName messageReceiverName, ui
 
 void MessageReceiverMap::removeMessageReceiver(ReceiverName messageReceiverName)
 {
-    ASSERT(m_globalMessageReceivers.contains(messageReceiverName));
+    auto& messageReceiver = globalMessageReceiver(messageReceiverName);
+    ASSERT(messageReceiver);
 
-    auto it = m_globalMessageReceivers.find(messageReceiverName);
-    it->value->willBeRemovedFromMessageReceiverMap();
-
-    m_globalMessageReceivers.remove(it);
+    messageReceiver->willBeRemovedFromMessageReceiverMap();
+    messageReceiver = nullptr;
 }
 
 void MessageReceiverMap::removeMessageReceiver(ReceiverName messageReceiverName, uint64_t destinationID)
@@ -79,15 +78,13 @@ void MessageReceiverMap::removeMessageReceiver(ReceiverName messageReceiverName,
 
 void MessageReceiverMap::removeMessageReceiver(MessageReceiver& messageReceiver)
 {
-    Vector<ReceiverName> globalReceiversToRemove;
-    for (auto& [name, receiver] : m_globalMessageReceivers) {
-        if (receiver == &messageReceiver)
-            globalReceiversToRemove.append(name);
+    for (auto& receiver : m_globalMessageReceivers) {
+        if (receiver == &messageReceiver) {
+            receiver->willBeRemovedFromMessageReceiverMap();
+            receiver = nullptr;
+        }
     }
 
-    for (auto& globalReceiverToRemove : globalReceiversToRemove)
-        removeMessageReceiver(globalReceiverToRemove);
-
     Vector<std::pair<ReceiverName, uint64_t>> receiversToRemove;
     for (auto& [nameAndDestinationID, receiver] : m_messageReceivers) {
         if (receiver == &messageReceiver)
@@ -100,10 +97,11 @@ void MessageReceiverMap::removeMessageReceiver(MessageReceiver& messageReceiver)
 
 void MessageReceiverMap::invalidate()
 {
-    for (auto& messageReceiver : m_globalMessageReceivers.values())
-        messageReceiver->willBeRemovedFromMessageReceiverMap();
-    m_globalMessageReceivers.clear();
-
+    for (auto& messageReceiver : m_globalMessageReceivers) {
+        if (messageReceiver)
+            messageReceiver->willBeRemovedFromMessageReceiverMap();
+        messageReceiver = nullptr;
+    }
 
     for (auto& messageReceiver : m_messageReceivers.values())
         messageReceiver->willBeRemovedFromMessageReceiverMap();
@@ -112,7 +110,7 @@ void MessageReceiverMap::invalidate()
 
 bool MessageReceiverMap::dispatchMessage(Connection& connection, Decoder& decoder)
 {
-    if (MessageReceiver* messageReceiver = m_globalMessageReceivers.get(decoder.messageReceiverName())) {
+    if (MessageReceiver* messageReceiver = globalMessageReceiver(decoder.messageReceiverName())) {
         ASSERT(!decoder.destinationID());
 
         messageReceiver->didReceiveMessage(connection, decoder);
@@ -129,7 +127,7 @@ bool MessageReceiverMap::dispatchMessage(Connection& connection, Decoder& decode
 
 bool MessageReceiverMap::dispatchSyncMessage(Connection& connection, Decoder& decoder, std::unique_ptr<Encoder>& replyEncoder)
 {
-    if (MessageReceiver* messageReceiver = m_globalMessageReceivers.get(decoder.messageReceiverName())) {
+    if (MessageReceiver* messageReceiver = globalMessageReceiver(decoder.messageReceiverName())) {
         ASSERT(!decoder.destinationID());
 
         messageReceiver->didReceiveSyncMessage(connection, decoder, replyEncoder);
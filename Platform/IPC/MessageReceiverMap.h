@@ -26,6 +26,8 @@
 #pragma once
 
 #include "StringReference.h"
+#include <array>
+#include <limits>
 #include <wtf/HashMap.h>
 #include <wtf/text/CString.h>
 
@@ -55,8 +57,10 @@ public:
     bool dispatchSyncMessage(Connection&, Decoder&, std::unique_ptr<Encoder>&);
 
 private:
-    // Message receivers that don't require a destination ID.
-    HashMap<ReceiverName, MessageReceiver*, WTF::IntHash<ReceiverName>, WTF::StrongEnumHashTraits<ReceiverName>> m_globalMessageReceivers;
+    MessageReceiver*& globalMessageReceiver(ReceiverName name) { return m_globalMessageReceivers[static_cast<size_t>(name)]; }
+
+    // Message receivers that don't require a destination ID, indexed directly by receiver name.
+    std::array<MessageReceiver*, std::numeric_limits<std::underlying_type_t<ReceiverName>>::max() + 1> m_globalMessageReceivers { };
 
     HashMap<std::pair<ReceiverName, uint64_t>, MessageReceiver*, DefaultHash<std::pair<ReceiverName, uint64_t>>, PairHashTraits<WTF::StrongEnumHashTraits<ReceiverName>, HashTraits<uint64_t>>> m_messageReceivers;
 };
@@ -93,6 +93,7 @@ extern "C" {
     M(Storage) \
     M(StorageAPI) \
     M(TextInput) \
+    M(TouchEvents) \
     M(UIHitTesting) \
     M(ViewGestures) \
     M(ViewState) \
@@ -120,6 +120,8 @@ public:
     static RefPtr<SharedMemory> map(const Handle&, Protection);
 #if USE(UNIX_DOMAIN_SOCKETS)
     static RefPtr<SharedMemory> wrapMap(void*, size_t, int fileDescriptor);
+    // Maps the first bytes of an existing file, such as a memfd, and takes ownership of its descriptor.
+    static RefPtr<SharedMemory> adoptFileDescriptor(int fileDescriptor, size_t, Protection);
 #elif OS(DARWIN)
     static RefPtr<SharedMemory> wrapMap(void*, size_t, Protection);
 #endif
@@ -210,6 +210,23 @@ RefPtr<SharedMemory> SharedMemory::wrapMap(void* data, size_t size, int fileDesc
     return instance;
 }
 
+RefPtr<SharedMemory> SharedMemory::adoptFileDescriptor(int fileDescriptor, size_t size, Protection protection)
+{
+    ASSERT(size);
+
+    void* data = mmap(nullptr, size, accessModeMMap(protection), MAP_SHARED, fileDescriptor, 0);
+    if (data == MAP_FAILED) {
+        closeWithRetry(fileDescriptor);
+        return nullptr;
+    }
+
+    RefPtr<SharedMemory> instance = adoptRef(new SharedMemory());
+    instance->m_data = data;
+    instance->m_fileDescriptor = fileDescriptor;
+    instance->m_size = size;
+    return instance;
+}
+
 SharedMemory::~SharedMemory()
 {
     if (m_isWrappingMap)
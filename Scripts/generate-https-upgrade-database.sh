@@ -29,16 +29,20 @@
 #   3. All domains must be lowercase.
 #   4. All domains must be IDNA encoded.
 #
+# The output is a sorted array of 64-bit FNV-1a fingerprints of the domains, which NetworkHTTPSUpgradeChecker
+# memory-maps and binary searches. All integers are little-endian:
+#   "WKHU" | uint32 version | uint64 count | uint64 fingerprints[count]
+# The fingerprint function must stay in sync with NetworkHTTPSUpgradeChecker.cpp.
+#
 # Usage:
-# $ sh ./generate-https-upgrade-database.sh <path to input list> <path to output database>
+# $ sh ./generate-https-upgrade-database.sh <path to input list> <path to output file>
 
 set -e
 
 INPUT_FILE_PATH="${1}"
 OUTPUT_FILE_PATH="${2}"
 
-DB_VERSION="1";
-DB_SCHEMA="CREATE TABLE hosts (host TEXT PRIMARY KEY);"
+FILE_VERSION="2";
 
 if [[ ! -f "${INPUT_FILE_PATH}" ]]; then
     echo "Invalid input file" 1>&2;
@@ -49,4 +53,31 @@ if [[ -f "${OUTPUT_FILE_PATH}" ]]; then
     rm "${OUTPUT_FILE_PATH}"
 fi
 
-sqlite3 "${OUTPUT_FILE_PATH}" "PRAGMA user_version=${DB_VERSION}" "${DB_SCHEMA}" ".import ${INPUT_FILE_PATH} hosts" ".exit"
+python3 - "${INPUT_FILE_PATH}" "${OUTPUT_FILE_PATH}" "${FILE_VERSION}" <<'EOF'
+import struct
+import sys
+
+input_path, output_path, version = sys.argv[1], sys.argv[2], int(sys.argv[3])
+
+
+def fingerprint(host):
+    value = 0xcbf29ce484222325
+    for byte in host.encode('ascii'):
+        value = ((value ^ byte) * 0x100000001b3) & 0xffffffffffffffff
+    return value
+
+
+with open(input_path) as input_file:
+    hosts = [line.strip() for line in input_file if line.strip()]
+
+fingerprints = sorted(set(fingerprint(host) for host in hosts))
+if len(fingerprints) != len(set(hosts)):
+    sys.stderr.write("Fingerprint collision in %s\n" % input_path)
+    sys.exit(1)
+
+with open(output_path, 'wb') as output_file:
+    output_file.write(b'WKHU')
+    output_file.write(struct.pack('<IQ', version, len(fingerprints)))
+    for value in fingerprints:
+        output_file.write(struct.pack('<Q', value))
+EOF
@@ -540,10 +540,9 @@ def async_message_statement(receiver, message):
             dispatch_function_args.insert(0, 'connection')
 
     result = []
-    result.append('    if (decoder.messageName() == Messages::%s::%s::name()) {\n' % (receiver.name, message.name))
+    result.append('    case IPC::MessageName::%s_%s:\n' % (receiver.name, message.name))
     result.append('        IPC::%s<Messages::%s::%s>(%s);\n' % (dispatch_function, receiver.name, message.name, ', '.join(dispatch_function_args)))
     result.append('        return;\n')
-    result.append('    }\n')
     return surround_in_condition(''.join(result), message.condition)
 
 
@@ -559,13 +558,25 @@ def sync_message_statement(receiver, message):
     wants_connection = message.has_attribute(SYNCHRONOUS_ATTRIBUTE) or message.has_attribute(WANTS_CONNECTION_ATTRIBUTE)
 
     result = []
-    result.append('    if (decoder.messageName() == Messages::%s::%s::name()) {\n' % (receiver.name, message.name))
+    result.append('    case IPC::MessageName::%s_%s:\n' % (receiver.name, message.name))
     result.append('        IPC::%s<Messages::%s::%s>(%sdecoder, %sreplyEncoder, this, &%s);\n' % (dispatch_function, receiver.name, message.name, 'connection, ' if wants_connection else '', '' if message.has_attribute(SYNCHRONOUS_ATTRIBUTE) or message.has_attribute(ASYNC_ATTRIBUTE) else '*', handler_function(receiver, message)))
     result.append('        return;\n')
-    result.append('    }\n')
     return surround_in_condition(''.join(result), message.condition)
 
 
+def message_switch_statement(statements):
+    # The MessageName enumerators of a receiver are contiguous, so the compiler can lower this to a jump table
+    # instead of comparing against every message name in turn.
+    if not statements:
+        return []
+    result = ['    switch (decoder.messageName()) {\n']
+    result += statements
+    result.append('    default:\n')
+    result.append('        break;\n')
+    result.append('    }\n')
+    return result
+
+
 def class_template_headers(template_string):
     template_string = template_string.strip()
 
@@ -909,7 +920,7 @@ def generate_message_handler(receiver):
         if not receiver.has_attribute(NOT_REFCOUNTED_RECEIVER_ATTRIBUTE):
             result.append('    auto protectedThis = makeRef(*this);\n')
 
-        result += [async_message_statement(receiver, message) for message in async_messages]
+        result += message_switch_statement([async_message_statement(receiver, message) for message in async_messages])
         if receiver.has_attribute(WANTS_DISPATCH_MESSAGE_ATTRIBUTE) or receiver.has_attribute(WANTS_ASYNC_DISPATCH_MESSAGE_ATTRIBUTE):
             result.append('    if (dispatchMessage(connection, decoder))\n')
             result.append('        return;\n')
@@ -927,7 +938,7 @@ def generate_message_handler(receiver):
         result.append('{\n')
         if not receiver.has_attribute(NOT_REFCOUNTED_RECEIVER_ATTRIBUTE):
             result.append('    auto protectedThis = makeRef(*this);\n')
-        result += [sync_message_statement(receiver, message) for message in sync_messages]
+        result += message_switch_statement([sync_message_statement(receiver, message) for message in sync_messages])
         if receiver.has_attribute(WANTS_DISPATCH_MESSAGE_ATTRIBUTE):
             result.append('    if (dispatchSyncMessage(connection, decoder, replyEncoder))\n')
             result.append('        return;\n')
@@ -25,6 +25,7 @@
 # cd Source/WebKit/Scripts && python -m webkit.messages_unittest
 # cd Source/WebKit/Scripts && python -m unittest discover -p '*_unittest.py'
 
+import io
 import os
 import re
 import sys
@@ -99,6 +100,27 @@ class GeneratedFileContentsTest(unittest.TestCase):
         implementation_contents = messages.generate_message_argument_description_implementation(self.receivers, receiver_header_files)
         self.assertGeneratedFileContentsEqual(implementation_contents, os.path.join(tests_directory, 'MessageArgumentDescriptions.cpp'))
 
+
+class MessageDispatchTest(unittest.TestCase):
+    def generate_handler(self, message_count):
+        lines = ['messages -> LargeReceiver {']
+        for index in range(message_count):
+            lines.append('    AsyncMessage%d(uint64_t value)' % index)
+            lines.append('    SyncMessage%d(uint64_t value) -> (bool result) Synchronous' % index)
+        lines.append('}')
+        receiver = parser.parse(io.StringIO('\n'.join(lines) + '\n'))
+        return messages.generate_message_handler(receiver)
+
+    def test_dispatch_is_a_single_switch(self):
+        # Dispatching a message must not cost a comparison per message declared before it.
+        message_count = 500
+        handler = self.generate_handler(message_count)
+        self.assertNotIn('decoder.messageName() ==', handler)
+        self.assertEqual(handler.count('switch (decoder.messageName()) {'), 2)
+        self.assertEqual(handler.count('    case IPC::MessageName::LargeReceiver_AsyncMessage'), message_count)
+        self.assertEqual(handler.count('    case IPC::MessageName::LargeReceiver_SyncMessage'), message_count)
+
+
 def add_reset_results_to_unittest_help():
     script_name = os.path.basename(__file__)
     reset_results_help = '''
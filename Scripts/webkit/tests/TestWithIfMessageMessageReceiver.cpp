@@ -40,18 +40,20 @@ namespace WebKit {
 void TestWithIfMessage::didReceiveMessage(IPC::Connection& connection, IPC::Decoder& decoder)
 {
     auto protectedThis = makeRef(*this);
+    switch (decoder.messageName()) {
 #if PLATFORM(COCOA)
-    if (decoder.messageName() == Messages::TestWithIfMessage::LoadURL::name()) {
+    case IPC::MessageName::TestWithIfMessage_LoadURL:
         IPC::handleMessage<Messages::TestWithIfMessage::LoadURL>(decoder, this, &TestWithIfMessage::loadURL);
         return;
-    }
 #endif
 #if PLATFORM(GTK)
-    if (decoder.messageName() == Messages::TestWithIfMessage::LoadURL::name()) {
+    case IPC::MessageName::TestWithIfMessage_LoadURL:
         IPC::handleMessage<Messages::TestWithIfMessage::LoadURL>(decoder, this, &TestWithIfMessage::loadURL);
         return;
-    }
 #endif
+    default:
+        break;
+    }
     UNUSED_PARAM(connection);
     UNUSED_PARAM(decoder);
     ASSERT_NOT_REACHED();
@@ -83,84 +83,72 @@ namespace WebKit {
 void TestWithLegacyReceiver::didReceiveTestWithLegacyReceiverMessage(IPC::Connection& connection, IPC::Decoder& decoder)
 {
     auto protectedThis = makeRef(*this);
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::LoadURL::name()) {
+    switch (decoder.messageName()) {
+    case IPC::MessageName::TestWithLegacyReceiver_LoadURL:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::LoadURL>(decoder, this, &TestWithLegacyReceiver::loadURL);
         return;
-    }
 #if ENABLE(TOUCH_EVENTS)
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::LoadSomething::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_LoadSomething:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::LoadSomething>(decoder, this, &TestWithLegacyReceiver::loadSomething);
         return;
-    }
 #endif
 #if (ENABLE(TOUCH_EVENTS) && (NESTED_MESSAGE_CONDITION || SOME_OTHER_MESSAGE_CONDITION))
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::TouchEvent::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_TouchEvent:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::TouchEvent>(decoder, this, &TestWithLegacyReceiver::touchEvent);
         return;
-    }
 #endif
 #if (ENABLE(TOUCH_EVENTS) && (NESTED_MESSAGE_CONDITION && SOME_OTHER_MESSAGE_CONDITION))
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::AddEvent::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_AddEvent:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::AddEvent>(decoder, this, &TestWithLegacyReceiver::addEvent);
         return;
-    }
 #endif
 #if ENABLE(TOUCH_EVENTS)
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::LoadSomethingElse::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_LoadSomethingElse:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::LoadSomethingElse>(decoder, this, &TestWithLegacyReceiver::loadSomethingElse);
         return;
-    }
 #endif
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::DidReceivePolicyDecision::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_DidReceivePolicyDecision:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::DidReceivePolicyDecision>(decoder, this, &TestWithLegacyReceiver::didReceivePolicyDecision);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::Close::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_Close:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::Close>(decoder, this, &TestWithLegacyReceiver::close);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::PreferencesDidChange::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_PreferencesDidChange:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::PreferencesDidChange>(decoder, this, &TestWithLegacyReceiver::preferencesDidChange);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::SendDoubleAndFloat::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_SendDoubleAndFloat:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::SendDoubleAndFloat>(decoder, this, &TestWithLegacyReceiver::sendDoubleAndFloat);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::SendInts::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_SendInts:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::SendInts>(decoder, this, &TestWithLegacyReceiver::sendInts);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::TestParameterAttributes::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_TestParameterAttributes:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::TestParameterAttributes>(decoder, this, &TestWithLegacyReceiver::testParameterAttributes);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::TemplateTest::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_TemplateTest:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::TemplateTest>(decoder, this, &TestWithLegacyReceiver::templateTest);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::SetVideoLayerID::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_SetVideoLayerID:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::SetVideoLayerID>(decoder, this, &TestWithLegacyReceiver::setVideoLayerID);
         return;
-    }
 #if PLATFORM(MAC)
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::DidCreateWebProcessConnection::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_DidCreateWebProcessConnection:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::DidCreateWebProcessConnection>(decoder, this, &TestWithLegacyReceiver::didCreateWebProcessConnection);
         return;
-    }
 #endif
 #if ENABLE(DEPRECATED_FEATURE)
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::DeprecatedOperation::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_DeprecatedOperation:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::DeprecatedOperation>(decoder, this, &TestWithLegacyReceiver::deprecatedOperation);
         return;
-    }
 #endif
 #if ENABLE(EXPERIMENTAL_FEATURE)
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::ExperimentalOperation::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_ExperimentalOperation:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::ExperimentalOperation>(decoder, this, &TestWithLegacyReceiver::experimentalOperation);
         return;
-    }
 #endif
+    default:
+        break;
+    }
     UNUSED_PARAM(connection);
     UNUSED_PARAM(decoder);
     ASSERT_NOT_REACHED();
@@ -169,32 +157,30 @@ void TestWithLegacyReceiver::didReceiveTestWithLegacyReceiverMessage(IPC::Connec
 void TestWithLegacyReceiver::didReceiveSyncTestWithLegacyReceiverMessage(IPC::Connection& connection, IPC::Decoder& decoder, std::unique_ptr<IPC::Encoder>& replyEncoder)
 {
     auto protectedThis = makeRef(*this);
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::CreatePlugin::name()) {
+    switch (decoder.messageName()) {
+    case IPC::MessageName::TestWithLegacyReceiver_CreatePlugin:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::CreatePlugin>(decoder, *replyEncoder, this, &TestWithLegacyReceiver::createPlugin);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::RunJavaScriptAlert::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_RunJavaScriptAlert:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::RunJavaScriptAlert>(decoder, *replyEncoder, this, &TestWithLegacyReceiver::runJavaScriptAlert);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::GetPlugins::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_GetPlugins:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::GetPlugins>(decoder, *replyEncoder, this, &TestWithLegacyReceiver::getPlugins);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::GetPluginProcessConnection::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_GetPluginProcessConnection:
         IPC::handleMessageSynchronous<Messages::TestWithLegacyReceiver::GetPluginProcessConnection>(connection, decoder, replyEncoder, this, &TestWithLegacyReceiver::getPluginProcessConnection);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::TestMultipleAttributes::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_TestMultipleAttributes:
         IPC::handleMessageSynchronousWantsConnection<Messages::TestWithLegacyReceiver::TestMultipleAttributes>(connection, decoder, replyEncoder, this, &TestWithLegacyReceiver::testMultipleAttributes);
         return;
-    }
 #if PLATFORM(MAC)
-    if (decoder.messageName() == Messages::TestWithLegacyReceiver::InterpretKeyEvent::name()) {
+    case IPC::MessageName::TestWithLegacyReceiver_InterpretKeyEvent:
         IPC::handleMessage<Messages::TestWithLegacyReceiver::InterpretKeyEvent>(decoder, *replyEncoder, this, &TestWithLegacyReceiver::interpretKeyEvent);
         return;
-    }
 #endif
+    default:
+        break;
+    }
     UNUSED_PARAM(connection);
     UNUSED_PARAM(decoder);
     UNUSED_PARAM(replyEncoder);
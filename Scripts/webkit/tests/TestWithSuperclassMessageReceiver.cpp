@@ -169,47 +169,48 @@ namespace WebKit {
 void TestWithSuperclass::didReceiveMessage(IPC::Connection& connection, IPC::Decoder& decoder)
 {
     auto protectedThis = makeRef(*this);
-    if (decoder.messageName() == Messages::TestWithSuperclass::LoadURL::name()) {
+    switch (decoder.messageName()) {
+    case IPC::MessageName::TestWithSuperclass_LoadURL:
         IPC::handleMessage<Messages::TestWithSuperclass::LoadURL>(decoder, this, &TestWithSuperclass::loadURL);
         return;
-    }
 #if ENABLE(TEST_FEATURE)
-    if (decoder.messageName() == Messages::TestWithSuperclass::TestAsyncMessage::name()) {
+    case IPC::MessageName::TestWithSuperclass_TestAsyncMessage:
         IPC::handleMessageAsync<Messages::TestWithSuperclass::TestAsyncMessage>(connection, decoder, this, &TestWithSuperclass::testAsyncMessage);
         return;
-    }
 #endif
 #if ENABLE(TEST_FEATURE)
-    if (decoder.messageName() == Messages::TestWithSuperclass::TestAsyncMessageWithNoArguments::name()) {
+    case IPC::MessageName::TestWithSuperclass_TestAsyncMessageWithNoArguments:
         IPC::handleMessageAsync<Messages::TestWithSuperclass::TestAsyncMessageWithNoArguments>(connection, decoder, this, &TestWithSuperclass::testAsyncMessageWithNoArguments);
         return;
-    }
 #endif
 #if ENABLE(TEST_FEATURE)
-    if (decoder.messageName() == Messages::TestWithSuperclass::TestAsyncMessageWithMultipleArguments::name()) {
+    case IPC::MessageName::TestWithSuperclass_TestAsyncMessageWithMultipleArguments:
         IPC::handleMessageAsync<Messages::TestWithSuperclass::TestAsyncMessageWithMultipleArguments>(connection, decoder, this, &TestWithSuperclass::testAsyncMessageWithMultipleArguments);
         return;
-    }
 #endif
 #if ENABLE(TEST_FEATURE)
-    if (decoder.messageName() == Messages::TestWithSuperclass::TestAsyncMessageWithConnection::name()) {
+    case IPC::MessageName::TestWithSuperclass_TestAsyncMessageWithConnection:
         IPC::handleMessageAsyncWantsConnection<Messages::TestWithSuperclass::TestAsyncMessageWithConnection>(connection, decoder, this, &TestWithSuperclass::testAsyncMessageWithConnection);
         return;
-    }
 #endif
+    default:
+        break;
+    }
     WebPageBase::didReceiveMessage(connection, decoder);
 }
 
 void TestWithSuperclass::didReceiveSyncMessage(IPC::Connection& connection, IPC::Decoder& decoder, std::unique_ptr<IPC::Encoder>& replyEncoder)
 {
     auto protectedThis = makeRef(*this);
-    if (decoder.messageName() == Messages::TestWithSuperclass::TestSyncMessage::name()) {
+    switch (decoder.messageName()) {
+    case IPC::MessageName::TestWithSuperclass_TestSyncMessage:
         IPC::handleMessageSynchronous<Messages::TestWithSuperclass::TestSyncMessage>(connection, decoder, replyEncoder, this, &TestWithSuperclass::testSyncMessage);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithSuperclass::TestSynchronousMessage::name()) {
+    case IPC::MessageName::TestWithSuperclass_TestSynchronousMessage:
         IPC::handleMessageSynchronous<Messages::TestWithSuperclass::TestSynchronousMessage>(connection, decoder, replyEncoder, this, &TestWithSuperclass::testSynchronousMessage);
         return;
+    default:
+        break;
     }
     UNUSED_PARAM(connection);
     UNUSED_PARAM(decoder);
@@ -83,84 +83,72 @@ namespace WebKit {
 void TestWithoutAttributes::didReceiveMessage(IPC::Connection& connection, IPC::Decoder& decoder)
 {
     auto protectedThis = makeRef(*this);
-    if (decoder.messageName() == Messages::TestWithoutAttributes::LoadURL::name()) {
+    switch (decoder.messageName()) {
+    case IPC::MessageName::TestWithoutAttributes_LoadURL:
         IPC::handleMessage<Messages::TestWithoutAttributes::LoadURL>(decoder, this, &TestWithoutAttributes::loadURL);
         return;
-    }
 #if ENABLE(TOUCH_EVENTS)
-    if (decoder.messageName() == Messages::TestWithoutAttributes::LoadSomething::name()) {
+    case IPC::MessageName::TestWithoutAttributes_LoadSomething:
         IPC::handleMessage<Messages::TestWithoutAttributes::LoadSomething>(decoder, this, &TestWithoutAttributes::loadSomething);
         return;
-    }
 #endif
 #if (ENABLE(TOUCH_EVENTS) && (NESTED_MESSAGE_CONDITION || SOME_OTHER_MESSAGE_CONDITION))
-    if (decoder.messageName() == Messages::TestWithoutAttributes::TouchEvent::name()) {
+    case IPC::MessageName::TestWithoutAttributes_TouchEvent:
         IPC::handleMessage<Messages::TestWithoutAttributes::TouchEvent>(decoder, this, &TestWithoutAttributes::touchEvent);
         return;
-    }
 #endif
 #if (ENABLE(TOUCH_EVENTS) && (NESTED_MESSAGE_CONDITION && SOME_OTHER_MESSAGE_CONDITION))
-    if (decoder.messageName() == Messages::TestWithoutAttributes::AddEvent::name()) {
+    case IPC::MessageName::TestWithoutAttributes_AddEvent:
         IPC::handleMessage<Messages::TestWithoutAttributes::AddEvent>(decoder, this, &TestWithoutAttributes::addEvent);
         return;
-    }
 #endif
 #if ENABLE(TOUCH_EVENTS)
-    if (decoder.messageName() == Messages::TestWithoutAttributes::LoadSomethingElse::name()) {
+    case IPC::MessageName::TestWithoutAttributes_LoadSomethingElse:
         IPC::handleMessage<Messages::TestWithoutAttributes::LoadSomethingElse>(decoder, this, &TestWithoutAttributes::loadSomethingElse);
         return;
-    }
 #endif
-    if (decoder.messageName() == Messages::TestWithoutAttributes::DidReceivePolicyDecision::name()) {
+    case IPC::MessageName::TestWithoutAttributes_DidReceivePolicyDecision:
         IPC::handleMessage<Messages::TestWithoutAttributes::DidReceivePolicyDecision>(decoder, this, &TestWithoutAttributes::didReceivePolicyDecision);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::Close::name()) {
+    case IPC::MessageName::TestWithoutAttributes_Close:
         IPC::handleMessage<Messages::TestWithoutAttributes::Close>(decoder, this, &TestWithoutAttributes::close);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::PreferencesDidChange::name()) {
+    case IPC::MessageName::TestWithoutAttributes_PreferencesDidChange:
         IPC::handleMessage<Messages::TestWithoutAttributes::PreferencesDidChange>(decoder, this, &TestWithoutAttributes::preferencesDidChange);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::SendDoubleAndFloat::name()) {
+    case IPC::MessageName::TestWithoutAttributes_SendDoubleAndFloat:
         IPC::handleMessage<Messages::TestWithoutAttributes::SendDoubleAndFloat>(decoder, this, &TestWithoutAttributes::sendDoubleAndFloat);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::SendInts::name()) {
+    case IPC::MessageName::TestWithoutAttributes_SendInts:
         IPC::handleMessage<Messages::TestWithoutAttributes::SendInts>(decoder, this, &TestWithoutAttributes::sendInts);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::TestParameterAttributes::name()) {
+    case IPC::MessageName::TestWithoutAttributes_TestParameterAttributes:
         IPC::handleMessage<Messages::TestWithoutAttributes::TestParameterAttributes>(decoder, this, &TestWithoutAttributes::testParameterAttributes);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::TemplateTest::name()) {
+    case IPC::MessageName::TestWithoutAttributes_TemplateTest:
         IPC::handleMessage<Messages::TestWithoutAttributes::TemplateTest>(decoder, this, &TestWithoutAttributes::templateTest);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::SetVideoLayerID::name()) {
+    case IPC::MessageName::TestWithoutAttributes_SetVideoLayerID:
         IPC::handleMessage<Messages::TestWithoutAttributes::SetVideoLayerID>(decoder, this, &TestWithoutAttributes::setVideoLayerID);
         return;
-    }
 #if PLATFORM(MAC)
-    if (decoder.messageName() == Messages::TestWithoutAttributes::DidCreateWebProcessConnection::name()) {
+    case IPC::MessageName::TestWithoutAttributes_DidCreateWebProcessConnection:
         IPC::handleMessage<Messages::TestWithoutAttributes::DidCreateWebProcessConnection>(decoder, this, &TestWithoutAttributes::didCreateWebProcessConnection);
         return;
-    }
 #endif
 #if ENABLE(DEPRECATED_FEATURE)
-    if (decoder.messageName() == Messages::TestWithoutAttributes::DeprecatedOperation::name()) {
+    case IPC::MessageName::TestWithoutAttributes_DeprecatedOperation:
         IPC::handleMessage<Messages::TestWithoutAttributes::DeprecatedOperation>(decoder, this, &TestWithoutAttributes::deprecatedOperation);
         return;
-    }
 #endif
 #if ENABLE(EXPERIMENTAL_FEATURE)
-    if (decoder.messageName() == Messages::TestWithoutAttributes::ExperimentalOperation::name()) {
+    case IPC::MessageName::TestWithoutAttributes_ExperimentalOperation:
         IPC::handleMessage<Messages::TestWithoutAttributes::ExperimentalOperation>(decoder, this, &TestWithoutAttributes::experimentalOperation);
         return;
-    }
 #endif
+    default:
+        break;
+    }
     UNUSED_PARAM(connection);
     UNUSED_PARAM(decoder);
     ASSERT_NOT_REACHED();
@@ -169,32 +157,30 @@ void TestWithoutAttributes::didReceiveMessage(IPC::Connection& connection, IPC::
 void TestWithoutAttributes::didReceiveSyncMessage(IPC::Connection& connection, IPC::Decoder& decoder, std::unique_ptr<IPC::Encoder>& replyEncoder)
 {
     auto protectedThis = makeRef(*this);
-    if (decoder.messageName() == Messages::TestWithoutAttributes::CreatePlugin::name()) {
+    switch (decoder.messageName()) {
+    case IPC::MessageName::TestWithoutAttributes_CreatePlugin:
         IPC::handleMessage<Messages::TestWithoutAttributes::CreatePlugin>(decoder, *replyEncoder, this, &TestWithoutAttributes::createPlugin);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::RunJavaScriptAlert::name()) {
+    case IPC::MessageName::TestWithoutAttributes_RunJavaScriptAlert:
         IPC::handleMessage<Messages::TestWithoutAttributes::RunJavaScriptAlert>(decoder, *replyEncoder, this, &TestWithoutAttributes::runJavaScriptAlert);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::GetPlugins::name()) {
+    case IPC::MessageName::TestWithoutAttributes_GetPlugins:
         IPC::handleMessage<Messages::TestWithoutAttributes::GetPlugins>(decoder, *replyEncoder, this, &TestWithoutAttributes::getPlugins);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::GetPluginProcessConnection::name()) {
+    case IPC::MessageName::TestWithoutAttributes_GetPluginProcessConnection:
         IPC::handleMessageSynchronous<Messages::TestWithoutAttributes::GetPluginProcessConnection>(connection, decoder, replyEncoder, this, &TestWithoutAttributes::getPluginProcessConnection);
         return;
-    }
-    if (decoder.messageName() == Messages::TestWithoutAttributes::TestMultipleAttributes::name()) {
+    case IPC::MessageName::TestWithoutAttributes_TestMultipleAttributes:
         IPC::handleMessageSynchronousWantsConnection<Messages::TestWithoutAttributes::TestMultipleAttributes>(connection, decoder, replyEncoder, this, &TestWithoutAttributes::testMultipleAttributes);
         return;
-    }
 #if PLATFORM(MAC)
-    if (decoder.messageName() == Messages::TestWithoutAttributes::InterpretKeyEvent::name()) {
+    case IPC::MessageName::TestWithoutAttributes_InterpretKeyEvent:
         IPC::handleMessage<Messages::TestWithoutAttributes::InterpretKeyEvent>(decoder, *replyEncoder, this, &TestWithoutAttributes::interpretKeyEvent);
         return;
-    }
 #endif
+    default:
+        break;
+    }
     UNUSED_PARAM(connection);
     UNUSED_PARAM(decoder);
     UNUSED_PARAM(replyEncoder);
@@ -31,6 +31,10 @@
 #include "WebKit2Initialize.h"
 #include <wtf/RunLoop.h>
 
+#if (PLATFORM(GTK) || PLATFORM(WPE)) && OS(LINUX)
+#include "ProcessZygote.h"
+#endif
+
 namespace WebKit {
 
 class AuxiliaryProcessMainBase {
@@ -54,6 +58,11 @@ void initializeAuxiliaryProcess(AuxiliaryProcessInitializationParameters&& param
 template<typename AuxiliaryProcessType, typename AuxiliaryProcessMainType>
 int AuxiliaryProcessMain(int argc, char** argv)
 {
+#if (PLATFORM(GTK) || PLATFORM(WPE)) && OS(LINUX)
+    // In zygote mode this only returns in forked children, before anything process-specific is set up.
+    ProcessZygote::runIfRequested(argc, argv);
+#endif
+
     AuxiliaryProcessMainType auxiliaryMain;
 
     if (!auxiliaryMain.platformInitialize())
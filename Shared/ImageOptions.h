@@ -42,6 +42,7 @@ enum {
     SnapshotOptionsForceWhiteText = 1 << 7,
     SnapshotOptionsPrinting = 1 << 8,
     SnapshotOptionsUseScreenColorSpace = 1 << 9,
+    SnapshotOptionsTransparentBackground = 1 << 10,
 };
 typedef uint32_t SnapshotOptions;
 
@@ -230,6 +230,7 @@ void BackForwardListItemState::encode(IPC::Encoder& encoder) const
     encoder << identifier;
     encoder << pageState;
     encoder << hasCachedPage;
+    encoder << isStub;
 }
 
 Optional<BackForwardListItemState> BackForwardListItemState::decode(IPC::Decoder& decoder)
@@ -247,6 +248,9 @@ Optional<BackForwardListItemState> BackForwardListItemState::decode(IPC::Decoder
     if (!decoder.decode(result.hasCachedPage))
         return WTF::nullopt;
 
+    if (!decoder.decode(result.isStub))
+        return WTF::nullopt;
+
     return result;
 }
 
@@ -135,6 +135,10 @@ struct BackForwardListItemState {
     RefPtr<ViewSnapshot> snapshot;
 #endif
     bool hasCachedPage { false };
+
+    // Stubs only carry the identifier, URL and title of the item. The web process
+    // asks for the full state when the item is navigated to.
+    bool isStub { false };
 };
 
 struct BackForwardListState {
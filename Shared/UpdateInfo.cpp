@@ -42,6 +42,7 @@ void UpdateInfo::encode(IPC::Encoder& encoder) const
     encoder << updateRects;
     encoder << updateScaleFactor;
     encoder << bitmapHandle;
+    encoder << bitmapSlot;
     encoder << bitmapOffset;
 }
 
@@ -63,6 +64,10 @@ bool UpdateInfo::decode(IPC::Decoder& decoder, UpdateInfo& result)
         return false;
     if (!decoder.decode(result.bitmapHandle))
         return false;
+    if (!decoder.decode(result.bitmapSlot))
+        return false;
+    if (result.bitmapSlot && *result.bitmapSlot >= bitmapSlotCount)
+        return false;
     if (!decoder.decode(result.bitmapOffset))
         return false;
 
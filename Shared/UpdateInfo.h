@@ -67,9 +67,17 @@ public:
     // The page scale factor used to render this update.
     float updateScaleFactor;
 
-    // The handle of the shareable bitmap containing the updates. Will be null if there are no updates.
+    // The handle of the shareable bitmap containing the updates. Will be null if there are no updates,
+    // or if the updates were painted into a ring bitmap that the UI process has already mapped.
     ShareableBitmap::Handle bitmapHandle;
 
+    // The number of persistent bitmaps the web process paints updates into.
+    static constexpr uint32_t bitmapSlotCount = 3;
+
+    // The slot of the web process's update bitmap ring that holds the updates, if any. The UI process must
+    // send DrawingArea::ReleaseUpdateBitmapSlot once it is done with it so the slot can be painted into again.
+    Optional<uint32_t> bitmapSlot;
+
     // The offset in the bitmap where the rendered contents are.
     WebCore::IntPoint bitmapOffset;
 };
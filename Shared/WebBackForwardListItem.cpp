@@ -26,6 +26,9 @@
 #include "config.h"
 #include "WebBackForwardListItem.h"
 
+#include "Decoder.h"
+#include "Encoder.h"
+#include "MessageNames.h"
 #include "SuspendedPageProxy.h"
 #include "WebBackForwardCache.h"
 #include "WebBackForwardCacheEntry.h"
@@ -70,6 +73,87 @@ WebBackForwardListItem* WebBackForwardListItem::itemForID(const BackForwardItemI
     return allItems().get(identifier);
 }
 
+BackForwardListItemState WebBackForwardListItem::itemState() const
+{
+    if (!pageStateIsCompact())
+        return m_itemState;
+
+    // Decode into the returned copy only, so that saving the session does not inflate every cold item.
+    auto itemState = m_itemState;
+    if (auto pageState = decodePageState())
+        itemState.pageState = WTFMove(*pageState);
+    return itemState;
+}
+
+BackForwardListItemState WebBackForwardListItem::stubItemState() const
+{
+    BackForwardListItemState stubItemState;
+    stubItemState.identifier = m_itemState.identifier;
+    stubItemState.pageState.title = m_itemState.pageState.title;
+    stubItemState.pageState.mainFrameState.urlString = m_itemState.pageState.mainFrameState.urlString;
+    stubItemState.pageState.mainFrameState.originalURLString = m_itemState.pageState.mainFrameState.originalURLString;
+    stubItemState.pageState.shouldOpenExternalURLsPolicy = m_itemState.pageState.shouldOpenExternalURLsPolicy;
+    stubItemState.hasCachedPage = m_itemState.hasCachedPage;
+    stubItemState.isStub = true;
+    return stubItemState;
+}
+
+void WebBackForwardListItem::setPageState(PageState&& pageState)
+{
+    m_encodedPageState.clear();
+    m_itemState.pageState = WTFMove(pageState);
+}
+
+const PageState& WebBackForwardListItem::pageState() const
+{
+    decodePageStateIfNeeded();
+    return m_itemState.pageState;
+}
+
+void WebBackForwardListItem::compactPageState()
+{
+    if (pageStateIsCompact())
+        return;
+
+    // FIXME: This should use WTF::Persistence::Encoder instead.
+    IPC::Encoder encoder(IPC::MessageName::LegacySessionState, 0);
+    encoder << m_itemState.pageState;
+    m_encodedPageState.append(encoder.buffer(), encoder.bufferSize());
+
+    auto& pageState = m_itemState.pageState;
+    PageState stubPageState;
+    stubPageState.title = WTFMove(pageState.title);
+    stubPageState.mainFrameState.urlString = WTFMove(pageState.mainFrameState.urlString);
+    stubPageState.mainFrameState.originalURLString = WTFMove(pageState.mainFrameState.originalURLString);
+    stubPageState.shouldOpenExternalURLsPolicy = pageState.shouldOpenExternalURLsPolicy;
+    pageState = WTFMove(stubPageState);
+}
+
+Optional<PageState> WebBackForwardListItem::decodePageState() const
+{
+    auto decoder = IPC::Decoder::create(m_encodedPageState.data(), m_encodedPageState.size(), nullptr, Vector<IPC::Attachment>());
+    if (!decoder)
+        return WTF::nullopt;
+
+    PageState pageState;
+    if (!decoder->decode(pageState))
+        return WTF::nullopt;
+
+    return pageState;
+}
+
+void WebBackForwardListItem::decodePageStateIfNeeded() const
+{
+    if (!pageStateIsCompact())
+        return;
+
+    auto pageState = decodePageState();
+    ASSERT(pageState);
+    if (pageState)
+        m_itemState.pageState = WTFMove(*pageState);
+    m_encodedPageState.clear();
+}
+
 static const FrameState* childItemWithDocumentSequenceNumber(const FrameState& frameState, int64_t number)
 {
     for (const auto& child : frameState.children) {
@@ -114,8 +198,8 @@ bool WebBackForwardListItem::itemIsInSameDocument(const WebBackForwardListItem&
 
     // The following logic must be kept in sync with WebCore::HistoryItem::shouldDoSameDocumentNavigationTo().
 
-    const FrameState& mainFrameState = m_itemState.pageState.mainFrameState;
-    const FrameState& otherMainFrameState = other.m_itemState.pageState.mainFrameState;
+    const FrameState& mainFrameState = pageState().mainFrameState;
+    const FrameState& otherMainFrameState = other.pageState().mainFrameState;
 
     if (mainFrameState.stateObjectData || otherMainFrameState.stateObjectData)
         return mainFrameState.documentSequenceNumber == otherMainFrameState.documentSequenceNumber;
@@ -152,8 +236,8 @@ bool WebBackForwardListItem::itemIsClone(const WebBackForwardListItem& other)
     if (this == &other)
         return false;
 
-    const FrameState& mainFrameState = m_itemState.pageState.mainFrameState;
-    const FrameState& otherMainFrameState = other.m_itemState.pageState.mainFrameState;
+    const FrameState& mainFrameState = pageState().mainFrameState;
+    const FrameState& otherMainFrameState = other.pageState().mainFrameState;
 
     if (mainFrameState.itemSequenceNumber != otherMainFrameState.itemSequenceNumber)
         return false;
@@ -56,14 +56,19 @@ public:
     static HashMap<WebCore::BackForwardItemIdentifier, WebBackForwardListItem*>& allItems();
 
     const WebCore::BackForwardItemIdentifier& itemID() const { return m_itemState.identifier; }
-    const BackForwardListItemState& itemState() { return m_itemState; }
+    BackForwardListItemState itemState() const;
+    BackForwardListItemState stubItemState() const;
     WebPageProxyIdentifier pageID() const { return m_pageID; }
 
     WebCore::ProcessIdentifier lastProcessIdentifier() const { return m_lastProcessIdentifier; }
     void setLastProcessIdentifier(const WebCore::ProcessIdentifier& identifier) { m_lastProcessIdentifier = identifier; }
 
-    void setPageState(PageState&& pageState) { m_itemState.pageState = WTFMove(pageState); }
-    const PageState& pageState() const { return m_itemState.pageState; }
+    void setPageState(PageState&&);
+    const PageState& pageState() const;
+
+    // Keeps only the URL and title of the page state around and stores the rest encoded until it is needed.
+    void compactPageState();
+    bool pageStateIsCompact() const { return !m_encodedPageState.isEmpty(); }
 
     const String& originalURL() const { return m_itemState.pageState.mainFrameState.originalURLString; }
     const String& url() const { return m_itemState.pageState.mainFrameState.urlString; }
@@ -98,7 +103,12 @@ private:
     friend class WebBackForwardCache;
     void setBackForwardCacheEntry(std::unique_ptr<WebBackForwardCacheEntry>&&);
 
-    BackForwardListItemState m_itemState;
+    Optional<PageState> decodePageState() const;
+    void decodePageStateIfNeeded() const;
+
+    // Mutable so that a compacted page state can be decoded on demand by the const accessors.
+    mutable BackForwardListItemState m_itemState;
+    mutable Vector<uint8_t> m_encodedPageState;
     URL m_resourceDirectoryURL;
     WebPageProxyIdentifier m_pageID;
     WebCore::ProcessIdentifier m_lastProcessIdentifier;
@@ -76,6 +76,122 @@ void WebPreferencesStore::removeTestRunnerOverrides()
     boolTestRunnerOverridesMap().clear();
 }
 
+Vector<WebPreferencesKey::Index> WebPreferencesStore::testRunnerOverriddenKeys()
+{
+    Vector<WebPreferencesKey::Index> keys;
+    for (auto& key : boolTestRunnerOverridesMap().keys()) {
+        if (auto index = WebPreferencesKey::indexForKey(key))
+            keys.append(*index);
+    }
+    return keys;
+}
+
+static void encodeChanges(IPC::Encoder& encoder, const Vector<WebPreferencesStore::Delta::Change>& changes)
+{
+    encoder << static_cast<uint64_t>(changes.size());
+    for (auto& change : changes) {
+        encoder << static_cast<uint16_t>(change.first);
+        encoder << change.second;
+    }
+}
+
+static Optional<Vector<WebPreferencesStore::Delta::Change>> decodeChanges(IPC::Decoder& decoder)
+{
+    Optional<uint64_t> size;
+    decoder >> size;
+    if (!size || *size > WebPreferencesKey::count)
+        return WTF::nullopt;
+
+    Vector<WebPreferencesStore::Delta::Change> changes;
+    changes.reserveInitialCapacity(*size);
+    for (uint64_t i = 0; i < *size; ++i) {
+        Optional<uint16_t> index;
+        decoder >> index;
+        if (!index || *index >= WebPreferencesKey::count)
+            return WTF::nullopt;
+
+        Optional<Optional<WebPreferencesStore::Value>> value;
+        decoder >> value;
+        if (!value)
+            return WTF::nullopt;
+
+        changes.uncheckedAppend({ static_cast<WebPreferencesKey::Index>(*index), WTFMove(*value) });
+    }
+    return changes;
+}
+
+void WebPreferencesStore::Delta::encode(IPC::Encoder& encoder) const
+{
+    encodeChanges(encoder, values);
+    encodeChanges(encoder, overriddenDefaults);
+}
+
+Optional<WebPreferencesStore::Delta> WebPreferencesStore::Delta::decode(IPC::Decoder& decoder)
+{
+    auto values = decodeChanges(decoder);
+    if (!values)
+        return WTF::nullopt;
+
+    auto overriddenDefaults = decodeChanges(decoder);
+    if (!overriddenDefaults)
+        return WTF::nullopt;
+
+    return Delta { WTFMove(*values), WTFMove(*overriddenDefaults) };
+}
+
+static bool appendChanges(const WebPreferencesStore::ValueMap& current, const WebPreferencesStore::ValueMap& previous, Vector<WebPreferencesStore::Delta::Change>& changes)
+{
+    for (auto& entry : current) {
+        auto it = previous.find(entry.key);
+        if (it != previous.end() && it->value == entry.value)
+            continue;
+        auto index = WebPreferencesKey::indexForKey(entry.key);
+        if (!index)
+            return false;
+        changes.append({ *index, entry.value });
+    }
+
+    for (auto& key : previous.keys()) {
+        if (current.contains(key))
+            continue;
+        auto index = WebPreferencesKey::indexForKey(key);
+        if (!index)
+            return false;
+        changes.append({ *index, WTF::nullopt });
+    }
+    return true;
+}
+
+Optional<WebPreferencesStore::Delta> WebPreferencesStore::deltaFrom(const WebPreferencesStore& previous) const
+{
+    Delta delta;
+    if (!appendChanges(m_values, previous.m_values, delta.values))
+        return WTF::nullopt;
+    if (!appendChanges(m_overriddenDefaults, previous.m_overriddenDefaults, delta.overriddenDefaults))
+        return WTF::nullopt;
+    return delta;
+}
+
+static void applyChanges(WebPreferencesStore::ValueMap& map, const Vector<WebPreferencesStore::Delta::Change>& changes, Vector<WebPreferencesKey::Index>& changedKeys)
+{
+    for (auto& change : changes) {
+        auto& key = WebPreferencesKey::keyForIndex(change.first);
+        if (change.second)
+            map.set(key, *change.second);
+        else
+            map.remove(key);
+        changedKeys.append(change.first);
+    }
+}
+
+Vector<WebPreferencesKey::Index> WebPreferencesStore::applyDelta(const Delta& delta)
+{
+    Vector<WebPreferencesKey::Index> changedKeys;
+    applyChanges(m_values, delta.values, changedKeys);
+    applyChanges(m_overriddenDefaults, delta.overriddenDefaults, changedKeys);
+    return changedKeys;
+}
+
 template<typename MappedType>
 static MappedType valueForKey(const WebPreferencesStore::ValueMap& values, const WebPreferencesStore::ValueMap& overriddenDefaults, const String& key)
 {
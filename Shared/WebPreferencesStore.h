@@ -27,7 +27,9 @@
 
 #include "Decoder.h"
 #include "Encoder.h"
+#include "WebPreferencesKeys.h"
 #include <wtf/HashMap.h>
+#include <wtf/Vector.h>
 #include <wtf/text/StringHash.h>
 #include <wtf/text/WTFString.h>
 
@@ -63,9 +65,27 @@ struct WebPreferencesStore {
     // For WebKitTestRunner usage.
     static void overrideBoolValueForKey(const String& key, bool value);
     static void removeTestRunnerOverrides();
+    static Vector<WebPreferencesKey::Index> testRunnerOverriddenKeys();
 
     using Value = Variant<String, bool, uint32_t, double>;
 
+    // The keys whose values differ between two stores, identified by index. A null value means the key was removed.
+    struct Delta {
+        using Change = std::pair<WebPreferencesKey::Index, Optional<Value>>;
+        Vector<Change> values;
+        Vector<Change> overriddenDefaults;
+
+        bool isEmpty() const { return values.isEmpty() && overriddenDefaults.isEmpty(); }
+
+        void encode(IPC::Encoder&) const;
+        static Optional<Delta> decode(IPC::Decoder&);
+    };
+
+    // Returns WTF::nullopt if either store holds a key that has no index, in which case the whole store must be sent.
+    Optional<Delta> deltaFrom(const WebPreferencesStore& previous) const;
+    // Returns the indices of the keys touched by the delta.
+    Vector<WebPreferencesKey::Index> applyDelta(const Delta&);
+
     typedef HashMap<String, Value> ValueMap;
     ValueMap m_values;
     ValueMap m_overriddenDefaults;
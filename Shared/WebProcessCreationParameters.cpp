@@ -79,6 +79,7 @@ void WebProcessCreationParameters::encode(IPC::Encoder& encoder) const
     encoder << shouldAlwaysUseComplexTextCodePath;
     encoder << shouldEnableMemoryPressureReliefLogging;
     encoder << shouldSuppressMemoryPressureHandler;
+    encoder << coalescesTouchMovesWithinDisplayFrame;
     encoder << shouldUseFontSmoothing;
     encoder << fontAllowList;
     encoder << terminationTimeout;
@@ -290,6 +291,8 @@ bool WebProcessCreationParameters::decode(IPC::Decoder& decoder, WebProcessCreat
         return false;
     if (!decoder.decode(parameters.shouldSuppressMemoryPressureHandler))
         return false;
+    if (!decoder.decode(parameters.coalescesTouchMovesWithinDisplayFrame))
+        return false;
     if (!decoder.decode(parameters.shouldUseFontSmoothing))
         return false;
     if (!decoder.decode(parameters.fontAllowList))
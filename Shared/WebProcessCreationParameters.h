@@ -118,6 +118,7 @@ struct WebProcessCreationParameters {
     bool shouldAlwaysUseComplexTextCodePath { false };
     bool shouldEnableMemoryPressureReliefLogging { false };
     bool shouldSuppressMemoryPressureHandler { false };
+    bool coalescesTouchMovesWithinDisplayFrame { false };
     bool shouldUseFontSmoothing { true };
     bool fullKeyboardAccessEnabled { false };
 #if HAVE(UIKIT_WITH_MOUSE_SUPPORT) && PLATFORM(IOS)
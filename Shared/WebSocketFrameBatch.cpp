@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WebSocketFrameBatch.h"
+
+#include "ArgumentCoders.h"
+#include "Decoder.h"
+#include "Encoder.h"
+#include <wtf/CheckedArithmetic.h>
+
+namespace WebKit {
+
+void WebSocketFrameBatch::append(FrameType type, const uint8_t* data, size_t length)
+{
+    m_frames.append({ type, length });
+    m_data.append(data, length);
+}
+
+void WebSocketFrameBatch::clear()
+{
+    m_frames.clear();
+    m_data.clear();
+}
+
+void WebSocketFrameBatch::encode(IPC::Encoder& encoder) const
+{
+    encoder << static_cast<uint64_t>(m_frames.size());
+    for (auto& frame : m_frames) {
+        encoder << frame.type;
+        encoder << frame.length;
+    }
+    encoder << m_data;
+}
+
+Optional<WebSocketFrameBatch> WebSocketFrameBatch::decode(IPC::Decoder& decoder)
+{
+    Optional<uint64_t> frameCount;
+    decoder >> frameCount;
+    if (!frameCount)
+        return WTF::nullopt;
+
+    WebSocketFrameBatch batch;
+    Checked<uint64_t, RecordOverflow> totalLength = 0;
+    for (uint64_t i = 0; i < *frameCount; ++i) {
+        Optional<FrameType> type;
+        decoder >> type;
+        if (!type)
+            return WTF::nullopt;
+
+        Optional<uint64_t> length;
+        decoder >> length;
+        if (!length)
+            return WTF::nullopt;
+
+        totalLength += *length;
+        if (totalLength.hasOverflowed())
+            return WTF::nullopt;
+
+        batch.m_frames.append({ *type, *length });
+    }
+
+    Optional<Vector<uint8_t>> data;
+    decoder >> data;
+    if (!data || data->size() != totalLength.unsafeGet())
+        return WTF::nullopt;
+
+    batch.m_data = WTFMove(*data);
+    return batch;
+}
+
+} // namespace WebKit
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <wtf/Forward.h>
+#include <wtf/Vector.h>
+
+namespace IPC {
+class Decoder;
+class Encoder;
+}
+
+namespace WebKit {
+
+// Small WebSocket messages queued in the same run loop iteration, sent over IPC as a single message.
+// Text frames are stored as UTF-8, all payloads are concatenated into one buffer.
+class WebSocketFrameBatch {
+public:
+    enum class FrameType : bool { Text, Binary };
+
+    // Messages at least this large are handed off through shared memory instead of being batched.
+    static constexpr size_t largeFrameThreshold = 64 * 1024;
+    // Pending batches are flushed early once they grow past this size.
+    static constexpr size_t maximumByteLength = 256 * 1024;
+
+    void append(FrameType, const uint8_t* data, size_t length);
+    void clear();
+
+    bool isEmpty() const { return m_frames.isEmpty(); }
+    size_t frameCount() const { return m_frames.size(); }
+    size_t byteLength() const { return m_data.size(); }
+
+    template<typename Function> void forEachFrame(Function&& function) const
+    {
+        size_t offset = 0;
+        for (auto& frame : m_frames) {
+            function(frame.type, m_data.data() + offset, frame.length);
+            offset += frame.length;
+        }
+    }
+
+    void encode(IPC::Encoder&) const;
+    static Optional<WebSocketFrameBatch> decode(IPC::Decoder&);
+
+private:
+    struct Frame {
+        FrameType type;
+        uint64_t length;
+    };
+
+    Vector<Frame> m_frames;
+    Vector<uint8_t> m_data;
+};
+
+} // namespace WebKit
@@ -36,6 +36,9 @@ namespace WebKit {
 // Represents the number of wheel events we can hold in the queue before we start pushing them preemptively.
 constexpr unsigned wheelEventQueueSizeThreshold = 10;
 
+// Used until the refresh rate of the display the view is on is known.
+constexpr Seconds defaultDisplayFrameInterval = 1_s / 60;
+
 #if !LOG_DISABLED
 static WTF::TextStream& operator<<(WTF::TextStream& ts, const WebWheelEvent& wheelEvent)
 {
@@ -44,6 +47,27 @@ static WTF::TextStream& operator<<(WTF::TextStream& ts, const WebWheelEvent& whe
 }
 #endif
 
+WebWheelEventCoalescer::WebWheelEventCoalescer(Function<void()>&& queuedEventsReadyCallback)
+    : m_displayFrameInterval(defaultDisplayFrameInterval)
+    , m_queuedEventsReadyCallback(WTFMove(queuedEventsReadyCallback))
+    , m_nextFrameTimer(RunLoop::main(), this, &WebWheelEventCoalescer::nextFrameTimerFired)
+{
+}
+
+// Events beginning or ending a scrolling gesture or its momentum are never held until the end of the frame.
+static bool isPhaseTransition(const WebWheelEvent& event)
+{
+#if PLATFORM(COCOA) || PLATFORM(GTK) || USE(LIBWPE)
+    auto isContinuing = [](WebWheelEvent::Phase phase) {
+        return phase == WebWheelEvent::Phase::PhaseNone || phase == WebWheelEvent::Phase::PhaseChanged;
+    };
+    return !isContinuing(event.phase()) || !isContinuing(event.momentumPhase());
+#else
+    UNUSED_PARAM(event);
+    return false;
+#endif
+}
+
 bool WebWheelEventCoalescer::canCoalesce(const WebWheelEvent& a, const WebWheelEvent& b)
 {
     if (a.position() != b.position())
@@ -106,20 +130,49 @@ bool WebWheelEventCoalescer::shouldDispatchEventNow(const WebWheelEvent& event)
     return m_wheelEventQueue.size() >= wheelEventQueueSizeThreshold;
 }
 
+bool WebWheelEventCoalescer::shouldWaitForNextFrame(MonotonicTime now) const
+{
+    if (m_coalescingPolicy != CoalescingPolicy::WithinDisplayFrame)
+        return false;
+
+    for (auto& queuedEvent : m_wheelEventQueue) {
+        if (isPhaseTransition(queuedEvent.event))
+            return false;
+    }
+
+    // There is no display refresh callback in the UI process, so frames are measured from the previous dispatch.
+    return now < m_lastDispatchTime + m_displayFrameInterval;
+}
+
+void WebWheelEventCoalescer::nextFrameTimerFired()
+{
+    m_queuedEventsReadyCallback();
+}
+
 Optional<WebWheelEvent> WebWheelEventCoalescer::nextEventToDispatch()
 {
     if (m_wheelEventQueue.isEmpty())
         return WTF::nullopt;
 
-    auto coalescedEvent = m_wheelEventQueue.takeFirst();
+    auto now = MonotonicTime::now();
+    if (shouldWaitForNextFrame(now)) {
+        if (!m_nextFrameTimer.isActive())
+            m_nextFrameTimer.startOneShot(m_lastDispatchTime + m_displayFrameInterval - now);
+        LOG_WITH_STREAM(WheelEvents, stream << "WebWheelEventCoalescer::nextEventToDispatch - " << m_wheelEventQueue.size() << " events held until the next frame");
+        return WTF::nullopt;
+    }
+    m_nextFrameTimer.stop();
+
+    auto oldestReceivedTime = m_wheelEventQueue.first().receivedTime;
+    auto coalescedEvent = m_wheelEventQueue.takeFirst().event;
 
     auto coalescedSequence = makeUnique<CoalescedEventSequence>();
     coalescedSequence->append(coalescedEvent);
 
     WebWheelEvent coalescedWebEvent = coalescedEvent;
 
-    while (!m_wheelEventQueue.isEmpty() && canCoalesce(coalescedWebEvent, m_wheelEventQueue.first())) {
-        auto firstEvent = m_wheelEventQueue.takeFirst();
+    while (!m_wheelEventQueue.isEmpty() && canCoalesce(coalescedWebEvent, m_wheelEventQueue.first().event)) {
+        auto firstEvent = m_wheelEventQueue.takeFirst().event;
         coalescedSequence->append(firstEvent);
         coalescedWebEvent = coalesce(coalescedWebEvent, firstEvent);
     }
@@ -129,6 +182,14 @@ Optional<WebWheelEvent> WebWheelEventCoalescer::nextEventToDispatch()
         LOG_WITH_STREAM(WheelEvents, stream << "WebWheelEventCoalescer::wheelEventWithCoalescing coalsesced " << *coalescedSequence << " into " << coalescedWebEvent);
 #endif
 
+    auto latency = now - oldestReceivedTime;
+    m_lastDispatchTime = now;
+    m_dispatchLatency.receivedEventCount += coalescedSequence->size();
+    m_dispatchLatency.dispatchedEventCount++;
+    m_dispatchLatency.totalLatency += latency;
+    m_dispatchLatency.maximumLatency = std::max(m_dispatchLatency.maximumLatency, latency);
+    LOG_WITH_STREAM(WheelEvents, stream << "WebWheelEventCoalescer::nextEventToDispatch - dispatching " << coalescedSequence->size() << " events after " << latency.milliseconds() << "ms (average " << m_dispatchLatency.averageLatency().milliseconds() << "ms, maximum " << m_dispatchLatency.maximumLatency.milliseconds() << "ms)");
+
     m_eventsBeingProcessed.append(WTFMove(coalescedSequence));
     return coalescedWebEvent;
 }
@@ -137,10 +198,10 @@ bool WebWheelEventCoalescer::shouldDispatchEvent(const NativeWebWheelEvent& even
 {
     LOG_WITH_STREAM(WheelEvents, stream << "WebWheelEventCoalescer::shouldDispatchEvent " << event << " (" << m_wheelEventQueue.size() << " events in the queue, " << m_eventsBeingProcessed.size() << " event sequences being processed)");
 
-    m_wheelEventQueue.append(event);
+    m_wheelEventQueue.append(QueuedEvent { event, MonotonicTime::now() });
 
     if (!m_eventsBeingProcessed.isEmpty()) {
-        if (!shouldDispatchEventNow(m_wheelEventQueue.last())) {
+        if (!shouldDispatchEventNow(m_wheelEventQueue.last().event)) {
             LOG_WITH_STREAM(WheelEvents, stream << "WebWheelEventCoalescer::shouldDispatchEvent -  " << m_wheelEventQueue.size() << " events queued; not dispatching");
             return false;
         }
@@ -151,15 +212,16 @@ bool WebWheelEventCoalescer::shouldDispatchEvent(const NativeWebWheelEvent& even
     return true;
 }
 
-NativeWebWheelEvent WebWheelEventCoalescer::takeOldestEventBeingProcessed()
+auto WebWheelEventCoalescer::takeOldestEventSequenceBeingProcessed() -> CoalescedEventSequence
 {
     ASSERT(hasEventsBeingProcessed());
     auto oldestSequence = m_eventsBeingProcessed.takeFirst();
-    return oldestSequence->last();
+    return WTFMove(*oldestSequence);
 }
 
 void WebWheelEventCoalescer::clear()
 {
+    m_nextFrameTimer.stop();
     m_wheelEventQueue.clear();
     m_eventsBeingProcessed.clear();
 }
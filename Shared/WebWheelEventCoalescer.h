@@ -28,32 +28,78 @@
 #include "NativeWebWheelEvent.h"
 #include <wtf/Deque.h>
 #include <wtf/FastMalloc.h>
+#include <wtf/Function.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/RunLoop.h>
 
 namespace WebKit {
 
 class WebWheelEventCoalescer {
     WTF_MAKE_FAST_ALLOCATED;
 public:
+    enum class CoalescingPolicy : bool {
+        // Events are coalesced while the previously dispatched one is being processed.
+        WhileEventIsBeingProcessed,
+        // Additionally, at most one event is dispatched per display frame, the ones received in
+        // between are coalesced and dispatched when the frame ends.
+        WithinDisplayFrame
+    };
+
+    // The callback is invoked when events held until the end of a frame can be dispatched with nextEventToDispatch().
+    explicit WebWheelEventCoalescer(Function<void()>&& queuedEventsReadyCallback);
+
+    void setCoalescingPolicy(CoalescingPolicy policy) { m_coalescingPolicy = policy; }
+    // Events are held until this long after the previous dispatch with the WithinDisplayFrame policy.
+    void setDisplayFrameInterval(Seconds interval) { m_displayFrameInterval = interval; }
+
     // If this returns true, use nextEventToDispatch() to get the event to dispatch.
     bool shouldDispatchEvent(const NativeWebWheelEvent&);
+    // Returns nothing when the queued events are held until the end of the frame.
     Optional<WebWheelEvent> nextEventToDispatch();
-    
-    NativeWebWheelEvent takeOldestEventBeingProcessed();
+
+    // The events that were coalesced into the oldest dispatched event, in the order they were received.
+    using CoalescedEventSequence = Vector<NativeWebWheelEvent>;
+    CoalescedEventSequence takeOldestEventSequenceBeingProcessed();
 
     bool hasEventsBeingProcessed() const { return !m_eventsBeingProcessed.isEmpty(); }
-    
+    bool hasQueuedEvents() const { return !m_wheelEventQueue.isEmpty(); }
+
+    // Time between receiving the oldest event of a coalesced sequence and dispatching the sequence.
+    struct DispatchLatency {
+        unsigned receivedEventCount { 0 };
+        unsigned dispatchedEventCount { 0 };
+        Seconds totalLatency;
+        Seconds maximumLatency;
+
+        Seconds averageLatency() const { return dispatchedEventCount ? totalLatency / dispatchedEventCount : 0_s; }
+    };
+    // Returns the latency of the events dispatched since the previous call.
+    DispatchLatency takeDispatchLatency() { return std::exchange(m_dispatchLatency, { }); }
+
     void clear();
 
 private:
-    using CoalescedEventSequence = Vector<NativeWebWheelEvent>;
+    struct QueuedEvent {
+        NativeWebWheelEvent event;
+        MonotonicTime receivedTime;
+    };
 
     static bool canCoalesce(const WebWheelEvent&, const WebWheelEvent&);
     static WebWheelEvent coalesce(const WebWheelEvent&, const WebWheelEvent&);
 
     bool shouldDispatchEventNow(const WebWheelEvent&) const;
+    bool shouldWaitForNextFrame(MonotonicTime now) const;
+    void nextFrameTimerFired();
 
-    Deque<NativeWebWheelEvent, 2> m_wheelEventQueue;
+    Deque<QueuedEvent, 2> m_wheelEventQueue;
     Deque<std::unique_ptr<CoalescedEventSequence>> m_eventsBeingProcessed;
+
+    CoalescingPolicy m_coalescingPolicy { CoalescingPolicy::WhileEventIsBeingProcessed };
+    Seconds m_displayFrameInterval;
+    Function<void()> m_queuedEventsReadyCallback;
+    RunLoop::Timer<WebWheelEventCoalescer> m_nextFrameTimer;
+    MonotonicTime m_lastDispatchTime;
+    DispatchLatency m_dispatchLatency;
 };
 
 } // namespace WebKit
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ProcessZygote.h"
+
+#if OS(LINUX)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <gio/gio.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <unistd.h>
+#include <wtf/HashMap.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Seconds.h>
+#include <wtf/UniStdExtras.h>
+#include <wtf/glib/GRefPtr.h>
+#include <wtf/glib/GUniquePtr.h>
+#include <wtf/text/StringHash.h>
+
+namespace WebKit {
+
+static const char zygoteArgument[] = "--zygote";
+
+// The zygote only has to fork to answer; if it takes longer than this, spawning directly is faster.
+static const Seconds zygoteReplyTimeout { 1_s };
+
+struct ZygoteLaunchRequest {
+    uint64_t processIdentifier;
+    uint8_t configureJSCForTesting;
+};
+
+static ssize_t sendWithFileDescriptor(int socket, const void* data, size_t size, int fileDescriptor)
+{
+    struct iovec iov = { const_cast<void*>(data), size };
+    union {
+        struct cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    struct cmsghdr* controlMessage = CMSG_FIRSTHDR(&message);
+    controlMessage->cmsg_level = SOL_SOCKET;
+    controlMessage->cmsg_type = SCM_RIGHTS;
+    controlMessage->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(controlMessage), &fileDescriptor, sizeof(int));
+
+    ssize_t result;
+    do {
+        result = sendmsg(socket, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (result == -1 && errno == EINTR);
+    return result;
+}
+
+static ssize_t receiveWithFileDescriptor(int socket, void* data, size_t size, int& fileDescriptor)
+{
+    struct iovec iov = { data, size };
+    union {
+        struct cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    ssize_t result;
+    do {
+        result = recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+    } while (result == -1 && errno == EINTR);
+
+    fileDescriptor = -1;
+    if (result <= 0)
+        return result;
+
+    struct cmsghdr* controlMessage = CMSG_FIRSTHDR(&message);
+    if (controlMessage && controlMessage->cmsg_level == SOL_SOCKET && controlMessage->cmsg_type == SCM_RIGHTS && controlMessage->cmsg_len == CMSG_LEN(sizeof(int)))
+        memcpy(&fileDescriptor, CMSG_DATA(controlMessage), sizeof(int));
+    return result;
+}
+
+ProcessZygote::ProcessZygote(int controlSocket, Vector<CString>&& environment)
+    : m_controlSocket(controlSocket)
+    , m_environment(WTFMove(environment))
+{
+}
+
+ProcessZygote::~ProcessZygote()
+{
+    // The zygote exits when it sees the control socket close.
+    if (m_controlSocket != -1)
+        closeWithRetry(m_controlSocket);
+}
+
+Vector<CString> ProcessZygote::currentEnvironment()
+{
+    GUniquePtr<char*> environment(g_get_environ());
+    Vector<CString> result;
+    for (char** variable = environment.get(); *variable; ++variable)
+        result.append(*variable);
+    return result;
+}
+
+ProcessZygote* ProcessZygote::forExecutable(const CString& executablePath)
+{
+    static NeverDestroyed<HashMap<String, std::unique_ptr<ProcessZygote>>> zygotes;
+
+    auto environment = currentEnvironment();
+    auto key = String::fromUTF8(executablePath.data());
+    auto addResult = zygotes.get().add(key, nullptr);
+    if (!addResult.isNewEntry) {
+        auto* zygote = addResult.iterator->value.get();
+        // A zygote that failed stays disabled. One spawned with a different environment would hand it to
+        // every child, so replace it.
+        if (!zygote || zygote->m_environment == environment)
+            return zygote;
+        addResult.iterator->value = nullptr;
+    }
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) == -1)
+        return nullptr;
+
+    GUniquePtr<gchar> socketArgument(g_strdup_printf("%d", sockets[1]));
+    char* argv[] = { const_cast<char*>(executablePath.data()), const_cast<char*>(zygoteArgument), socketArgument.get(), nullptr };
+
+    GRefPtr<GSubprocessLauncher> launcher = adoptGRef(g_subprocess_launcher_new(G_SUBPROCESS_FLAGS_NONE));
+    g_subprocess_launcher_take_fd(launcher.get(), sockets[1], sockets[1]);
+
+    GUniqueOutPtr<GError> error;
+    GRefPtr<GSubprocess> process = adoptGRef(g_subprocess_launcher_spawnv(launcher.get(), argv, &error.outPtr()));
+    if (!process) {
+        WTFLogAlways("Unable to spawn process zygote %s: %s", executablePath.data(), error->message);
+        closeWithRetry(sockets[0]);
+        return nullptr;
+    }
+
+    addResult.iterator->value = std::unique_ptr<ProcessZygote>(new ProcessZygote(sockets[0], WTFMove(environment)));
+    return addResult.iterator->value.get();
+}
+
+pid_t ProcessZygote::launch(WebCore::ProcessIdentifier processIdentifier, int connectionSocket, bool configureJSCForTesting)
+{
+    auto locker = holdLock(m_lock);
+    if (m_controlSocket == -1)
+        return 0;
+
+    ZygoteLaunchRequest request { processIdentifier.toUInt64(), configureJSCForTesting };
+    if (sendWithFileDescriptor(m_controlSocket, &request, sizeof(request), connectionSocket) == sizeof(request)) {
+        struct pollfd pollfd = { m_controlSocket, POLLIN, 0 };
+        int pollResult;
+        do {
+            pollResult = poll(&pollfd, 1, zygoteReplyTimeout.millisecondsAs<int>());
+        } while (pollResult == -1 && errno == EINTR);
+
+        if (pollResult > 0 && (pollfd.revents & POLLIN)) {
+            pid_t pid = 0;
+            ssize_t bytesRead;
+            do {
+                bytesRead = read(m_controlSocket, &pid, sizeof(pid));
+            } while (bytesRead == -1 && errno == EINTR);
+            if (bytesRead == sizeof(pid) && pid > 0)
+                return pid;
+        } else if (!pollResult)
+            WTFLogAlways("Process zygote did not answer a launch request in time, spawning processes directly");
+    }
+
+    // The zygote died, misbehaved or is stuck; stop using it and let the caller spawn the process directly.
+    closeWithRetry(m_controlSocket);
+    m_controlSocket = -1;
+    return 0;
+}
+
+void ProcessZygote::runIfRequested(int& argc, char**& argv)
+{
+    if (argc != 3 || strcmp(argv[1], zygoteArgument))
+        return;
+
+    int controlSocket = atoi(argv[2]);
+    if (!setCloseOnExec(controlSocket))
+        _exit(EXIT_FAILURE);
+
+    // Children are never waited for by the UI process, which is not their parent; let the kernel reap them.
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGCHLD, &action, nullptr);
+
+    while (true) {
+        ZygoteLaunchRequest request;
+        int connectionSocket;
+        ssize_t bytesRead = receiveWithFileDescriptor(controlSocket, &request, sizeof(request), connectionSocket);
+        if (bytesRead <= 0) {
+            // The UI process went away.
+            _exit(EXIT_SUCCESS);
+        }
+        if (bytesRead != sizeof(request) || connectionSocket == -1) {
+            if (connectionSocket != -1)
+                closeWithRetry(connectionSocket);
+            pid_t failure = -1;
+            if (write(controlSocket, &failure, sizeof(failure)) != sizeof(failure))
+                _exit(EXIT_FAILURE);
+            continue;
+        }
+
+        pid_t pid = fork();
+        if (!pid) {
+            closeWithRetry(controlSocket);
+            action.sa_handler = SIG_DFL;
+            sigaction(SIGCHLD, &action, nullptr);
+
+            // Keep the IPC socket private to this process, it must not leak into anything it spawns.
+            if (!setCloseOnExec(connectionSocket))
+                _exit(EXIT_FAILURE);
+
+            static char processIdentifierArgument[32];
+            static char connectionArgument[16];
+            static char configureJSCForTestingArgument[] = "--configure-jsc-for-testing";
+            static char* childArgv[5];
+            snprintf(processIdentifierArgument, sizeof(processIdentifierArgument), "%" PRIu64, request.processIdentifier);
+            snprintf(connectionArgument, sizeof(connectionArgument), "%d", connectionSocket);
+            argc = 0;
+            childArgv[argc++] = argv[0];
+            childArgv[argc++] = processIdentifierArgument;
+            childArgv[argc++] = connectionArgument;
+            if (request.configureJSCForTesting)
+                childArgv[argc++] = configureJSCForTestingArgument;
+            childArgv[argc] = nullptr;
+            argv = childArgv;
+            return;
+        }
+
+        closeWithRetry(connectionSocket);
+        if (write(controlSocket, &pid, sizeof(pid)) != sizeof(pid))
+            _exit(EXIT_FAILURE);
+    }
+}
+
+} // namespace WebKit
+
+#endif // OS(LINUX)
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if OS(LINUX)
+
+#include <WebCore/ProcessIdentifier.h>
+#include <sys/types.h>
+#include <wtf/Lock.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+namespace WebKit {
+
+// A zygote is a long-lived copy of an auxiliary process executable that has been linked and has run its
+// static initializers, and that forks a new child for every launch request instead of the UI process
+// spawning the executable again. Children share the zygote's pages copy-on-write.
+//
+// The zygote forks before any per-process initialization happens (display connections, threads, the
+// IPC connection), since none of those can be shared between processes; it never creates threads itself.
+//
+// Children inherit the environment the zygote was spawned with, so a zygote is only reused while the UI
+// process environment is unchanged; otherwise it is replaced by a new one spawned with the current environment.
+class ProcessZygote {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    // UI process side. Returns the zygote for the given executable, spawning it on first use or when the
+    // environment changed since it was spawned, or null if it could not be started.
+    static ProcessZygote* forExecutable(const CString& executablePath);
+
+    // Forks a child that continues as a regular auxiliary process talking over connectionSocket, and returns
+    // its pid, or 0 on failure. The caller keeps ownership of connectionSocket. This runs on the UI process
+    // main thread, so waiting for the zygote is bounded by a timeout. After a failure the zygote is no
+    // longer used and a child may still have been forked with connectionSocket, so the caller must spawn
+    // the process directly over a new socket pair.
+    pid_t launch(WebCore::ProcessIdentifier, int connectionSocket, bool configureJSCForTesting);
+
+    ~ProcessZygote();
+
+    // Auxiliary process side, called first thing from main(). If the command line asks for zygote mode,
+    // serves launch requests until the UI process goes away and never returns, except in forked children,
+    // where argc and argv are rewritten to the regular auxiliary process command line.
+    static void runIfRequested(int& argc, char**& argv);
+
+private:
+    ProcessZygote(int controlSocket, Vector<CString>&& environment);
+
+    static Vector<CString> currentEnvironment();
+
+    Lock m_lock;
+    int m_controlSocket { -1 };
+    Vector<CString> m_environment;
+};
+
+} // namespace WebKit
+
+#endif // OS(LINUX)
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SharedAudioRingBuffer.h"
+
+#if OS(LINUX)
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <wtf/MathExtras.h>
+#include <wtf/MonotonicTime.h>
+
+namespace WebKit {
+
+struct SharedAudioRingBuffer::Header {
+    // Written by the producer only.
+    alignas(64) std::atomic<uint64_t> writeFrame;
+    std::atomic<uint64_t> overrunCount;
+    std::atomic<uint64_t> wakeUpCount;
+    std::atomic<uint64_t> totalWakeUpLatencyInNanoseconds;
+    std::atomic<uint64_t> maximumWakeUpLatencyInNanoseconds;
+
+    // Written by the consumer only.
+    alignas(64) std::atomic<uint64_t> readFrame;
+    std::atomic<uint64_t> underrunCount;
+    std::atomic<uint64_t> lastRenderRequestTimeInNanoseconds;
+
+    // Futex word: number of render quanta requested by the consumer and not yet picked up by the producer.
+    alignas(64) std::atomic<uint32_t> pendingRenderRequests;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free, "Atomics in shared memory must be lock free");
+
+static int futex(std::atomic<uint32_t>& word, int operation, uint32_t value, const struct timespec* timeout = nullptr)
+{
+    // Not FUTEX_PRIVATE_FLAG, the word is shared with another process.
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), operation, value, timeout, nullptr, 0);
+}
+
+static uint64_t nowInNanoseconds()
+{
+    return static_cast<uint64_t>(MonotonicTime::now().secondsSinceEpoch().nanoseconds());
+}
+
+size_t SharedAudioRingBuffer::headerSize()
+{
+    return roundUpToMultipleOf<64>(sizeof(Header));
+}
+
+size_t SharedAudioRingBuffer::sizeForCapacity(unsigned numberOfChannels, size_t capacity)
+{
+    return headerSize() + numberOfChannels * capacity * sizeof(float);
+}
+
+RefPtr<SharedAudioRingBuffer> SharedAudioRingBuffer::allocate(unsigned numberOfChannels, size_t minimumCapacityInFrames)
+{
+    if (!numberOfChannels || !minimumCapacityInFrames)
+        return nullptr;
+
+    size_t capacity = roundUpToPowerOfTwo(minimumCapacityInFrames);
+    auto memory = SharedMemory::allocate(sizeForCapacity(numberOfChannels, capacity));
+    if (!memory)
+        return nullptr;
+
+    auto* header = new (memory->data()) Header;
+    header->writeFrame = 0;
+    header->overrunCount = 0;
+    header->wakeUpCount = 0;
+    header->totalWakeUpLatencyInNanoseconds = 0;
+    header->maximumWakeUpLatencyInNanoseconds = 0;
+    header->readFrame = 0;
+    header->underrunCount = 0;
+    header->lastRenderRequestTimeInNanoseconds = 0;
+    header->pendingRenderRequests = 0;
+    memset(static_cast<uint8_t*>(memory->data()) + headerSize(), 0, memory->size() - headerSize());
+
+    return adoptRef(*new SharedAudioRingBuffer(memory.releaseNonNull(), numberOfChannels, capacity));
+}
+
+RefPtr<SharedAudioRingBuffer> SharedAudioRingBuffer::map(const SharedMemory::Handle& handle, size_t dataSize, unsigned numberOfChannels)
+{
+    if (!numberOfChannels || dataSize < headerSize())
+        return nullptr;
+
+    auto memory = SharedMemory::map(handle, SharedMemory::Protection::ReadWrite);
+    if (!memory || memory->size() < dataSize)
+        return nullptr;
+
+    size_t capacity = (dataSize - headerSize()) / (numberOfChannels * sizeof(float));
+    if (!capacity || !hasOneBitSet(capacity) || sizeForCapacity(numberOfChannels, capacity) > dataSize)
+        return nullptr;
+
+    return adoptRef(*new SharedAudioRingBuffer(memory.releaseNonNull(), numberOfChannels, capacity));
+}
+
+SharedAudioRingBuffer::SharedAudioRingBuffer(Ref<SharedMemory>&& memory, unsigned numberOfChannels, size_t capacity)
+    : m_memory(WTFMove(memory))
+    , m_numberOfChannels(numberOfChannels)
+    , m_capacity(capacity)
+{
+}
+
+bool SharedAudioRingBuffer::createHandle(SharedMemory::Handle& handle)
+{
+    return m_memory->createHandle(handle, SharedMemory::Protection::ReadWrite);
+}
+
+auto SharedAudioRingBuffer::header() const -> Header&
+{
+    return *static_cast<Header*>(m_memory->data());
+}
+
+float* SharedAudioRingBuffer::channel(unsigned index) const
+{
+    ASSERT(index < m_numberOfChannels);
+    return reinterpret_cast<float*>(static_cast<uint8_t*>(m_memory->data()) + headerSize()) + index * m_capacity;
+}
+
+size_t SharedAudioRingBuffer::framesAvailableForWriting() const
+{
+    uint64_t writeFrame = header().writeFrame.load(std::memory_order_relaxed);
+    uint64_t readFrame = header().readFrame.load(std::memory_order_acquire);
+    uint64_t used = writeFrame - readFrame;
+    return used >= m_capacity ? 0 : m_capacity - used;
+}
+
+bool SharedAudioRingBuffer::write(const float* const* channelData, size_t numberOfFrames)
+{
+    auto& header = this->header();
+    if (numberOfFrames > framesAvailableForWriting()) {
+        header.overrunCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t writeFrame = header.writeFrame.load(std::memory_order_relaxed);
+    size_t offset = writeFrame & (m_capacity - 1);
+    size_t firstPart = std::min(numberOfFrames, m_capacity - offset);
+    for (unsigned i = 0; i < m_numberOfChannels; ++i) {
+        memcpy(channel(i) + offset, channelData[i], firstPart * sizeof(float));
+        memcpy(channel(i), channelData[i] + firstPart, (numberOfFrames - firstPart) * sizeof(float));
+    }
+
+    header.writeFrame.store(writeFrame + numberOfFrames, std::memory_order_release);
+    return true;
+}
+
+size_t SharedAudioRingBuffer::read(float* const* channelData, size_t numberOfFrames)
+{
+    auto& header = this->header();
+    uint64_t readFrame = header.readFrame.load(std::memory_order_relaxed);
+    uint64_t writeFrame = header.writeFrame.load(std::memory_order_acquire);
+
+    // The write position comes from the other process, clamp it rather than trusting it.
+    uint64_t available = writeFrame - readFrame;
+    if (writeFrame < readFrame || available > m_capacity)
+        available = 0;
+
+    size_t framesToRead = std::min<size_t>(numberOfFrames, available);
+    size_t offset = readFrame & (m_capacity - 1);
+    size_t firstPart = std::min(framesToRead, m_capacity - offset);
+    for (unsigned i = 0; i < m_numberOfChannels; ++i) {
+        memcpy(channelData[i], channel(i) + offset, firstPart * sizeof(float));
+        memcpy(channelData[i] + firstPart, channel(i), (framesToRead - firstPart) * sizeof(float));
+        memset(channelData[i] + framesToRead, 0, (numberOfFrames - framesToRead) * sizeof(float));
+    }
+
+    if (framesToRead < numberOfFrames)
+        header.underrunCount.fetch_add(1, std::memory_order_relaxed);
+
+    header.readFrame.store(readFrame + framesToRead, std::memory_order_release);
+    return framesToRead;
+}
+
+void SharedAudioRingBuffer::requestRender(unsigned numberOfQuanta)
+{
+    auto& header = this->header();
+    header.lastRenderRequestTimeInNanoseconds.store(nowInNanoseconds(), std::memory_order_relaxed);
+    if (!header.pendingRenderRequests.fetch_add(numberOfQuanta, std::memory_order_release))
+        futex(header.pendingRenderRequests, FUTEX_WAKE, 1);
+}
+
+void SharedAudioRingBuffer::wakeUpProducer()
+{
+    futex(header().pendingRenderRequests, FUTEX_WAKE, 1);
+}
+
+bool SharedAudioRingBuffer::waitForRenderRequest(Seconds timeout)
+{
+    auto& header = this->header();
+    auto pending = header.pendingRenderRequests.load(std::memory_order_acquire);
+    if (!pending) {
+        struct timespec timespec;
+        timespec.tv_sec = static_cast<time_t>(timeout.seconds());
+        timespec.tv_nsec = static_cast<long>((timeout - Seconds(timespec.tv_sec)).nanoseconds());
+        // Spurious and shutdown wake-ups are reported as no request, callers re-check their state and wait again.
+        futex(header.pendingRenderRequests, FUTEX_WAIT, 0, &timespec);
+        pending = header.pendingRenderRequests.load(std::memory_order_acquire);
+        if (!pending)
+            return false;
+
+        auto requestTime = header.lastRenderRequestTimeInNanoseconds.load(std::memory_order_relaxed);
+        auto now = nowInNanoseconds();
+        if (requestTime && now > requestTime) {
+            auto latency = now - requestTime;
+            header.wakeUpCount.fetch_add(1, std::memory_order_relaxed);
+            header.totalWakeUpLatencyInNanoseconds.fetch_add(latency, std::memory_order_relaxed);
+            if (latency > header.maximumWakeUpLatencyInNanoseconds.load(std::memory_order_relaxed))
+                header.maximumWakeUpLatencyInNanoseconds.store(latency, std::memory_order_relaxed);
+        }
+    }
+
+    while (pending && !header.pendingRenderRequests.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel)) { }
+    return !!pending;
+}
+
+auto SharedAudioRingBuffer::statistics() const -> Statistics
+{
+    auto& header = this->header();
+    Statistics statistics;
+    statistics.underrunCount = header.underrunCount.load(std::memory_order_relaxed);
+    statistics.overrunCount = header.overrunCount.load(std::memory_order_relaxed);
+    statistics.wakeUpCount = header.wakeUpCount.load(std::memory_order_relaxed);
+    if (statistics.wakeUpCount)
+        statistics.averageWakeUpLatency = Seconds::fromNanoseconds(header.totalWakeUpLatencyInNanoseconds.load(std::memory_order_relaxed) / statistics.wakeUpCount);
+    statistics.maximumWakeUpLatency = Seconds::fromNanoseconds(header.maximumWakeUpLatencyInNanoseconds.load(std::memory_order_relaxed));
+    return statistics;
+}
+
+} // namespace WebKit
+
+#endif // OS(LINUX)
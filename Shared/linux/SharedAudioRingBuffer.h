@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if OS(LINUX)
+
+#include "SharedMemory.h"
+#include <atomic>
+#include <wtf/Seconds.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+namespace WebKit {
+
+// Single-producer single-consumer ring of planar float audio samples living in shared memory.
+// The GPU process allocates it and consumes samples from its audio device callback; the
+// WebContent process audio thread produces them. Read and write positions are monotonically
+// increasing frame counters, so no locking is needed between the two sides. The consumer asks
+// the producer for more data one render quantum at a time through a futex living in the same
+// mapping, which replaces the MachSemaphore used on Cocoa ports.
+class SharedAudioRingBuffer : public ThreadSafeRefCounted<SharedAudioRingBuffer> {
+public:
+    static RefPtr<SharedAudioRingBuffer> allocate(unsigned numberOfChannels, size_t minimumCapacityInFrames);
+    static RefPtr<SharedAudioRingBuffer> map(const SharedMemory::Handle&, size_t dataSize, unsigned numberOfChannels);
+
+    bool createHandle(SharedMemory::Handle&);
+
+    unsigned numberOfChannels() const { return m_numberOfChannels; }
+    size_t capacity() const { return m_capacity; }
+    size_t size() const { return sizeForCapacity(m_numberOfChannels, m_capacity); }
+
+    // Producer side.
+    size_t framesAvailableForWriting() const;
+    bool write(const float* const* channelData, size_t numberOfFrames);
+    bool waitForRenderRequest(Seconds timeout);
+
+    // Consumer side. Missing frames are zero-filled and accounted as an underrun.
+    size_t read(float* const* channelData, size_t numberOfFrames);
+    void requestRender(unsigned numberOfQuanta = 1);
+
+    // Wakes up a producer blocked in waitForRenderRequest() without requesting any data, used on shutdown.
+    void wakeUpProducer();
+
+    struct Statistics {
+        uint64_t underrunCount { 0 };
+        uint64_t overrunCount { 0 };
+        uint64_t wakeUpCount { 0 };
+        Seconds averageWakeUpLatency;
+        Seconds maximumWakeUpLatency;
+    };
+    Statistics statistics() const;
+
+private:
+    struct Header;
+
+    SharedAudioRingBuffer(Ref<SharedMemory>&&, unsigned numberOfChannels, size_t capacity);
+
+    static size_t headerSize();
+    static size_t sizeForCapacity(unsigned numberOfChannels, size_t capacity);
+
+    Header& header() const;
+    float* channel(unsigned) const;
+
+    Ref<SharedMemory> m_memory;
+    // Never read back from the shared header: the other process may have scribbled over it.
+    unsigned m_numberOfChannels;
+    size_t m_capacity;
+};
+
+} // namespace WebKit
+
+#endif // OS(LINUX)
@@ -247,6 +247,40 @@ static Optional<MappedData> openAndMapOrCopyContentRuleList(const WTF::String& p
     return {{ WTFMove(*metaData), { WTFMove(fileData) }}};
 }
 
+// Returns the compiled rule list already stored at path if it was compiled from exactly this JSON source by
+// the current version of the compiler. Apps typically recompile the same lists on every launch, and compiling
+// a large list to DFA bytecode is far more expensive than comparing it against the source stored in the file.
+static Optional<MappedData> compiledContentRuleListIfUpToDate(const WTF::String& path, const WTF::String& json)
+{
+    if (!fileExists(path))
+        return WTF::nullopt;
+
+    auto contentRuleList = openAndMapOrCopyContentRuleList(path);
+    if (!contentRuleList)
+        return WTF::nullopt;
+
+    auto& metaData = contentRuleList->metaData;
+    if (metaData.version != ContentRuleListStore::CurrentContentRuleListFileVersion || !metaData.sourceSize || contentRuleList->data.size() != metaData.fileSize())
+        return WTF::nullopt;
+
+    const uint8_t* fileData = contentRuleList->data.data();
+    bool is8Bit = fileData[ContentRuleListFileHeaderSize];
+    if (is8Bit != json.is8Bit())
+        return WTF::nullopt;
+
+    const uint8_t* source = fileData + ContentRuleListFileHeaderSize + sizeof(bool);
+    size_t sourceLength = metaData.sourceSize - sizeof(bool);
+    if (is8Bit) {
+        if (sourceLength != json.length() * sizeof(LChar) || memcmp(source, json.characters8(), sourceLength))
+            return WTF::nullopt;
+    } else {
+        if (sourceLength != json.length() * sizeof(UChar) || memcmp(source, json.characters16(), sourceLength))
+            return WTF::nullopt;
+    }
+
+    return contentRuleList;
+}
+
 static bool writeDataToFile(const WebKit::NetworkCache::Data& fileData, PlatformFileHandle fd)
 {
     bool success = true;
@@ -506,6 +540,14 @@ void ContentRuleListStore::compileContentRuleList(const WTF::String& identifier,
     m_compileQueue->dispatch([protectedThis = makeRef(*this), identifier = identifier.isolatedCopy(), legacyFilename = m_legacyFilename, json = json.isolatedCopy(), parsedRules = parsedRules.value().isolatedCopy(), storePath = m_storePath.isolatedCopy(), completionHandler = WTFMove(completionHandler)] () mutable {
         auto path = constructedPath(storePath, identifier, legacyFilename);
 
+        if (auto existingData = compiledContentRuleListIfUpToDate(path, json)) {
+            RunLoop::main().dispatch([protectedThis = WTFMove(protectedThis), identifier = WTFMove(identifier), data = WTFMove(*existingData), completionHandler = WTFMove(completionHandler)] () mutable {
+                auto contentRuleList = createExtension(identifier, WTFMove(data));
+                completionHandler(contentRuleList.ptr(), { });
+            });
+            return;
+        }
+
         auto result = compiledToFile(WTFMove(json), WTFMove(parsedRules), path);
         if (!result.has_value()) {
             RunLoop::main().dispatch([protectedThis = WTFMove(protectedThis), error = WTFMove(result.error()), completionHandler = WTFMove(completionHandler)] () mutable {
@@ -128,6 +128,15 @@ public:
     bool processSwapsOnWindowOpenWithOpener() const { return m_processSwapsOnWindowOpenWithOpener; }
     void setProcessSwapsOnWindowOpenWithOpener(bool swaps) { m_processSwapsOnWindowOpenWithOpener = swaps; }
 
+    bool loadsBackForwardItemStatesLazily() const { return m_loadsBackForwardItemStatesLazily; }
+    void setLoadsBackForwardItemStatesLazily(bool lazily) { m_loadsBackForwardItemStatesLazily = lazily; }
+
+    bool compressesViewSnapshots() const { return m_compressesViewSnapshots; }
+    void setCompressesViewSnapshots(bool compresses) { m_compressesViewSnapshots = compresses; }
+
+    bool coalescesInputEventsWithinDisplayFrame() const { return m_coalescesInputEventsWithinDisplayFrame; }
+    void setCoalescesInputEventsWithinDisplayFrame(bool coalesces) { m_coalescesInputEventsWithinDisplayFrame = coalesces; }
+
     const WTF::String& customWebContentServiceBundleIdentifier() const { return m_customWebContentServiceBundleIdentifier; }
     void setCustomWebContentServiceBundleIdentifier(const WTF::String& customWebContentServiceBundleIdentifier) { m_customWebContentServiceBundleIdentifier = customWebContentServiceBundleIdentifier; }
 
@@ -165,6 +174,9 @@ private:
     bool m_processSwapsOnNavigationFromExperimentalFeatures { false };
     bool m_alwaysKeepAndReuseSwappedProcesses { false };
     bool m_processSwapsOnWindowOpenWithOpener { false };
+    bool m_loadsBackForwardItemStatesLazily { false };
+    bool m_compressesViewSnapshots { false };
+    bool m_coalescesInputEventsWithinDisplayFrame { false };
     Optional<bool> m_isAutomaticProcessWarmingEnabledByClient;
     bool m_usesWebProcessCache { false };
     bool m_usesBackForwardCache { true };
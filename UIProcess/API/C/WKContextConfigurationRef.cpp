@@ -205,6 +205,36 @@ void WKContextConfigurationSetProcessSwapsOnWindowOpenWithOpener(WKContextConfig
     toImpl(configuration)->setProcessSwapsOnWindowOpenWithOpener(swaps);
 }
 
+bool WKContextConfigurationLoadsBackForwardItemStatesLazily(WKContextConfigurationRef configuration)
+{
+    return toImpl(configuration)->loadsBackForwardItemStatesLazily();
+}
+
+void WKContextConfigurationSetLoadsBackForwardItemStatesLazily(WKContextConfigurationRef configuration, bool lazily)
+{
+    toImpl(configuration)->setLoadsBackForwardItemStatesLazily(lazily);
+}
+
+bool WKContextConfigurationCompressesViewSnapshots(WKContextConfigurationRef configuration)
+{
+    return toImpl(configuration)->compressesViewSnapshots();
+}
+
+void WKContextConfigurationSetCompressesViewSnapshots(WKContextConfigurationRef configuration, bool compresses)
+{
+    toImpl(configuration)->setCompressesViewSnapshots(compresses);
+}
+
+bool WKContextConfigurationCoalescesInputEventsWithinDisplayFrame(WKContextConfigurationRef configuration)
+{
+    return toImpl(configuration)->coalescesInputEventsWithinDisplayFrame();
+}
+
+void WKContextConfigurationSetCoalescesInputEventsWithinDisplayFrame(WKContextConfigurationRef configuration, bool coalesces)
+{
+    toImpl(configuration)->setCoalescesInputEventsWithinDisplayFrame(coalesces);
+}
+
 int64_t WKContextConfigurationDiskCacheSizeOverride(WKContextConfigurationRef configuration)
 {
     return 0;
@@ -90,6 +90,15 @@ WK_EXPORT void WKContextConfigurationSetAlwaysKeepAndReuseSwappedProcesses(WKCon
 WK_EXPORT bool WKContextConfigurationProcessSwapsOnWindowOpenWithOpener(WKContextConfigurationRef configuration);
 WK_EXPORT void WKContextConfigurationSetProcessSwapsOnWindowOpenWithOpener(WKContextConfigurationRef configuration, bool swaps);
 
+WK_EXPORT bool WKContextConfigurationLoadsBackForwardItemStatesLazily(WKContextConfigurationRef configuration);
+WK_EXPORT void WKContextConfigurationSetLoadsBackForwardItemStatesLazily(WKContextConfigurationRef configuration, bool lazily);
+
+WK_EXPORT bool WKContextConfigurationCompressesViewSnapshots(WKContextConfigurationRef configuration);
+WK_EXPORT void WKContextConfigurationSetCompressesViewSnapshots(WKContextConfigurationRef configuration, bool compresses);
+
+WK_EXPORT bool WKContextConfigurationCoalescesInputEventsWithinDisplayFrame(WKContextConfigurationRef configuration);
+WK_EXPORT void WKContextConfigurationSetCoalescesInputEventsWithinDisplayFrame(WKContextConfigurationRef configuration, bool coalesces);
+
 WK_EXPORT int64_t WKContextConfigurationDiskCacheSizeOverride(WKContextConfigurationRef configuration) WK_C_API_DEPRECATED;
 WK_EXPORT void WKContextConfigurationSetDiskCacheSizeOverride(WKContextConfigurationRef configuration, int64_t size) WK_C_API_DEPRECATED;
     
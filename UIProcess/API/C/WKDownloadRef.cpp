@@ -55,7 +55,7 @@ WKURLRequestRef WKDownloadCopyRequest(WKDownloadRef download)
 
 void WKDownloadCancel(WKDownloadRef download, const void* functionContext, WKDownloadCancelCallback callback)
 {
-    return toImpl(download)->cancel([functionContext, callback](auto* resumeData) {
+    return toImpl(download)->cancel(callback ? ProduceResumeData::Yes : ProduceResumeData::No, [functionContext, callback](auto* resumeData) {
         if (callback)
             callback(toAPI(resumeData), functionContext);
     });
@@ -182,7 +182,7 @@ private:
 
 - (void)cancel:(void (^)(NSData *resumeData))completionHandler
 {
-    _download->cancel([completionHandler = makeBlockPtr(completionHandler)] (auto* data) {
+    _download->cancel(completionHandler ? WebKit::ProduceResumeData::Yes : WebKit::ProduceResumeData::No, [completionHandler = makeBlockPtr(completionHandler)] (auto* data) {
         if (completionHandler)
             completionHandler(wrapper(data));
     });
@@ -1450,15 +1450,15 @@ inline OptionSet<WebKit::FindOptions> toFindOptions(WKFindConfiguration *configu
 
 - (void)createWebArchiveDataWithCompletionHandler:(void (^)(NSData *, NSError *))completionHandler
 {
-    auto handler = adoptNS([completionHandler copy]);
-
-    _page->getWebArchiveOfFrame(_page->mainFrame(), [handler](API::Data* data, WebKit::CallbackBase::Error error) {
-        void (^completionHandlerBlock)(NSData *, NSError *) = (void (^)(NSData *, NSError *))handler.get();
+    auto data = adoptNS([[NSMutableData alloc] init]);
+    _page->streamWebArchiveOfFrame(_page->mainFrame(), [data](const uint8_t* bytes, size_t length) {
+        [data appendBytes:bytes length:length];
+    }, [handler = makeBlockPtr(completionHandler), data](WebKit::CallbackBase::Error error) {
         if (error != WebKit::CallbackBase::Error::None) {
             // FIXME: Pipe a proper error in from the WebPageProxy.
-            completionHandlerBlock(nil, [NSError errorWithDomain:WKErrorDomain code:static_cast<int>(error) userInfo:nil]);
+            handler(nil, [NSError errorWithDomain:WKErrorDomain code:static_cast<int>(error) userInfo:nil]);
         } else
-            completionHandlerBlock(wrapper(*data), nil);
+            handler(data.get(), nil);
     });
 }
 
@@ -2468,11 +2468,28 @@ static inline OptionSet<WebCore::LayoutMilestone> layoutMilestones(_WKRenderingP
     [self createWebArchiveDataWithCompletionHandler:completionHandler];
 }
 
+// The text is received as UTF-8 chunks and decoded once complete.
+static void streamContentsAsString(WebKit::WebPageProxy& page, WebKit::ContentAsStringIncludesChildFrames includesChildFrames, CompletionHandler<void(NSString *, WebKit::CallbackBase::Error)>&& completionHandler)
+{
+    auto data = adoptNS([[NSMutableData alloc] init]);
+    page.streamContentsAsString(includesChildFrames, [data](const uint8_t* bytes, size_t length) {
+        [data appendBytes:bytes length:length];
+    }, [data, completionHandler = WTFMove(completionHandler)](WebKit::CallbackBase::Error error) mutable {
+        if (error != WebKit::CallbackBase::Error::None) {
+            completionHandler(nil, error);
+            return;
+        }
+
+        auto string = adoptNS([[NSString alloc] initWithData:data.get() encoding:NSUTF8StringEncoding]);
+        completionHandler(string.get(), error);
+    });
+}
+
 - (void)_getContentsAsStringWithCompletionHandler:(void (^)(NSString *, NSError *))completionHandler
 {
     auto handler = makeBlockPtr(completionHandler);
 
-    _page->getContentsAsString(WebKit::ContentAsStringIncludesChildFrames::No, [handler](String string, WebKit::CallbackBase::Error error) {
+    streamContentsAsString(*_page, WebKit::ContentAsStringIncludesChildFrames::No, [handler](NSString *string, WebKit::CallbackBase::Error error) {
         if (error != WebKit::CallbackBase::Error::None) {
             // FIXME: Pipe a proper error in from the WebPageProxy.
             handler(nil, [NSError errorWithDomain:WKErrorDomain code:static_cast<int>(error) userInfo:nil]);
@@ -2484,7 +2501,7 @@ static inline OptionSet<WebCore::LayoutMilestone> layoutMilestones(_WKRenderingP
 - (void)_getContentsOfAllFramesAsStringWithCompletionHandler:(void (^)(NSString *))completionHandler
 {
     auto handler = makeBlockPtr(completionHandler);
-    _page->getContentsAsString(WebKit::ContentAsStringIncludesChildFrames::Yes, [handler](String string, WebKit::CallbackBase::Error error) {
+    streamContentsAsString(*_page, WebKit::ContentAsStringIncludesChildFrames::Yes, [handler](NSString *string, WebKit::CallbackBase::Error error) {
         if (error != WebKit::CallbackBase::Error::None)
             handler(nil);
         else
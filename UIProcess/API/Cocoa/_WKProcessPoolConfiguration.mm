@@ -271,6 +271,16 @@
     return _processPoolConfiguration->processSwapsOnWindowOpenWithOpener();
 }
 
+- (void)setLoadsBackForwardItemStatesLazily:(BOOL)lazily
+{
+    _processPoolConfiguration->setLoadsBackForwardItemStatesLazily(lazily);
+}
+
+- (BOOL)loadsBackForwardItemStatesLazily
+{
+    return _processPoolConfiguration->loadsBackForwardItemStatesLazily();
+}
+
 - (BOOL)pageCacheEnabled
 {
     return _processPoolConfiguration->usesBackForwardCache();
@@ -112,6 +112,12 @@ private:
         webkitWebContextRemoveDownload(&downloadProxy);
     }
 
+    bool consumesResumeDataOnFailure() const override
+    {
+        // Downloads can't be resumed with the GLib API.
+        return false;
+    }
+
     void legacyDidCancel(DownloadProxy& downloadProxy) override
     {
         GRefPtr<WebKitDownload> download = webkitWebContextGetOrCreateDownload(&downloadProxy);
@@ -21,6 +21,7 @@
 #include "WebKitURISchemeRequest.h"
 
 #include "APIData.h"
+#include "SharedMemory.h"
 #include "WebKitPrivate.h"
 #include "WebKitURISchemeRequestPrivate.h"
 #include "WebKitWebContextPrivate.h"
@@ -31,7 +32,11 @@
 #include <WebCore/MIMETypeRegistry.h>
 #include <WebCore/ResourceError.h>
 #include <WebCore/URLSoup.h>
+#include <fcntl.h>
+#include <gio/gfiledescriptorbased.h>
 #include <libsoup/soup.h>
+#include <sys/stat.h>
+#include <wtf/UniStdExtras.h>
 #include <wtf/glib/GRefPtr.h>
 #include <wtf/glib/RunLoopSourcePriority.h>
 #include <wtf/glib/WTFGType.h>
@@ -56,7 +61,10 @@ using namespace WebCore;
  *
  */
 
-static const unsigned int gReadBufferSize = 8192;
+// Reads start small so that the first bytes reach the page quickly, and grow for long streams to limit the number
+// of UI process wakeups per resource.
+static const size_t gReadBufferSize = 8192;
+static const size_t gMaximumReadBufferSize = 1024 * 1024;
 
 struct _WebKitURISchemeRequestPrivate {
     WebKitWebContext* webContext;
@@ -69,7 +77,7 @@ struct _WebKitURISchemeRequestPrivate {
     GRefPtr<GInputStream> stream;
     uint64_t streamLength;
     GRefPtr<GCancellable> cancellable;
-    char readBuffer[gReadBufferSize];
+    size_t readBufferSize;
     uint64_t bytesRead;
     CString contentType;
 };
@@ -163,38 +171,94 @@ WebKitWebView* webkit_uri_scheme_request_get_web_view(WebKitURISchemeRequest* re
     return webkitWebContextGetWebViewForPage(request->priv->webContext, request->priv->initiatingPage.get());
 }
 
+static void webkitURISchemeRequestDidReceiveResponse(WebKitURISchemeRequest* request)
+{
+    WebKitURISchemeRequestPrivate* priv = request->priv;
+    ResourceResponse response(priv->task->request().url(), extractMIMETypeFromMediaType(priv->contentType.data()), priv->streamLength, emptyString());
+    response.setTextEncodingName(extractCharsetFromMediaType(priv->contentType.data()));
+    if (response.mimeType().isEmpty())
+        response.setMimeType(MIMETypeRegistry::mimeTypeForPath(response.url().path().toString()));
+    priv->task->didReceiveResponse(response);
+}
+
+static void webkitURISchemeRequestFinishWithSharedMemory(WebKitURISchemeRequest* request, RefPtr<SharedMemory>&& sharedMemory, size_t size, const char* contentType)
+{
+    WebKitURISchemeRequestPrivate* priv = request->priv;
+    priv->streamLength = size;
+    priv->contentType = contentType;
+    webkitURISchemeRequestDidReceiveResponse(request);
+    if (sharedMemory)
+        priv->task->didReceiveSharedData(sharedMemory.releaseNonNull(), size);
+    priv->task->didComplete({ });
+}
+
+#if OS(LINUX) && defined(F_GET_SEALS)
+// A memfd that can neither shrink nor be written to anymore is shared with the web process. Any other file could be
+// truncated while the web process maps it, which would crash it, or changed under it, so it is streamed instead.
+static RefPtr<SharedMemory> sealedMemoryFileForStream(GInputStream* inputStream, size_t& size)
+{
+    if (!G_IS_FILE_DESCRIPTOR_BASED(inputStream))
+        return nullptr;
+
+    int fileDescriptor = g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(inputStream));
+    int seals = fcntl(fileDescriptor, F_GET_SEALS);
+    if (seals == -1 || !(seals & F_SEAL_SHRINK))
+        return nullptr;
+#if defined(F_SEAL_FUTURE_WRITE)
+    if (!(seals & (F_SEAL_WRITE | F_SEAL_FUTURE_WRITE)))
+        return nullptr;
+#else
+    if (!(seals & F_SEAL_WRITE))
+        return nullptr;
+#endif
+
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) == -1 || fileStat.st_size <= 0 || lseek(fileDescriptor, 0, SEEK_CUR))
+        return nullptr;
+
+    // SharedMemory ignores the protection when it creates the handle for the web process, so hand it a
+    // read-only descriptor rather than a duplicate of the application's one.
+    GUniquePtr<char> procPath(g_strdup_printf("/proc/self/fd/%d", fileDescriptor));
+    int duplicatedFileDescriptor = open(procPath.get(), O_RDONLY | O_CLOEXEC);
+    if (duplicatedFileDescriptor == -1)
+        return nullptr;
+
+    size = fileStat.st_size;
+    return SharedMemory::adoptFileDescriptor(duplicatedFileDescriptor, size, SharedMemory::Protection::ReadOnly);
+}
+#endif
+
 static void webkitURISchemeRequestReadCallback(GInputStream* inputStream, GAsyncResult* result, WebKitURISchemeRequest* schemeRequest)
 {
     GRefPtr<WebKitURISchemeRequest> request = adoptGRef(schemeRequest);
     GUniqueOutPtr<GError> error;
-    gssize bytesRead = g_input_stream_read_finish(inputStream, result, &error.outPtr());
-    if (bytesRead == -1) {
+    GRefPtr<GBytes> bytes = adoptGRef(g_input_stream_read_bytes_finish(inputStream, result, &error.outPtr()));
+    if (!bytes) {
         webkit_uri_scheme_request_finish_error(request.get(), error.get());
         return;
     }
 
     WebKitURISchemeRequestPrivate* priv = request->priv;
     // Need to check the stream before proceeding as it can be cancelled if finish_error
-    // was previously call, which won't be detected by g_input_stream_read_finish().
+    // was previously call, which won't be detected by g_input_stream_read_bytes_finish().
     if (!priv->stream)
         return;
 
-    if (!priv->bytesRead) {
-        ResourceResponse response(priv->task->request().url(), extractMIMETypeFromMediaType(priv->contentType.data()), priv->streamLength, emptyString());
-        response.setTextEncodingName(extractCharsetFromMediaType(priv->contentType.data()));
-        if (response.mimeType().isEmpty())
-            response.setMimeType(MIMETypeRegistry::mimeTypeForPath(response.url().path().toString()));
-        priv->task->didReceiveResponse(response);
-    }
+    if (!priv->bytesRead)
+        webkitURISchemeRequestDidReceiveResponse(request.get());
 
+    gsize bytesRead = g_bytes_get_size(bytes.get());
     if (!bytesRead) {
         priv->task->didComplete({ });
         return;
     }
 
-    priv->task->didReceiveData(SharedBuffer::create(priv->readBuffer, bytesRead));
+    priv->task->didReceiveData(SharedBuffer::create(bytes.get()));
     priv->bytesRead += bytesRead;
-    g_input_stream_read_async(inputStream, priv->readBuffer, gReadBufferSize, RunLoopSourcePriority::AsyncIONetwork, priv->cancellable.get(),
+    // Only grow when the stream filled the previous read, a slow stream gains nothing from a larger buffer.
+    if (bytesRead == priv->readBufferSize)
+        priv->readBufferSize = std::min(priv->readBufferSize * 2, gMaximumReadBufferSize);
+    g_input_stream_read_bytes_async(inputStream, priv->readBufferSize, RunLoopSourcePriority::AsyncIONetwork, priv->cancellable.get(),
         reinterpret_cast<GAsyncReadyCallback>(webkitURISchemeRequestReadCallback), g_object_ref(request.get()));
 }
 
@@ -206,6 +270,11 @@ static void webkitURISchemeRequestReadCallback(GInputStream* inputStream, GAsync
  * @content_type: (allow-none): the content type of the stream or %NULL if not known
  *
  * Finish a #WebKitURISchemeRequest by setting the contents of the request and its mime type.
+ *
+ * If @stream is based on a memfd sealed with %F_SEAL_SHRINK and either %F_SEAL_WRITE or
+ * %F_SEAL_FUTURE_WRITE, positioned at its start, its contents are shared read-only with the web process
+ * without being read or copied. Other streams are read asynchronously in chunks that grow as the stream
+ * keeps up.
  */
 void webkit_uri_scheme_request_finish(WebKitURISchemeRequest* request, GInputStream* inputStream, gint64 streamLength, const gchar* contentType)
 {
@@ -213,16 +282,57 @@ void webkit_uri_scheme_request_finish(WebKitURISchemeRequest* request, GInputStr
     g_return_if_fail(G_IS_INPUT_STREAM(inputStream));
     g_return_if_fail(streamLength == -1 || streamLength >= 0);
 
+#if OS(LINUX) && defined(F_GET_SEALS)
+    size_t size = 0;
+    if (auto sharedMemory = sealedMemoryFileForStream(inputStream, size)) {
+        webkitURISchemeRequestFinishWithSharedMemory(request, WTFMove(sharedMemory), size, contentType);
+        return;
+    }
+#endif
+
     request->priv->stream = inputStream;
     // We use -1 in the API for consistency with soup when the content length is not known, but 0 internally.
     request->priv->streamLength = streamLength == -1 ? 0 : streamLength;
     request->priv->cancellable = adoptGRef(g_cancellable_new());
+    request->priv->readBufferSize = gReadBufferSize;
     request->priv->bytesRead = 0;
     request->priv->contentType = contentType;
-    g_input_stream_read_async(inputStream, request->priv->readBuffer, gReadBufferSize, RunLoopSourcePriority::AsyncIONetwork, request->priv->cancellable.get(),
+    g_input_stream_read_bytes_async(inputStream, request->priv->readBufferSize, RunLoopSourcePriority::AsyncIONetwork, request->priv->cancellable.get(),
         reinterpret_cast<GAsyncReadyCallback>(webkitURISchemeRequestReadCallback), g_object_ref(request));
 }
 
+/**
+ * webkit_uri_scheme_request_finish_with_bytes:
+ * @request: a #WebKitURISchemeRequest
+ * @bytes: a #GBytes with the contents of the request
+ * @content_type: (allow-none): the content type of the contents or %NULL if not known
+ *
+ * Finish a #WebKitURISchemeRequest with contents already in memory. Unlike webkit_uri_scheme_request_finish(),
+ * the contents are passed to the web process at once in shared memory instead of being streamed.
+ *
+ * Since: 2.32
+ */
+void webkit_uri_scheme_request_finish_with_bytes(WebKitURISchemeRequest* request, GBytes* bytes, const gchar* contentType)
+{
+    g_return_if_fail(WEBKIT_IS_URI_SCHEME_REQUEST(request));
+    g_return_if_fail(bytes);
+
+    gsize size;
+    const auto* data = g_bytes_get_data(bytes, &size);
+    RefPtr<SharedMemory> sharedMemory;
+    if (size) {
+        sharedMemory = SharedMemory::allocate(size);
+        if (!sharedMemory) {
+            GUniquePtr<GError> error(g_error_new_literal(G_IO_ERROR, G_IO_ERROR_NO_SPACE, "Failed to allocate shared memory"));
+            webkit_uri_scheme_request_finish_error(request, error.get());
+            return;
+        }
+        memcpy(sharedMemory->data(), data, size);
+    }
+
+    webkitURISchemeRequestFinishWithSharedMemory(request, WTFMove(sharedMemory), size, contentType);
+}
+
 /**
  * webkit_uri_scheme_request_finish_error:
  * @request: a #WebKitURISchemeRequest
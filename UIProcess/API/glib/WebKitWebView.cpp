@@ -4103,16 +4103,16 @@ gboolean webkit_web_view_can_show_mime_type(WebKitWebView* webView, const char*
 
 struct ViewSaveAsyncData {
     WTF_MAKE_STRUCT_FAST_ALLOCATED;
-    RefPtr<API::Data> webData;
+    GRefPtr<GInputStream> stream;
     GRefPtr<GFile> file;
 };
 WEBKIT_DEFINE_ASYNC_DATA_STRUCT(ViewSaveAsyncData)
 
-static void fileReplaceContentsCallback(GObject* object, GAsyncResult* result, gpointer data)
+static void outputStreamSpliceCallback(GObject* object, GAsyncResult* result, gpointer data)
 {
     GRefPtr<GTask> task = adoptGRef(G_TASK(data));
     GError* error = 0;
-    if (!g_file_replace_contents_finish(G_FILE(object), result, 0, &error)) {
+    if (g_output_stream_splice_finish(G_OUTPUT_STREAM(object), result, &error) == -1) {
         g_task_return_error(task.get(), error);
         return;
     }
@@ -4120,29 +4120,59 @@ static void fileReplaceContentsCallback(GObject* object, GAsyncResult* result, g
     g_task_return_boolean(task.get(), TRUE);
 }
 
-static void getContentsAsMHTMLDataCallback(API::Data* wkData, GTask* taskPtr)
+static void fileReplaceCallback(GObject* object, GAsyncResult* result, gpointer data)
+{
+    GRefPtr<GTask> task = adoptGRef(G_TASK(data));
+    GError* error = 0;
+    GRefPtr<GFileOutputStream> outputStream = adoptGRef(g_file_replace_finish(G_FILE(object), result, &error));
+    if (!outputStream) {
+        g_task_return_error(task.get(), error);
+        return;
+    }
+
+    ViewSaveAsyncData* saveData = static_cast<ViewSaveAsyncData*>(g_task_get_task_data(task.get()));
+    GCancellable* cancellable = g_task_get_cancellable(task.get());
+    g_output_stream_splice_async(G_OUTPUT_STREAM(outputStream.get()), saveData->stream.get(), static_cast<GOutputStreamSpliceFlags>(G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE | G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET),
+        G_PRIORITY_DEFAULT, cancellable, outputStreamSpliceCallback, task.leakRef());
+}
+
+static void didFinishContentsAsMHTMLDataStream(WebKit::CallbackBase::Error error, GTask* taskPtr)
 {
     auto task = adoptGRef(taskPtr);
     if (g_task_return_error_if_cancelled(task.get()))
         return;
 
-    ViewSaveAsyncData* data = static_cast<ViewSaveAsyncData*>(g_task_get_task_data(task.get()));
-    // We need to retain the data until the asyncronous process
-    // initiated by the user has finished completely.
-    data->webData = wkData;
+    if (error != WebKit::CallbackBase::Error::None) {
+        g_task_return_new_error(task.get(), G_IO_ERROR, G_IO_ERROR_FAILED, _("There was an error saving the web page"));
+        return;
+    }
 
     // If we are saving to a file we need to write the data on disk before finishing.
     if (g_task_get_source_tag(task.get()) == webkit_web_view_save_to_file) {
+        ViewSaveAsyncData* data = static_cast<ViewSaveAsyncData*>(g_task_get_task_data(task.get()));
         ASSERT(G_IS_FILE(data->file.get()));
         GCancellable* cancellable = g_task_get_cancellable(task.get());
-        g_file_replace_contents_async(data->file.get(), reinterpret_cast<const gchar*>(data->webData->bytes()), data->webData->size(),
-            0, FALSE, G_FILE_CREATE_REPLACE_DESTINATION, cancellable, fileReplaceContentsCallback, task.leakRef());
+        g_file_replace_async(data->file.get(), 0, FALSE, G_FILE_CREATE_REPLACE_DESTINATION, G_PRIORITY_DEFAULT, cancellable, fileReplaceCallback, task.leakRef());
         return;
     }
 
     g_task_return_boolean(task.get(), TRUE);
 }
 
+// The MHTML data is received in chunks that are queued in a memory input stream as they arrive,
+// so that it's never copied into a single buffer in the UI process.
+static void streamContentsAsMHTMLData(WebKitWebView* webView, GTask* task)
+{
+    ViewSaveAsyncData* data = static_cast<ViewSaveAsyncData*>(g_task_get_task_data(task));
+    data->stream = adoptGRef(g_memory_input_stream_new());
+    getPage(webView).streamContentsAsMHTMLData([stream = data->stream](const uint8_t* bytes, size_t length) {
+        GRefPtr<GBytes> chunk = adoptGRef(g_bytes_new(bytes, length));
+        g_memory_input_stream_add_bytes(G_MEMORY_INPUT_STREAM(stream.get()), chunk.get());
+    }, [task](WebKit::CallbackBase::Error error) {
+        didFinishContentsAsMHTMLDataStream(error, task);
+    });
+}
+
 /**
  * webkit_web_view_save:
  * @web_view: a #WebKitWebView
@@ -4169,9 +4199,7 @@ void webkit_web_view_save(WebKitWebView* webView, WebKitSaveMode saveMode, GCanc
     GTask* task = g_task_new(webView, cancellable, callback, userData);
     g_task_set_source_tag(task, reinterpret_cast<gpointer>(webkit_web_view_save));
     g_task_set_task_data(task, createViewSaveAsyncData(), reinterpret_cast<GDestroyNotify>(destroyViewSaveAsyncData));
-    getPage(webView).getContentsAsMHTMLData([task](API::Data* data, WebKit::CallbackBase::Error) {
-        getContentsAsMHTMLDataCallback(data, task);
-    });
+    streamContentsAsMHTMLData(webView, task);
 }
 
 /**
@@ -4194,13 +4222,8 @@ GInputStream* webkit_web_view_save_finish(WebKitWebView* webView, GAsyncResult*
     if (!g_task_propagate_boolean(task, error))
         return 0;
 
-    GInputStream* dataStream = g_memory_input_stream_new();
     ViewSaveAsyncData* data = static_cast<ViewSaveAsyncData*>(g_task_get_task_data(task));
-    gsize length = data->webData->size();
-    if (length)
-        g_memory_input_stream_add_data(G_MEMORY_INPUT_STREAM(dataStream), g_memdup(data->webData->bytes(), length), length, g_free);
-
-    return dataStream;
+    return G_INPUT_STREAM(g_object_ref(data->stream.get()));
 }
 
 /**
@@ -4233,10 +4256,7 @@ void webkit_web_view_save_to_file(WebKitWebView* webView, GFile* file, WebKitSav
     ViewSaveAsyncData* data = createViewSaveAsyncData();
     data->file = file;
     g_task_set_task_data(task, data, reinterpret_cast<GDestroyNotify>(destroyViewSaveAsyncData));
-
-    getPage(webView).getContentsAsMHTMLData([task](API::Data* data, WebKit::CallbackBase::Error) {
-        getContentsAsMHTMLDataCallback(data, task);
-    });
+    streamContentsAsMHTMLData(webView, task);
 }
 
 /**
@@ -4413,6 +4433,127 @@ cairo_surface_t* webkit_web_view_get_snapshot_finish(WebKitWebView* webView, GAs
 
     return static_cast<cairo_surface_t*>(g_task_propagate_pointer(G_TASK(result), error));
 }
+
+struct SnapshotTilesAsyncData {
+    WTF_MAKE_STRUCT_FAST_ALLOCATED;
+    ~SnapshotTilesAsyncData()
+    {
+        if (tileDataDestroyFunction)
+            tileDataDestroyFunction(tileData);
+    }
+
+    WebKitSnapshotTileFunc tileFunction { nullptr };
+    gpointer tileData { nullptr };
+    GDestroyNotify tileDataDestroyFunction { nullptr };
+    bool failed { false };
+};
+WEBKIT_DEFINE_ASYNC_DATA_STRUCT(SnapshotTilesAsyncData)
+
+/**
+ * webkit_web_view_get_snapshot_tiles:
+ * @web_view: a #WebKitWebView
+ * @region: the #WebKitSnapshotRegion for this snapshot
+ * @options: #WebKitSnapshotOptions for the snapshot
+ * @tile_height: the maximum height of each tile, in pixels
+ * @tile_func: (scope notified): a #WebKitSnapshotTileFunc called for every tile
+ * @tile_data: (closure tile_func): user data to pass to @tile_func
+ * @tile_data_destroy: (allow-none): destroy notifier for @tile_data
+ * @cancellable: (allow-none): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback
+ * @user_data: (closure callback): user data
+ *
+ * Asynchronously retrieves a snapshot of @web_view for @region, like
+ * webkit_web_view_get_snapshot(), as a sequence of tiles spanning the
+ * whole width of the snapshot and at most @tile_height pixels high.
+ * Only a couple of tiles exist at any time, so this can be used for
+ * snapshots of very long documents that would not fit in memory at once.
+ * The next tile is rendered while @tile_func handles the current one.
+ *
+ * When the operation is finished, @callback will be called. You must
+ * call webkit_web_view_get_snapshot_tiles_finish() to get the result of the
+ * operation.
+ *
+ * Since: 2.32
+ */
+void webkit_web_view_get_snapshot_tiles(WebKitWebView* webView, WebKitSnapshotRegion region, WebKitSnapshotOptions options, guint tileHeight, WebKitSnapshotTileFunc tileFunction, gpointer tileData, GDestroyNotify tileDataDestroyFunction, GCancellable* cancellable, GAsyncReadyCallback callback, gpointer userData)
+{
+    g_return_if_fail(WEBKIT_IS_WEB_VIEW(webView));
+    g_return_if_fail(tileHeight > 0);
+    g_return_if_fail(tileFunction);
+
+    GRefPtr<GTask> task = adoptGRef(g_task_new(webView, cancellable, callback, userData));
+    auto* data = createSnapshotTilesAsyncData();
+    data->tileFunction = tileFunction;
+    data->tileData = tileData;
+    data->tileDataDestroyFunction = tileDataDestroyFunction;
+    g_task_set_task_data(task.get(), data, reinterpret_cast<GDestroyNotify>(destroySnapshotTilesAsyncData));
+
+    SnapshotOptions snapshotOptions = webKitSnapshotOptionsToSnapshotOptions(options);
+    if (options & WEBKIT_SNAPSHOT_OPTIONS_TRANSPARENT_BACKGROUND)
+        snapshotOptions |= SnapshotOptionsTransparentBackground;
+    int maximumTileHeight = std::min<guint>(tileHeight, std::numeric_limits<int>::max());
+
+    getPage(webView).getMainFrameScrollGeometry([task = WTFMove(task), region, snapshotOptions, maximumTileHeight](const IntRect& visibleContentRect, const IntSize& contentsSize) mutable {
+        IntRect snapshotRect = region == WEBKIT_SNAPSHOT_REGION_FULL_DOCUMENT ? IntRect(IntPoint(), contentsSize) : visibleContentRect;
+        if (snapshotRect.isEmpty()) {
+            g_task_return_new_error(task.get(), WEBKIT_SNAPSHOT_ERROR, WEBKIT_SNAPSHOT_ERROR_FAILED_TO_CREATE, _("There was an error creating the snapshot"));
+            return;
+        }
+
+        auto& page = getPage(WEBKIT_WEB_VIEW(g_task_get_source_object(task.get())));
+        IntSize bitmapSize = snapshotRect.size();
+        bitmapSize.scale(page.deviceScaleFactor());
+        page.takeTiledSnapshot(snapshotRect, bitmapSize, snapshotOptions, maximumTileHeight, [task](const ShareableBitmap::Handle& handle, const IntRect& tileRect, CompletionHandler<void(bool)>&& completionHandler) {
+            if (g_cancellable_is_cancelled(g_task_get_cancellable(task.get()))) {
+                completionHandler(false);
+                return;
+            }
+
+            auto* data = static_cast<SnapshotTilesAsyncData*>(g_task_get_task_data(task.get()));
+            auto bitmap = ShareableBitmap::create(handle, SharedMemory::Protection::ReadOnly);
+            if (!bitmap) {
+                data->failed = true;
+                completionHandler(false);
+                return;
+            }
+
+            auto surface = bitmap->createCairoSurface();
+            completionHandler(data->tileFunction(WEBKIT_WEB_VIEW(g_task_get_source_object(task.get())), surface.get(), tileRect.y(), data->tileData));
+        }, [task](CallbackBase::Error error) {
+            if (g_task_return_error_if_cancelled(task.get()))
+                return;
+
+            auto* data = static_cast<SnapshotTilesAsyncData*>(g_task_get_task_data(task.get()));
+            if (error != CallbackBase::Error::None || data->failed) {
+                g_task_return_new_error(task.get(), WEBKIT_SNAPSHOT_ERROR, WEBKIT_SNAPSHOT_ERROR_FAILED_TO_CREATE, _("There was an error creating the snapshot"));
+                return;
+            }
+
+            g_task_return_boolean(task.get(), TRUE);
+        });
+    });
+}
+
+/**
+ * webkit_web_view_get_snapshot_tiles_finish:
+ * @web_view: a #WebKitWebView
+ * @result: a #GAsyncResult
+ * @error: return location for error or %NULL to ignore
+ *
+ * Finishes an asynchronous operation started with webkit_web_view_get_snapshot_tiles().
+ * Stopping the snapshot by returning %FALSE from the #WebKitSnapshotTileFunc is not an error.
+ *
+ * Returns: %TRUE if the snapshot was taken or %FALSE in case of error.
+ *
+ * Since: 2.32
+ */
+gboolean webkit_web_view_get_snapshot_tiles_finish(WebKitWebView* webView, GAsyncResult* result, GError** error)
+{
+    g_return_val_if_fail(WEBKIT_IS_WEB_VIEW(webView), FALSE);
+    g_return_val_if_fail(g_task_is_valid(result, webView), FALSE);
+
+    return g_task_propagate_boolean(G_TASK(result), error);
+}
 #endif
 
 void webkitWebViewWebProcessTerminated(WebKitWebView* webView, WebKitWebProcessTerminationReason reason)
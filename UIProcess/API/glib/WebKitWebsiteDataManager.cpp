@@ -930,6 +930,45 @@ WebKitTLSErrorsPolicy webkit_website_data_manager_get_tls_errors_policy(WebKitWe
     return manager->priv->tlsErrorsPolicy;
 }
 
+/**
+ * webkit_website_data_manager_set_download_segment_count:
+ * @manager: a #WebKitWebsiteDataManager
+ * @segment_count: the number of segments
+ *
+ * Set the maximum number of byte ranges that downloads started in @manager session
+ * are split into. Each segment is fetched over its own connection and written to
+ * its own part of the destination file. Segmentation only happens when the server
+ * supports range requests and the request carries no credentials. The default
+ * value 1 disables segmentation.
+ *
+ * Since: 2.32
+ */
+void webkit_website_data_manager_set_download_segment_count(WebKitWebsiteDataManager* manager, guint segmentCount)
+{
+    g_return_if_fail(WEBKIT_IS_WEBSITE_DATA_MANAGER(manager));
+    g_return_if_fail(segmentCount > 0);
+
+    webkitWebsiteDataManagerGetDataStore(manager).setDownloadSegmentCount(segmentCount);
+}
+
+/**
+ * webkit_website_data_manager_get_download_segment_count:
+ * @manager: a #WebKitWebsiteDataManager
+ *
+ * Get the maximum number of segments that downloads are split into.
+ * See also webkit_website_data_manager_set_download_segment_count().
+ *
+ * Returns: the number of segments
+ *
+ * Since: 2.32
+ */
+guint webkit_website_data_manager_get_download_segment_count(WebKitWebsiteDataManager* manager)
+{
+    g_return_val_if_fail(WEBKIT_IS_WEBSITE_DATA_MANAGER(manager), 1);
+
+    return webkitWebsiteDataManagerGetDataStore(manager).downloadSegmentCount();
+}
+
 /**
  * webkit_website_data_manager_set_network_proxy_settings:
  * @manager: a #WebKitWebsiteDataManager
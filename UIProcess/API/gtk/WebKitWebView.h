@@ -189,6 +189,25 @@ typedef enum {
   WEBKIT_SNAPSHOT_REGION_FULL_DOCUMENT,
 } WebKitSnapshotRegion;
 
+/**
+ * WebKitSnapshotTileFunc:
+ * @web_view: the #WebKitWebView
+ * @tile: a #cairo_surface_t with the tile, only valid during the call
+ * @y: the vertical position of the tile in the snapshot, in pixels
+ * @user_data: user data passed to webkit_web_view_get_snapshot_tiles()
+ *
+ * Type definition for a function that will be called back for every tile
+ * of a snapshot requested with webkit_web_view_get_snapshot_tiles().
+ *
+ * Returns: %TRUE to continue with the next tile or %FALSE to stop.
+ *
+ * Since: 2.32
+ */
+typedef gboolean (* WebKitSnapshotTileFunc) (WebKitWebView   *web_view,
+                                             cairo_surface_t *tile,
+                                             gint             y,
+                                             gpointer         user_data);
+
 /**
  * WebKitWebProcessTerminationReason:
  * @WEBKIT_WEB_PROCESS_CRASHED: the web process crashed.
@@ -538,6 +557,23 @@ webkit_web_view_get_snapshot_finish                  (WebKitWebView
                                                       GAsyncResult              *result,
                                                       GError                   **error);
 
+WEBKIT_API void
+webkit_web_view_get_snapshot_tiles                   (WebKitWebView             *web_view,
+                                                      WebKitSnapshotRegion       region,
+                                                      WebKitSnapshotOptions      options,
+                                                      guint                      tile_height,
+                                                      WebKitSnapshotTileFunc     tile_func,
+                                                      gpointer                   tile_data,
+                                                      GDestroyNotify             tile_data_destroy,
+                                                      GCancellable              *cancellable,
+                                                      GAsyncReadyCallback        callback,
+                                                      gpointer                   user_data);
+
+WEBKIT_API gboolean
+webkit_web_view_get_snapshot_tiles_finish            (WebKitWebView             *web_view,
+                                                      GAsyncResult              *result,
+                                                      GError                   **error);
+
 WEBKIT_API WebKitUserContentManager *
 webkit_web_view_get_user_content_manager             (WebKitWebView             *web_view);
 
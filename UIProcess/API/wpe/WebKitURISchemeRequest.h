@@ -78,6 +78,11 @@ webkit_uri_scheme_request_finish       (WebKitURISchemeRequest *request,
                                         gint64                  stream_length,
                                         const gchar            *content_type);
 
+WEBKIT_API void
+webkit_uri_scheme_request_finish_with_bytes (WebKitURISchemeRequest *request,
+                                             GBytes                 *bytes,
+                                             const gchar            *content_type);
+
 WEBKIT_API void
 webkit_uri_scheme_request_finish_error (WebKitURISchemeRequest *request,
                                         GError                 *error);
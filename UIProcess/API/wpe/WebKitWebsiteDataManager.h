@@ -142,6 +142,13 @@ webkit_website_data_manager_set_tls_errors_policy                     (WebKitWeb
 WEBKIT_API WebKitTLSErrorsPolicy
 webkit_website_data_manager_get_tls_errors_policy                     (WebKitWebsiteDataManager *manager);
 
+WEBKIT_API void
+webkit_website_data_manager_set_download_segment_count                (WebKitWebsiteDataManager *manager,
+                                                                       guint                     segment_count);
+
+WEBKIT_API guint
+webkit_website_data_manager_get_download_segment_count                (WebKitWebsiteDataManager *manager);
+
 WEBKIT_API void
 webkit_website_data_manager_set_network_proxy_settings                (WebKitWebsiteDataManager *manager,
                                                                        WebKitNetworkProxyMode    proxy_mode,
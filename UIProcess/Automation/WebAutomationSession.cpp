@@ -2210,11 +2210,12 @@ void WebAutomationSession::takeScreenshot(const Inspector::Protocol::Automation:
             if (!snapshot)
                 ASYNC_FAIL_WITH_PREDEFINED_ERROR(InternalError);
 
-            Optional<String> base64EncodedData = platformGetBase64EncodedPNGData(*snapshot);
-            if (!base64EncodedData)
-                ASYNC_FAIL_WITH_PREDEFINED_ERROR(InternalError);
+            platformGetBase64EncodedPNGData(*snapshot, [callback = WTFMove(callback)](Optional<String>&& base64EncodedData) {
+                if (!base64EncodedData)
+                    ASYNC_FAIL_WITH_PREDEFINED_ERROR(InternalError);
 
-            callback->sendSuccess(base64EncodedData.value());
+                callback->sendSuccess(base64EncodedData.value());
+            });
         });
     };
 
@@ -2233,6 +2234,23 @@ void WebAutomationSession::takeScreenshot(const Inspector::Protocol::Automation:
     };
 
     page->process().sendWithAsyncReply(Messages::WebAutomationSessionProxy::SnapshotRectForScreenshot(page->webPageID(), frameID, nodeHandle, scrollIntoViewIfNeeded, clipToViewport), WTFMove(completionHandler));
+#elif USE(CAIRO)
+    // Rendering and encoding tile by tile keeps full page screenshots of long pages from needing the whole bitmap in either process.
+    CompletionHandler<void(Optional<String>, WebCore::IntRect&&)> completionHandler = [page = makeRef(*page), callback = WTFMove(callback)](Optional<String> errorType, WebCore::IntRect&& rect) mutable {
+        if (errorType) {
+            callback->sendFailure(STRING_FOR_PREDEFINED_ERROR_MESSAGE(*errorType));
+            return;
+        }
+
+        platformGetBase64EncodedPNGDataForTiledSnapshot(page.get(), rect, [callback = WTFMove(callback)](Optional<String>&& base64EncodedData) {
+            if (!base64EncodedData)
+                ASYNC_FAIL_WITH_PREDEFINED_ERROR(ScreenshotError);
+
+            callback->sendSuccess(base64EncodedData.value());
+        });
+    };
+
+    page->process().sendWithAsyncReply(Messages::WebAutomationSessionProxy::DocumentRectForScreenshot(page->webPageID(), frameID, nodeHandle, scrollIntoViewIfNeeded, clipToViewport), WTFMove(completionHandler));
 #else
     uint64_t callbackID = m_nextScreenshotCallbackID++;
     m_screenshotCallbacks.set(callbackID, WTFMove(callback));
@@ -2252,22 +2270,30 @@ void WebAutomationSession::didTakeScreenshot(uint64_t callbackID, const Shareabl
         return;
     }
 
-    Optional<String> base64EncodedData = platformGetBase64EncodedPNGData(imageDataHandle);
-    if (!base64EncodedData)
-        ASYNC_FAIL_WITH_PREDEFINED_ERROR(InternalError);
+    platformGetBase64EncodedPNGData(imageDataHandle, [callback = WTFMove(callback)](Optional<String>&& base64EncodedData) {
+        if (!base64EncodedData)
+            ASYNC_FAIL_WITH_PREDEFINED_ERROR(InternalError);
+
+        callback->sendSuccess(base64EncodedData.value());
+    });
+}
 
-    callback->sendSuccess(base64EncodedData.value());
+WorkQueue& WebAutomationSession::screenshotEncodingQueue()
+{
+    // Full page screenshots take long to encode, keep them from blocking input dispatch and each other.
+    static auto& queue = WorkQueue::create("com.apple.WebKit.WebAutomationSession.ScreenshotEncoding", WorkQueue::Type::Concurrent, WorkQueue::QOS::UserInitiated).leakRef();
+    return queue;
 }
 
 #if !PLATFORM(COCOA) && !USE(CAIRO)
-Optional<String> WebAutomationSession::platformGetBase64EncodedPNGData(const ShareableBitmap::Handle&)
+void WebAutomationSession::platformGetBase64EncodedPNGData(const ShareableBitmap::Handle&, CompletionHandler<void(Optional<String>&&)>&& completionHandler)
 {
-    return WTF::nullopt;
+    completionHandler(WTF::nullopt);
 }
 
-Optional<String> WebAutomationSession::platformGetBase64EncodedPNGData(const ViewSnapshot&)
+void WebAutomationSession::platformGetBase64EncodedPNGData(const ViewSnapshot&, CompletionHandler<void(Optional<String>&&)>&& completionHandler)
 {
-    return WTF::nullopt;
+    completionHandler(WTF::nullopt);
 }
 #endif // !PLATFORM(COCOA) && !USE(CAIRO)
 
@@ -39,6 +39,7 @@
 #include <wtf/CompletionHandler.h>
 #include <wtf/Forward.h>
 #include <wtf/RunLoop.h>
+#include <wtf/WorkQueue.h>
 
 #if ENABLE(REMOTE_INSPECTOR)
 #include <JavaScriptCore/RemoteAutomationTarget.h>
@@ -270,9 +271,14 @@ private:
     void platformSimulateWheelInteraction(WebPageProxy&, const WebCore::IntPoint& locationInViewport, const WebCore::IntSize& delta);
 #endif // ENABLE(WEBDRIVER_WHEEL_INTERACTIONS)
 
-    // Get base64-encoded PNG data from a bitmap.
-    static Optional<String> platformGetBase64EncodedPNGData(const ShareableBitmap::Handle&);
-    static Optional<String> platformGetBase64EncodedPNGData(const ViewSnapshot&);
+    // Get base64-encoded PNG data from a bitmap. Encoding happens on screenshotEncodingQueue(), the completion handler is called on the main thread.
+    static void platformGetBase64EncodedPNGData(const ShareableBitmap::Handle&, CompletionHandler<void(Optional<String>&&)>&&);
+    static void platformGetBase64EncodedPNGData(const ViewSnapshot&, CompletionHandler<void(Optional<String>&&)>&&);
+    static WorkQueue& screenshotEncodingQueue();
+#if USE(CAIRO)
+    // Get base64-encoded PNG data from a snapshot of a rect in document coordinates, rendered and encoded tile by tile.
+    static void platformGetBase64EncodedPNGDataForTiledSnapshot(WebPageProxy&, const WebCore::IntRect&, CompletionHandler<void(Optional<String>&&)>&&);
+#endif
 
     // Save base64-encoded file contents to a local file path and return the path.
     // This reuses the basename of the remote file path so that the filename exposed to DOM API remains the same.
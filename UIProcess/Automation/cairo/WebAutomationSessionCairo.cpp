@@ -27,18 +27,237 @@
 #include "WebAutomationSession.h"
 
 #include "ViewSnapshotStore.h"
+#include "WebPageProxy.h"
 #include <WebCore/RefPtrCairo.h>
 #include <cairo/cairo.h>
+#include <wtf/NumberOfCores.h>
 #include <wtf/text/Base64.h>
+#include <zlib.h>
 
 namespace WebKit {
 using namespace WebCore;
 
+// Screenshots are encoded for speed rather than size: the fastest deflate level, a cheap filter and
+// row bands compressed in parallel, like pigz does. The result is still a single standard PNG.
+static const int pngCompressionLevel = 1;
+static const size_t minimumPNGBandSize = 256 * 1024;
+static const uint8_t pngSubFilter = 1;
+static const int screenshotTileHeight = 1024;
+
+static void appendUInt32(Vector<uint8_t>& buffer, uint32_t value)
+{
+    uint8_t bytes[] = { static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value) };
+    buffer.append(bytes, sizeof(bytes));
+}
+
+static void appendPNGChunk(Vector<uint8_t>& buffer, const char type[4], const uint8_t* data, size_t length)
+{
+    appendUInt32(buffer, length);
+    size_t typeOffset = buffer.size();
+    buffer.append(reinterpret_cast<const uint8_t*>(type), 4);
+    buffer.append(data, length);
+    appendUInt32(buffer, crc32(crc32(0, nullptr, 0), buffer.data() + typeOffset, length + 4));
+}
+
+struct PNGBand {
+    Vector<uint8_t> compressedData;
+    uLong adler32 { 0 };
+    size_t filteredSize { 0 };
+    bool failed { false };
+};
+
+static void filterPNGRows(const uint8_t* pixels, int stride, cairo_format_t format, int width, int firstRow, int lastRow, Vector<uint8_t>& filtered)
+{
+    unsigned bytesPerPixel = format == CAIRO_FORMAT_ARGB32 ? 4 : 3;
+    size_t rowSize = 1 + width * bytesPerPixel;
+    filtered.grow((lastRow - firstRow) * rowSize);
+
+    uint8_t* output = filtered.data();
+    for (int y = firstRow; y < lastRow; ++y) {
+        const auto* row = reinterpret_cast<const uint32_t*>(pixels + y * stride);
+        *output++ = pngSubFilter;
+        uint8_t previous[4] = { 0, 0, 0, 0 };
+        for (int x = 0; x < width; ++x) {
+            uint32_t pixel = row[x];
+            uint8_t alpha = format == CAIRO_FORMAT_ARGB32 ? pixel >> 24 : 255;
+            uint8_t color[4] = { static_cast<uint8_t>(pixel >> 16), static_cast<uint8_t>(pixel >> 8), static_cast<uint8_t>(pixel), alpha };
+            if (alpha && alpha != 255) {
+                for (unsigned i = 0; i < 3; ++i)
+                    color[i] = (color[i] * 255 + alpha / 2) / alpha;
+            } else if (!alpha)
+                color[0] = color[1] = color[2] = 0;
+
+            for (unsigned i = 0; i < bytesPerPixel; ++i) {
+                *output++ = color[i] - previous[i];
+                previous[i] = color[i];
+            }
+        }
+    }
+}
+
+static void compressPNGBand(const Vector<uint8_t>& filtered, bool isLastBand, PNGBand& band)
+{
+    band.adler32 = adler32(adler32(0, nullptr, 0), filtered.data(), filtered.size());
+    band.filteredSize = filtered.size();
+
+    // Raw deflate so that bands can be concatenated. All but the last band end with a sync flush,
+    // which byte aligns the output without terminating the stream.
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, pngCompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        band.failed = true;
+        return;
+    }
+
+    // deflateBound() doesn't account for the sync flush marker.
+    band.compressedData.grow(deflateBound(&stream, filtered.size()) + 6);
+    stream.next_in = const_cast<Bytef*>(filtered.data());
+    stream.avail_in = filtered.size();
+    stream.next_out = band.compressedData.data();
+    stream.avail_out = band.compressedData.size();
+    int result = deflate(&stream, isLastBand ? Z_FINISH : Z_SYNC_FLUSH);
+    if (result != (isLastBand ? Z_STREAM_END : Z_OK) || stream.avail_in)
+        band.failed = true;
+    else
+        band.compressedData.shrink(stream.total_out);
+    deflateEnd(&stream);
+}
+
+static bool canEncodePNG(cairo_surface_t* surface)
+{
+    if (cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE)
+        return false;
+
+    cairo_format_t format = cairo_image_surface_get_format(surface);
+    if (format != CAIRO_FORMAT_ARGB32 && format != CAIRO_FORMAT_RGB24)
+        return false;
+
+    return cairo_image_surface_get_width(surface) > 0 && cairo_image_surface_get_height(surface) > 0 && cairo_image_surface_get_data(surface);
+}
+
+// Compresses all the rows of the surface, which ends the image when containsLastRow is true.
+static Vector<PNGBand> compressPNGRows(cairo_surface_t* surface, bool containsLastRow)
+{
+    cairo_format_t format = cairo_image_surface_get_format(surface);
+    int width = cairo_image_surface_get_width(surface);
+    int height = cairo_image_surface_get_height(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    const uint8_t* pixels = cairo_image_surface_get_data(surface);
+
+    size_t imageSize = static_cast<size_t>(stride) * height;
+    size_t bandCount = std::max<size_t>(1, std::min<size_t>({ imageSize / minimumPNGBandSize, static_cast<size_t>(WTF::numberOfProcessorCores()), static_cast<size_t>(height) }));
+    int rowsPerBand = (height + bandCount - 1) / bandCount;
+    bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+
+    Vector<PNGBand> bands(bandCount);
+    WorkQueue::concurrentApply(bandCount, [&](size_t index) {
+        int firstRow = index * rowsPerBand;
+        int lastRow = std::min(height, firstRow + rowsPerBand);
+        Vector<uint8_t> filtered;
+        filterPNGRows(pixels, stride, format, width, firstRow, lastRow, filtered);
+        compressPNGBand(filtered, containsLastRow && index == bandCount - 1, bands[index]);
+    });
+    return bands;
+}
+
+static Optional<Vector<uint8_t>> assemblePNG(int width, int height, cairo_format_t format, const Vector<PNGBand>& bands)
+{
+    static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    Vector<uint8_t> pngData;
+    pngData.append(signature, sizeof(signature));
+
+    Vector<uint8_t> header;
+    appendUInt32(header, width);
+    appendUInt32(header, height);
+    uint8_t headerTail[] = { 8, static_cast<uint8_t>(format == CAIRO_FORMAT_ARGB32 ? 6 : 2), 0, 0, 0 };
+    header.append(headerTail, sizeof(headerTail));
+    appendPNGChunk(pngData, "IHDR", header.data(), header.size());
+
+    // The image data is a single zlib stream split across IDAT chunks: the zlib header, one chunk per band and the checksum.
+    static const uint8_t zlibHeader[] = { 0x78, 0x01 };
+    appendPNGChunk(pngData, "IDAT", zlibHeader, sizeof(zlibHeader));
+    uLong checksum = adler32(0, nullptr, 0);
+    for (auto& band : bands) {
+        if (band.failed)
+            return WTF::nullopt;
+        appendPNGChunk(pngData, "IDAT", band.compressedData.data(), band.compressedData.size());
+        checksum = adler32_combine(checksum, band.adler32, band.filteredSize);
+    }
+    Vector<uint8_t> trailer;
+    appendUInt32(trailer, static_cast<uint32_t>(checksum));
+    appendPNGChunk(pngData, "IDAT", trailer.data(), trailer.size());
+    appendPNGChunk(pngData, "IEND", nullptr, 0);
+
+    return pngData;
+}
+
+static Optional<Vector<uint8_t>> encodePNG(cairo_surface_t* surface)
+{
+    if (!canEncodePNG(surface))
+        return WTF::nullopt;
+
+    return assemblePNG(cairo_image_surface_get_width(surface), cairo_image_surface_get_height(surface), cairo_image_surface_get_format(surface), compressPNGRows(surface, true));
+}
+
+// Encodes a PNG from tiles that cover the image top to bottom, so that only the tile being encoded is kept uncompressed.
+class TiledPNGEncoder : public ThreadSafeRefCounted<TiledPNGEncoder> {
+public:
+    static Ref<TiledPNGEncoder> create(const IntSize& size)
+    {
+        return adoptRef(*new TiledPNGEncoder(size));
+    }
+
+    const IntSize& size() const { return m_size; }
+    bool isComplete() const { return m_encodedHeight == m_size.height(); }
+
+    // Tiles are encoded one at a time and in order, but not necessarily on the same thread.
+    bool encodeTile(cairo_surface_t* tile)
+    {
+        if (!canEncodePNG(tile) || cairo_image_surface_get_width(tile) != m_size.width() || m_encodedHeight + cairo_image_surface_get_height(tile) > m_size.height())
+            return false;
+
+        cairo_format_t format = cairo_image_surface_get_format(tile);
+        if (m_encodedHeight && format != m_format)
+            return false;
+
+        m_format = format;
+        m_encodedHeight += cairo_image_surface_get_height(tile);
+        m_bands.appendVector(compressPNGRows(tile, isComplete()));
+        return true;
+    }
+
+    Optional<String> base64EncodedData() const
+    {
+        if (!isComplete())
+            return WTF::nullopt;
+
+        auto pngData = assemblePNG(m_size.width(), m_size.height(), m_format, m_bands);
+        if (!pngData)
+            return WTF::nullopt;
+
+        return base64Encode(*pngData);
+    }
+
+private:
+    explicit TiledPNGEncoder(const IntSize& size)
+        : m_size(size)
+    {
+    }
+
+    IntSize m_size;
+    cairo_format_t m_format { CAIRO_FORMAT_ARGB32 };
+    int m_encodedHeight { 0 };
+    Vector<PNGBand> m_bands;
+};
+
 static Optional<String> base64EncodedPNGData(cairo_surface_t* surface)
 {
     if (!surface)
         return WTF::nullopt;
 
+    if (auto pngData = encodePNG(surface))
+        return base64Encode(*pngData);
+
     Vector<unsigned char> pngData;
     cairo_surface_write_to_png_stream(surface, [](void* userData, const unsigned char* data, unsigned length) -> cairo_status_t {
         auto* pngData = static_cast<Vector<unsigned char>*>(userData);
@@ -52,24 +271,78 @@ static Optional<String> base64EncodedPNGData(cairo_surface_t* surface)
     return base64Encode(pngData);
 }
 
-Optional<String> WebAutomationSession::platformGetBase64EncodedPNGData(const ShareableBitmap::Handle& handle)
+static void encodeSurfaceOnScreenshotEncodingQueue(WorkQueue& queue, RefPtr<cairo_surface_t>&& surface, CompletionHandler<void(Optional<String>&&)>&& completionHandler)
+{
+    if (!surface) {
+        completionHandler(WTF::nullopt);
+        return;
+    }
+
+    cairo_surface_flush(surface.get());
+    queue.dispatch([surface = WTFMove(surface), completionHandler = WTFMove(completionHandler)]() mutable {
+        auto base64EncodedData = base64EncodedPNGData(surface.get());
+        // The surface can hold a reference to the bitmap it was created from, release it on the main thread.
+        RunLoop::main().dispatch([surface = WTFMove(surface), completionHandler = WTFMove(completionHandler), base64EncodedData = WTFMove(base64EncodedData)]() mutable {
+            surface = nullptr;
+            completionHandler(WTFMove(base64EncodedData));
+        });
+    });
+}
+
+void WebAutomationSession::platformGetBase64EncodedPNGData(const ShareableBitmap::Handle& handle, CompletionHandler<void(Optional<String>&&)>&& completionHandler)
 {
     auto bitmap = ShareableBitmap::create(handle, SharedMemory::Protection::ReadOnly);
-    if (!bitmap)
-        return WTF::nullopt;
+    if (!bitmap) {
+        completionHandler(WTF::nullopt);
+        return;
+    }
 
-    auto surface = bitmap->createCairoSurface();
-    return base64EncodedPNGData(surface.get());
+    encodeSurfaceOnScreenshotEncodingQueue(screenshotEncodingQueue(), bitmap->createCairoSurface(), WTFMove(completionHandler));
 }
 
-Optional<String> WebAutomationSession::platformGetBase64EncodedPNGData(const ViewSnapshot& snapshot)
+void WebAutomationSession::platformGetBase64EncodedPNGData(const ViewSnapshot& snapshot, CompletionHandler<void(Optional<String>&&)>&& completionHandler)
 {
 #if PLATFORM(GTK)
-    return base64EncodedPNGData(snapshot.surface());
+    encodeSurfaceOnScreenshotEncodingQueue(screenshotEncodingQueue(), snapshot.imageSurface(), WTFMove(completionHandler));
 #else
-    return WTF::nullopt;
+    UNUSED_PARAM(snapshot);
+    completionHandler(WTF::nullopt);
 #endif
 }
 
-} // namespace WebKit
+void WebAutomationSession::platformGetBase64EncodedPNGDataForTiledSnapshot(WebPageProxy& page, const IntRect& rect, CompletionHandler<void(Optional<String>&&)>&& completionHandler)
+{
+    IntSize bitmapSize = rect.size();
+    bitmapSize.scale(page.deviceScaleFactor());
+    auto encoder = TiledPNGEncoder::create(bitmapSize);
+    page.takeTiledSnapshot(rect, bitmapSize, 0, screenshotTileHeight, [encoder = encoder.copyRef()](const ShareableBitmap::Handle& handle, const IntRect&, CompletionHandler<void(bool)>&& tileCompletionHandler) {
+        auto bitmap = ShareableBitmap::create(handle, SharedMemory::Protection::ReadOnly);
+        if (!bitmap) {
+            tileCompletionHandler(false);
+            return;
+        }
+
+        auto surface = bitmap->createCairoSurface();
+        screenshotEncodingQueue().dispatch([encoder = encoder.copyRef(), surface = WTFMove(surface), tileCompletionHandler = WTFMove(tileCompletionHandler)]() mutable {
+            bool encoded = encoder->encodeTile(surface.get());
+            RunLoop::main().dispatch([surface = WTFMove(surface), encoded, tileCompletionHandler = WTFMove(tileCompletionHandler)]() mutable {
+                surface = nullptr;
+                tileCompletionHandler(encoded);
+            });
+        });
+    }, [encoder = WTFMove(encoder), completionHandler = WTFMove(completionHandler)](CallbackBase::Error error) mutable {
+        if (error != CallbackBase::Error::None || !encoder->isComplete()) {
+            completionHandler(WTF::nullopt);
+            return;
+        }
 
+        screenshotEncodingQueue().dispatch([encoder = WTFMove(encoder), completionHandler = WTFMove(completionHandler)]() mutable {
+            auto base64EncodedData = encoder->base64EncodedData();
+            RunLoop::main().dispatch([completionHandler = WTFMove(completionHandler), base64EncodedData = WTFMove(base64EncodedData)]() mutable {
+                completionHandler(WTFMove(base64EncodedData));
+            });
+        });
+    });
+}
+
+} // namespace WebKit
@@ -39,13 +39,8 @@
 namespace WebKit {
 using namespace WebCore;
 
-Optional<String> WebAutomationSession::platformGetBase64EncodedPNGData(const ShareableBitmap::Handle& imageDataHandle)
+static Optional<String> base64EncodedPNGData(CGImageRef cgImage)
 {
-    auto bitmap = ShareableBitmap::create(imageDataHandle, SharedMemory::Protection::ReadOnly);
-    if (!bitmap)
-        return WTF::nullopt;
-
-    RetainPtr<CGImageRef> cgImage = bitmap->makeCGImage();
     RetainPtr<NSMutableData> imageData = adoptNS([[NSMutableData alloc] init]);
 ALLOW_DEPRECATED_DECLARATIONS_BEGIN
     RetainPtr<CGImageDestinationRef> destination = adoptCF(CGImageDestinationCreateWithData((CFMutableDataRef)imageData.get(), kUTTypePNG, 1, 0));
@@ -53,12 +48,31 @@ ALLOW_DEPRECATED_DECLARATIONS_END
     if (!destination)
         return WTF::nullopt;
 
-    CGImageDestinationAddImage(destination.get(), cgImage.get(), 0);
+    CGImageDestinationAddImage(destination.get(), cgImage, 0);
     CGImageDestinationFinalize(destination.get());
 
     return String([imageData base64EncodedStringWithOptions:0]);
 }
 
+void WebAutomationSession::platformGetBase64EncodedPNGData(const ShareableBitmap::Handle& imageDataHandle, CompletionHandler<void(Optional<String>&&)>&& completionHandler)
+{
+    auto bitmap = ShareableBitmap::create(imageDataHandle, SharedMemory::Protection::ReadOnly);
+    if (!bitmap) {
+        completionHandler(WTF::nullopt);
+        return;
+    }
+
+    // The image keeps the bitmap alive, so it is released back on the main thread.
+    RetainPtr<CGImageRef> cgImage = bitmap->makeCGImage();
+    screenshotEncodingQueue().dispatch([cgImage = WTFMove(cgImage), completionHandler = WTFMove(completionHandler)]() mutable {
+        auto base64EncodedData = base64EncodedPNGData(cgImage.get());
+        RunLoop::main().dispatch([cgImage = WTFMove(cgImage), completionHandler = WTFMove(completionHandler), base64EncodedData = WTFMove(base64EncodedData)]() mutable {
+            cgImage = nullptr;
+            completionHandler(WTFMove(base64EncodedData));
+        });
+    });
+}
+
 Optional<String> WebAutomationSession::platformGenerateLocalFilePathForRemoteFile(const String& remoteFilePath, const String& base64EncodedFileContents)
 {
     RetainPtr<NSData> fileContents = adoptNS([[NSData alloc] initWithBase64EncodedString:base64EncodedFileContents options:0]);
@@ -154,15 +154,20 @@ void DrawingAreaProxyCoordinatedGraphics::setBackingStoreIsDiscardable(bool isBa
 
 void DrawingAreaProxyCoordinatedGraphics::update(uint64_t backingStoreStateID, const UpdateInfo& updateInfo)
 {
+    didReceiveUpdateBitmap(updateInfo);
+
     ASSERT_ARG(backingStoreStateID, backingStoreStateID <= m_currentBackingStoreStateID);
-    if (backingStoreStateID < m_currentBackingStoreStateID)
+    if (backingStoreStateID < m_currentBackingStoreStateID) {
+        releaseUpdateBitmap(updateInfo);
         return;
+    }
 
     // FIXME: Handle the case where the view is hidden.
 
 #if !PLATFORM(WPE)
     incorporateUpdate(updateInfo);
 #endif
+    releaseUpdateBitmap(updateInfo);
     send(Messages::DrawingArea::DidUpdate());
 }
 
@@ -172,6 +177,8 @@ void DrawingAreaProxyCoordinatedGraphics::didUpdateBackingStoreState(uint64_t ba
     ASSERT_ARG(backingStoreStateID, backingStoreStateID > m_currentBackingStoreStateID);
     m_currentBackingStoreStateID = backingStoreStateID;
 
+    didReceiveUpdateBitmap(updateInfo);
+
     m_isWaitingForDidUpdateBackingStoreState = false;
 
     // Stop the responsiveness timer that was started in sendUpdateBackingStoreState.
@@ -198,6 +205,7 @@ void DrawingAreaProxyCoordinatedGraphics::didUpdateBackingStoreState(uint64_t ba
 #if !PLATFORM(WPE)
     if (isInAcceleratedCompositingMode()) {
         ASSERT(!m_backingStore);
+        releaseUpdateBitmap(updateInfo);
         return;
     }
 
@@ -206,6 +214,7 @@ void DrawingAreaProxyCoordinatedGraphics::didUpdateBackingStoreState(uint64_t ba
         m_backingStore = nullptr;
     incorporateUpdate(updateInfo);
 #endif
+    releaseUpdateBitmap(updateInfo);
 }
 
 void DrawingAreaProxyCoordinatedGraphics::enterAcceleratedCompositingMode(uint64_t backingStoreStateID, const LayerTreeContext& layerTreeContext)
@@ -219,14 +228,19 @@ void DrawingAreaProxyCoordinatedGraphics::enterAcceleratedCompositingMode(uint64
 
 void DrawingAreaProxyCoordinatedGraphics::exitAcceleratedCompositingMode(uint64_t backingStoreStateID, const UpdateInfo& updateInfo)
 {
+    didReceiveUpdateBitmap(updateInfo);
+
     ASSERT_ARG(backingStoreStateID, backingStoreStateID <= m_currentBackingStoreStateID);
-    if (backingStoreStateID < m_currentBackingStoreStateID)
+    if (backingStoreStateID < m_currentBackingStoreStateID) {
+        releaseUpdateBitmap(updateInfo);
         return;
+    }
 
     exitAcceleratedCompositingMode();
 #if !PLATFORM(WPE)
     incorporateUpdate(updateInfo);
 #endif
+    releaseUpdateBitmap(updateInfo);
 }
 
 void DrawingAreaProxyCoordinatedGraphics::updateAcceleratedCompositingMode(uint64_t backingStoreStateID, const LayerTreeContext& layerTreeContext)
@@ -249,7 +263,13 @@ void DrawingAreaProxyCoordinatedGraphics::incorporateUpdate(const UpdateInfo& up
     if (!m_backingStore)
         m_backingStore = makeUnique<BackingStore>(updateInfo.viewSize, updateInfo.deviceScaleFactor, m_webPageProxy);
 
-    m_backingStore->incorporateUpdate(updateInfo);
+    if (updateInfo.bitmapSlot) {
+        auto& bitmap = m_updateBitmapSlots[*updateInfo.bitmapSlot];
+        if (!bitmap)
+            return;
+        m_backingStore->incorporateUpdate(bitmap.get(), updateInfo);
+    } else
+        m_backingStore->incorporateUpdate(updateInfo);
 
     Region damageRegion;
     if (updateInfo.scrollRect.isEmpty()) {
@@ -261,6 +281,26 @@ void DrawingAreaProxyCoordinatedGraphics::incorporateUpdate(const UpdateInfo& up
 }
 #endif
 
+void DrawingAreaProxyCoordinatedGraphics::didReceiveUpdateBitmap(const UpdateInfo& updateInfo)
+{
+#if !PLATFORM(WPE)
+    // The handle of a ring slot is only sent when the web process (re)creates its bitmap, so it has to be
+    // mapped even if the update itself is going to be ignored.
+    if (!updateInfo.bitmapSlot || updateInfo.bitmapHandle.isNull())
+        return;
+
+    m_updateBitmapSlots[*updateInfo.bitmapSlot] = ShareableBitmap::create(updateInfo.bitmapHandle);
+#else
+    UNUSED_PARAM(updateInfo);
+#endif
+}
+
+void DrawingAreaProxyCoordinatedGraphics::releaseUpdateBitmap(const UpdateInfo& updateInfo)
+{
+    if (updateInfo.bitmapSlot)
+        send(Messages::DrawingArea::ReleaseUpdateBitmapSlot(*updateInfo.bitmapSlot));
+}
+
 bool DrawingAreaProxyCoordinatedGraphics::alwaysUseCompositing() const
 {
     return m_webPageProxy.preferences().acceleratedCompositingEnabled() && m_webPageProxy.preferences().forceCompositingMode();
@@ -271,6 +311,7 @@ void DrawingAreaProxyCoordinatedGraphics::enterAcceleratedCompositingMode(const
     ASSERT(!isInAcceleratedCompositingMode());
 #if !PLATFORM(WPE)
     m_backingStore = nullptr;
+    m_updateBitmapSlots = { };
 #endif
     m_layerTreeContext = layerTreeContext;
     m_webPageProxy.enterAcceleratedCompositingMode(layerTreeContext);
@@ -373,6 +414,8 @@ void DrawingAreaProxyCoordinatedGraphics::discardBackingStore()
     if (!m_backingStore)
         return;
     m_backingStore = nullptr;
+    // The web process drops its ring bitmaps too when it gets the new backing store state.
+    m_updateBitmapSlots = { };
     backingStoreStateDidChange(DoNotRespondImmediately);
 }
 #endif
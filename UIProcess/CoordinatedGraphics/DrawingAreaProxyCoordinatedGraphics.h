@@ -30,6 +30,7 @@
 #include "BackingStore.h"
 #include "DrawingAreaProxy.h"
 #include "LayerTreeContext.h"
+#include "UpdateInfo.h"
 #include <wtf/RunLoop.h>
 
 namespace WebCore {
@@ -67,6 +68,8 @@ private:
 #if !PLATFORM(WPE)
     void incorporateUpdate(const UpdateInfo&);
 #endif
+    void didReceiveUpdateBitmap(const UpdateInfo&);
+    void releaseUpdateBitmap(const UpdateInfo&);
 
     bool alwaysUseCompositing() const;
     void enterAcceleratedCompositingMode(const LayerTreeContext&);
@@ -130,6 +133,9 @@ private:
     bool m_isBackingStoreDiscardable { true };
     std::unique_ptr<BackingStore> m_backingStore;
     RunLoop::Timer<DrawingAreaProxyCoordinatedGraphics> m_discardBackingStoreTimer;
+
+    // The web process's update bitmap ring, mapped once per slot and reused for every update painted into it.
+    std::array<RefPtr<ShareableBitmap>, UpdateInfo::bitmapSlotCount> m_updateBitmapSlots;
 #endif
     std::unique_ptr<DrawingMonitor> m_drawingMonitor;
 };
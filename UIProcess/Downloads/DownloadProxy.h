@@ -73,7 +73,7 @@ public:
     const WebCore::ResourceRequest& request() const { return m_request; }
     API::Data* legacyResumeData() const { return m_legacyResumeData.get(); }
 
-    void cancel(CompletionHandler<void(API::Data*)>&&);
+    void cancel(ProduceResumeData, CompletionHandler<void(API::Data*)>&&);
 
     void invalidate();
     void processDidClose();
@@ -119,7 +119,7 @@ public:
     void didFinish();
     void didFail(const WebCore::ResourceError&, const IPC::DataReference& resumeData);
     void willSendRequest(WebCore::ResourceRequest&& redirectRequest, const WebCore::ResourceResponse& redirectResponse);
-    void decideDestinationWithSuggestedFilename(const WebCore::ResourceResponse&, String&& suggestedFilename, CompletionHandler<void(String, SandboxExtension::Handle, AllowOverwrite)>&&);
+    void decideDestinationWithSuggestedFilename(const WebCore::ResourceResponse&, String&& suggestedFilename, CompletionHandler<void(String, SandboxExtension::Handle, AllowOverwrite, ProduceResumeData)>&&);
 
 private:
     explicit DownloadProxy(DownloadProxyMap&, WebsiteDataStore&, API::DownloadClient&, const WebCore::ResourceRequest&, const FrameInfoData&, WebPageProxy*);
@@ -120,6 +120,10 @@ private:
 
     void platformInvalidate();
 
+#if (PLATFORM(GTK) || PLATFORM(WPE)) && OS(LINUX)
+    bool shouldLaunchFromZygote(bool sandboxEnabled) const;
+#endif
+
     Client* m_client;
 
 #if PLATFORM(COCOA)
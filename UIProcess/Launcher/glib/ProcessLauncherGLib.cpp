@@ -31,6 +31,7 @@
 #include "Connection.h"
 #include "FlatpakLauncher.h"
 #include "ProcessExecutablePath.h"
+#include "ProcessZygote.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <glib.h>
@@ -105,6 +106,25 @@ static bool isInsideSnap()
 }
 #endif
 
+#if OS(LINUX)
+bool ProcessLauncher::shouldLaunchFromZygote(bool sandboxEnabled) const
+{
+    // Sandboxed children must be spawned inside their sandbox, and a command prefix wraps the executable itself.
+    if (sandboxEnabled)
+        return false;
+#if ENABLE(DEVELOPER_MODE)
+    if (!m_launchOptions.processCmdPrefix.isNull())
+        return false;
+#endif
+
+    static bool zygoteEnabled = [] {
+        const char* zygoteEnv = g_getenv("WEBKIT_USE_PROCESS_ZYGOTE");
+        return zygoteEnv && !strcmp(zygoteEnv, "1");
+    }();
+    return zygoteEnabled;
+}
+#endif
+
 void ProcessLauncher::launchProcess()
 {
     IPC::Connection::SocketPair socketPair = IPC::Connection::createPlatformConnection(IPC::Connection::ConnectionOptions::SetCloexecOnServer);
@@ -157,6 +177,9 @@ void ProcessLauncher::launchProcess()
 #endif
     argv[i++] = const_cast<char*>(realExecutablePath.data());
     argv[i++] = processIdentifier.get();
+#if OS(LINUX)
+    unsigned webkitSocketArgumentIndex = i;
+#endif
     argv[i++] = webkitSocket.get();
 #if ENABLE(DEVELOPER_MODE)
     if (configureJSCForTesting)
@@ -165,6 +188,42 @@ void ProcessLauncher::launchProcess()
     argv[i++] = nullptr;
     argv[i++] = nullptr;
 
+#if OS(LINUX)
+    const char* sandboxEnv = g_getenv("WEBKIT_FORCE_SANDBOX");
+    bool sandboxEnabled = m_launchOptions.extraInitializationData.get("enable-sandbox") == "true";
+
+    if (sandboxEnv)
+        sandboxEnabled = !strcmp(sandboxEnv, "1");
+
+    if (shouldLaunchFromZygote(sandboxEnabled)) {
+#if ENABLE(DEVELOPER_MODE)
+        bool zygoteChildConfiguresJSCForTesting = configureJSCForTesting;
+#else
+        bool zygoteChildConfiguresJSCForTesting = false;
+#endif
+        auto* zygote = ProcessZygote::forExecutable(realExecutablePath);
+        if (pid_t pid = zygote ? zygote->launch(m_launchOptions.processIdentifier, socketPair.client, zygoteChildConfiguresJSCForTesting) : 0) {
+            // The child received its own copy of the client socket.
+            closeWithRetry(socketPair.client);
+            m_processIdentifier = pid;
+            RunLoop::main().dispatch([protectedThis = makeRef(*this), this, serverSocket = socketPair.server] {
+                didFinishLaunchingProcess(m_processIdentifier, serverSocket);
+            });
+            return;
+        }
+
+        // A zygote that timed out may still fork a child holding the client socket, so never hand that
+        // socket to a second process.
+        if (zygote) {
+            closeWithRetry(socketPair.client);
+            closeWithRetry(socketPair.server);
+            socketPair = IPC::Connection::createPlatformConnection(IPC::Connection::ConnectionOptions::SetCloexecOnServer);
+            webkitSocket.reset(g_strdup_printf("%d", socketPair.client));
+            argv[webkitSocketArgumentIndex] = webkitSocket.get();
+        }
+    }
+#endif
+
     GRefPtr<GSubprocessLauncher> launcher = adoptGRef(g_subprocess_launcher_new(G_SUBPROCESS_FLAGS_INHERIT_FDS));
     g_subprocess_launcher_set_child_setup(launcher.get(), childSetupFunction, GINT_TO_POINTER(socketPair.server), nullptr);
     g_subprocess_launcher_take_fd(launcher.get(), socketPair.client, socketPair.client);
@@ -173,12 +232,6 @@ void ProcessLauncher::launchProcess()
     GRefPtr<GSubprocess> process;
 
 #if OS(LINUX)
-    const char* sandboxEnv = g_getenv("WEBKIT_FORCE_SANDBOX");
-    bool sandboxEnabled = m_launchOptions.extraInitializationData.get("enable-sandbox") == "true";
-
-    if (sandboxEnv)
-        sandboxEnabled = !strcmp(sandboxEnv, "1");
-
     if (sandboxEnabled && isFlatpakSpawnUsable())
         process = flatpakSpawn(launcher.get(), m_launchOptions, argv, socketPair.client, &error.outPtr());
 #if ENABLE(BUBBLEWRAP_SANDBOX)
@@ -26,8 +26,12 @@
 #include "config.h"
 #include "ViewSnapshotStore.h"
 
+#include "APIProcessPoolConfiguration.h"
+#include "Logging.h"
 #include "WebBackForwardList.h"
 #include "WebPageProxy.h"
+#include "WebProcessPool.h"
+#include "WebProcessProxy.h"
 #include <wtf/NeverDestroyed.h>
 
 #if PLATFORM(IOS_FAMILY)
@@ -59,6 +63,10 @@ void ViewSnapshotStore::didAddImageToSnapshot(ViewSnapshot& snapshot)
     bool isNewEntry = m_snapshotsWithImages.add(&snapshot).isNewEntry;
     ASSERT_UNUSED(isNewEntry, isNewEntry);
     m_snapshotCacheSize += snapshot.imageSizeInBytes();
+#if PLATFORM(GTK)
+    if (snapshot.isCompressed())
+        m_compressedImageBytes += snapshot.imageSizeInBytes();
+#endif
 }
 
 void ViewSnapshotStore::willRemoveImageFromSnapshot(ViewSnapshot& snapshot)
@@ -66,6 +74,10 @@ void ViewSnapshotStore::willRemoveImageFromSnapshot(ViewSnapshot& snapshot)
     bool removed = m_snapshotsWithImages.remove(&snapshot);
     ASSERT_UNUSED(removed, removed);
     m_snapshotCacheSize -= snapshot.imageSizeInBytes();
+#if PLATFORM(GTK)
+    if (snapshot.isCompressed())
+        m_compressedImageBytes -= snapshot.imageSizeInBytes();
+#endif
 }
 
 void ViewSnapshotStore::pruneSnapshots(WebPageProxy& webPageProxy)
@@ -73,11 +85,15 @@ void ViewSnapshotStore::pruneSnapshots(WebPageProxy& webPageProxy)
     if (m_snapshotCacheSize <= maximumSnapshotCacheSize)
         return;
 
-    ASSERT(!m_snapshotsWithImages.isEmpty());
-
     // FIXME: We have enough information to do smarter-than-LRU eviction (making use of the back-forward lists, etc.)
 
-    m_snapshotsWithImages.first()->clearImage();
+    // The budget is shared by all pages, so evict until it is met rather than one snapshot per recording.
+    while (m_snapshotCacheSize > maximumSnapshotCacheSize && !m_snapshotsWithImages.isEmpty())
+        m_snapshotsWithImages.first()->clearImage();
+
+#if PLATFORM(GTK)
+    RELEASE_LOG(ViewGestures, "ViewSnapshotStore::pruneSnapshots: %zu snapshot images left, %zu bytes compressed and %zu bytes uncompressed", m_snapshotsWithImages.size(), compressedImageBytes(), uncompressedImageBytes());
+#endif
 }
 
 void ViewSnapshotStore::recordSnapshot(WebPageProxy& webPageProxy, WebBackForwardListItem& item)
@@ -98,6 +114,11 @@ void ViewSnapshotStore::recordSnapshot(WebPageProxy& webPageProxy, WebBackForwar
     snapshot->setBackgroundColor(webPageProxy.pageExtendedBackgroundColor());
     snapshot->setViewScrollPosition(WebCore::roundedIntPoint(webPageProxy.viewScrollPosition()));
 
+#if PLATFORM(GTK)
+    if (webPageProxy.process().processPool().configuration().compressesViewSnapshots())
+        snapshot->compressImage();
+#endif
+
     item.setSnapshot(WTFMove(snapshot));
 }
 
@@ -37,6 +37,9 @@
 
 #if PLATFORM(GTK)
 #include <WebCore/RefPtrCairo.h>
+#include <cairo.h>
+#include <wtf/Vector.h>
+#include <wtf/WorkQueue.h>
 #endif
 
 namespace WebKit {
@@ -87,10 +90,16 @@ public:
 #endif
 
 #if PLATFORM(GTK)
+    // Null once the image has been compressed; use imageSurface() to get the image in either representation.
     cairo_surface_t* surface() const { return m_surface.get(); }
+    RefPtr<cairo_surface_t> imageSurface() const;
 
     size_t imageSizeInBytes() const;
-    WebCore::IntSize size() const;
+    WebCore::IntSize size() const { return m_size; }
+
+    bool isCompressed() const { return !m_compressedImage.isEmpty(); }
+    void compressImage();
+    void setCompressedImage(Vector<uint8_t>&&);
 #endif
 
 private:
@@ -104,6 +113,9 @@ private:
     explicit ViewSnapshot(RefPtr<cairo_surface_t>&&);
 
     RefPtr<cairo_surface_t> m_surface;
+    Vector<uint8_t> m_compressedImage;
+    WebCore::IntSize m_size;
+    cairo_format_t m_format { CAIRO_FORMAT_RGB24 };
 #endif
 
     uint64_t m_renderTreeSize;
@@ -133,10 +145,24 @@ private:
     void willRemoveImageFromSnapshot(ViewSnapshot&);
     void pruneSnapshots(WebPageProxy&);
 
+#if PLATFORM(GTK)
+    WorkQueue& compressionQueue();
+    void didCompressSnapshotImage(ViewSnapshot*, cairo_surface_t*, Vector<uint8_t>&&);
+
+    size_t compressedImageBytes() const { return m_compressedImageBytes; }
+    size_t uncompressedImageBytes() const { return m_snapshotCacheSize - m_compressedImageBytes; }
+#endif
+
     size_t m_snapshotCacheSize { 0 };
 
     ListHashSet<ViewSnapshot*> m_snapshotsWithImages;
     bool m_disableSnapshotVolatility { false };
+
+#if PLATFORM(GTK)
+    // Snapshot images are compressed on a background queue once recorded, and decoded again when a swipe starts.
+    size_t m_compressedImageBytes { 0 };
+    RefPtr<WorkQueue> m_compressionQueue;
+#endif
 };
 
 } // namespace WebKit
@@ -27,11 +27,13 @@
 #include "WebBackForwardList.h"
 
 #include "APIArray.h"
+#include "APIProcessPoolConfiguration.h"
 #include "Logging.h"
 #include "SessionState.h"
 #include "WebBackForwardCache.h"
 #include "WebBackForwardListCounts.h"
 #include "WebPageProxy.h"
+#include "WebProcessPool.h"
 #include <WebCore/DiagnosticLoggingClient.h>
 #include <WebCore/DiagnosticLoggingKeys.h>
 #include <wtf/DebugUtilities.h>
@@ -449,6 +451,13 @@ void WebBackForwardList::restoreFromState(BackForwardListState backForwardListSt
     m_currentIndex = backForwardListState.currentIndex ? Optional<size_t>(*backForwardListState.currentIndex) : WTF::nullopt;
     m_entries = WTFMove(items);
 
+    if (loadsItemStatesLazily()) {
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            if (i != m_currentIndex)
+                m_entries[i]->compactPageState();
+        }
+    }
+
     LOG(BackForward, "(Back/Forward) WebBackForwardList %p restored from state (has %zu entries)", this, m_entries.size());
 }
 
@@ -457,14 +466,22 @@ Vector<BackForwardListItemState> WebBackForwardList::filteredItemStates(Function
     Vector<BackForwardListItemState> itemStates;
     itemStates.reserveInitialCapacity(m_entries.size());
 
+    // When loading lazily, the web process only gets the full state of the current item and asks for the others when they are navigated to.
+    bool sendStubs = loadsItemStatesLazily();
+    auto* currentItem = this->currentItem();
     for (const auto& entry : m_entries) {
         if (functor(entry))
-            itemStates.uncheckedAppend(entry->itemState());
+            itemStates.uncheckedAppend(sendStubs && entry.ptr() != currentItem ? entry->stubItemState() : entry->itemState());
     }
 
     return itemStates;
 }
 
+bool WebBackForwardList::loadsItemStatesLazily() const
+{
+    return m_page && m_page->process().processPool().configuration().loadsBackForwardItemStatesLazily();
+}
+
 Vector<BackForwardListItemState> WebBackForwardList::itemStates() const
 {
     return filteredItemStates([](WebBackForwardListItem&) {
@@ -85,6 +85,7 @@ private:
     explicit WebBackForwardList(WebPageProxy&);
 
     void didRemoveItem(WebBackForwardListItem&);
+    bool loadsItemStatesLazily() const;
 
     WebPageProxy* m_page;
     BackForwardListItemVector m_entries;
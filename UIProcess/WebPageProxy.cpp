@@ -2649,8 +2649,8 @@ void WebPageProxy::handleWheelEvent(const NativeWebWheelEvent& event)
     closeOverlayedViews();
 
     if (wheelEventCoalescer().shouldDispatchEvent(event)) {
-        auto event = wheelEventCoalescer().nextEventToDispatch();
-        sendWheelEvent(*event);
+        if (auto event = wheelEventCoalescer().nextEventToDispatch())
+            sendWheelEvent(*event);
     }
 }
 
@@ -2677,12 +2677,33 @@ void WebPageProxy::sendWheelEvent(const WebWheelEvent& event)
 
 WebWheelEventCoalescer& WebPageProxy::wheelEventCoalescer()
 {
-    if (!m_wheelEventCoalescer)
-        m_wheelEventCoalescer = makeUnique<WebWheelEventCoalescer>();
+    if (!m_wheelEventCoalescer) {
+        m_wheelEventCoalescer = makeUnique<WebWheelEventCoalescer>([this] {
+            if (!hasRunningProcess())
+                return;
+            if (auto event = m_wheelEventCoalescer->nextEventToDispatch())
+                sendWheelEvent(*event);
+        });
+        if (m_process->processPool().configuration().coalescesInputEventsWithinDisplayFrame())
+            m_wheelEventCoalescer->setCoalescingPolicy(WebWheelEventCoalescer::CoalescingPolicy::WithinDisplayFrame);
+        if (m_displayNominalFramesPerSecond && *m_displayNominalFramesPerSecond)
+            m_wheelEventCoalescer->setDisplayFrameInterval(1_s / *m_displayNominalFramesPerSecond);
+    }
 
     return *m_wheelEventCoalescer;
 }
 
+void WebPageProxy::reportWheelEventDispatchLatency()
+{
+    auto latency = wheelEventCoalescer().takeDispatchLatency();
+    if (!latency.dispatchedEventCount)
+        return;
+
+    RELEASE_LOG_IF_ALLOWED(WheelEvents, "reportWheelEventDispatchLatency: Dispatched %u wheel events as %u (average latency %.2fms, maximum %.2fms)", latency.receivedEventCount, latency.dispatchedEventCount, latency.averageLatency().milliseconds(), latency.maximumLatency.milliseconds());
+    logDiagnosticMessageWithValue("wheelEventDispatchLatency"_s, "average"_s, latency.averageLatency().milliseconds(), 2, ShouldSample::Yes);
+    logDiagnosticMessageWithValue("wheelEventDispatchLatency"_s, "maximum"_s, latency.maximumLatency.milliseconds(), 2, ShouldSample::Yes);
+}
+
 bool WebPageProxy::hasQueuedKeyEvent() const
 {
     return !m_keyEventQueue.isEmpty();
@@ -3657,6 +3678,10 @@ void WebPageProxy::setIntrinsicDeviceScaleFactor(float scaleFactor)
 
 void WebPageProxy::windowScreenDidChange(PlatformDisplayID displayID, Optional<unsigned> nominalFramesPerSecond)
 {
+    m_displayNominalFramesPerSecond = nominalFramesPerSecond;
+    if (m_wheelEventCoalescer && nominalFramesPerSecond && *nominalFramesPerSecond)
+        m_wheelEventCoalescer->setDisplayFrameInterval(1_s / *nominalFramesPerSecond);
+
     if (!hasRunningProcess())
         return;
 
@@ -4192,6 +4217,77 @@ void WebPageProxy::getWebArchiveOfFrame(WebFrameProxy* frame, Function<void (API
     send(Messages::WebPage::GetWebArchiveOfFrame(frame->frameID(), callbackID));
 }
 
+uint64_t WebPageProxy::startContentStream(ContentStreamChunkHandler&& chunkHandler, CompletionHandler<void(CallbackBase::Error)>&& completionHandler, ASCIILiteral activityName)
+{
+    static uint64_t nextStreamID;
+    auto streamID = ++nextStreamID;
+    m_contentStreams.add(streamID, ContentStream { WTFMove(chunkHandler), WTFMove(completionHandler), m_process->throttler().backgroundActivity(activityName) });
+    return streamID;
+}
+
+void WebPageProxy::streamContentsAsString(ContentAsStringIncludesChildFrames includesChildFrames, ContentStreamChunkHandler&& chunkHandler, CompletionHandler<void(CallbackBase::Error)>&& completionHandler)
+{
+    if (!hasRunningProcess()) {
+        completionHandler(CallbackBase::Error::Unknown);
+        return;
+    }
+
+    auto streamID = startContentStream(WTFMove(chunkHandler), WTFMove(completionHandler), "WebPageProxy::streamContentsAsString"_s);
+    send(Messages::WebPage::StreamContentsAsString(includesChildFrames, streamID));
+}
+
+#if ENABLE(MHTML)
+void WebPageProxy::streamContentsAsMHTMLData(ContentStreamChunkHandler&& chunkHandler, CompletionHandler<void(CallbackBase::Error)>&& completionHandler)
+{
+    if (!hasRunningProcess()) {
+        completionHandler(CallbackBase::Error::Unknown);
+        return;
+    }
+
+    auto streamID = startContentStream(WTFMove(chunkHandler), WTFMove(completionHandler), "WebPageProxy::streamContentsAsMHTMLData"_s);
+    send(Messages::WebPage::StreamContentsAsMHTMLData(streamID));
+}
+#endif
+
+void WebPageProxy::streamWebArchiveOfFrame(WebFrameProxy* frame, ContentStreamChunkHandler&& chunkHandler, CompletionHandler<void(CallbackBase::Error)>&& completionHandler)
+{
+    if (!hasRunningProcess()) {
+        completionHandler(CallbackBase::Error::Unknown);
+        return;
+    }
+
+    auto streamID = startContentStream(WTFMove(chunkHandler), WTFMove(completionHandler), "WebPageProxy::streamWebArchiveOfFrame"_s);
+    send(Messages::WebPage::StreamWebArchiveOfFrame(frame->frameID(), streamID));
+}
+
+// The web process reuses the shared memory for the next chunk once the completion handler is called,
+// so the chunk handler must be done with the data by then.
+void WebPageProxy::didReceiveContentStreamChunk(uint64_t streamID, const SharedMemory::IPCHandle& chunk, CompletionHandler<void()>&& completionHandler)
+{
+    auto it = m_contentStreams.find(streamID);
+    if (it == m_contentStreams.end())
+        return completionHandler();
+
+    MESSAGE_CHECK_COMPLETION(m_process, !chunk.handle.isNull(), completionHandler());
+    auto sharedMemory = SharedMemory::map(chunk.handle, SharedMemory::Protection::ReadOnly);
+    if (!sharedMemory)
+        return completionHandler();
+    MESSAGE_CHECK_COMPLETION(m_process, chunk.dataSize <= sharedMemory->size(), completionHandler());
+
+    it->value.chunkHandler(static_cast<const uint8_t*>(sharedMemory->data()), chunk.dataSize);
+    sharedMemory = nullptr;
+    completionHandler();
+}
+
+void WebPageProxy::didFinishContentStream(uint64_t streamID, bool success)
+{
+    auto stream = m_contentStreams.take(streamID);
+    if (!stream.completionHandler)
+        return;
+
+    stream.completionHandler(success ? CallbackBase::Error::None : CallbackBase::Error::Unknown);
+}
+
 void WebPageProxy::forceRepaint(CompletionHandler<void()>&& callback)
 {
     if (!hasRunningProcess())
@@ -4229,7 +4325,19 @@ void WebPageProxy::preferencesDidChange()
     // even if nothing changed in UI process, so that overrides get removed.
 
     // Preferences need to be updated during synchronous printing to make "print backgrounds" preference work when toggled from a print dialog checkbox.
-    send(Messages::WebPage::PreferencesDidChange(preferencesStore()), printingSendOptions(m_isPerformingDOMPrintOperation));
+    auto store = preferencesStore();
+    auto processIdentifier = m_process->coreProcessIdentifier();
+    if (m_preferencesStoreSentToWebProcess && m_preferencesStoreSentToWebProcess->first == processIdentifier) {
+        // An empty delta is still sent so that the web process drops its test runner overrides.
+        if (auto delta = store.deltaFrom(m_preferencesStoreSentToWebProcess->second)) {
+            send(Messages::WebPage::PreferencesDidChangeDelta(*delta), printingSendOptions(m_isPerformingDOMPrintOperation));
+            m_preferencesStoreSentToWebProcess->second = WTFMove(store);
+            return;
+        }
+    }
+
+    send(Messages::WebPage::PreferencesDidChange(store), printingSendOptions(m_isPerformingDOMPrintOperation));
+    m_preferencesStoreSentToWebProcess = std::make_pair(processIdentifier, WTFMove(store));
 }
 
 void WebPageProxy::didCreateMainFrame(FrameIdentifier frameID)
@@ -6469,7 +6577,7 @@ bool WebPageProxy::isProcessingMouseEvents() const
 
 bool WebPageProxy::isProcessingWheelEvents() const
 {
-    return m_wheelEventCoalescer && m_wheelEventCoalescer->hasEventsBeingProcessed();
+    return m_wheelEventCoalescer && (m_wheelEventCoalescer->hasEventsBeingProcessed() || m_wheelEventCoalescer->hasQueuedEvents());
 }
 
 NativeWebMouseEvent* WebPageProxy::currentlyProcessedMouseDownEvent()
@@ -6996,18 +7104,25 @@ void WebPageProxy::didReceiveEvent(uint32_t opaqueType, bool handled)
 
     case WebEvent::Wheel: {
         MESSAGE_CHECK(m_process, wheelEventCoalescer().hasEventsBeingProcessed());
-        auto oldestProcessedEvent = wheelEventCoalescer().takeOldestEventBeingProcessed();
+        auto oldestProcessedEventSequence = wheelEventCoalescer().takeOldestEventSequenceBeingProcessed();
 
-        // FIXME: Dispatch additional events to the didNotHandleWheelEvent client function.
+        // Clients get the native events that were coalesced, not the merged one that was dispatched.
         if (!handled) {
-            m_uiClient->didNotHandleWheelEvent(this, oldestProcessedEvent);
-            pageClient().wheelEventWasNotHandledByWebCore(oldestProcessedEvent);
+            for (auto& event : oldestProcessedEventSequence) {
+                m_uiClient->didNotHandleWheelEvent(this, event);
+                pageClient().wheelEventWasNotHandledByWebCore(event);
+            }
         }
 
         if (auto eventToSend = wheelEventCoalescer().nextEventToDispatch())
             sendWheelEvent(*eventToSend);
-        else if (auto* automationSession = process().processPool().automationSession())
-            automationSession->wheelEventsFlushedForPage(*this);
+        else if (!wheelEventCoalescer().hasQueuedEvents()) {
+            // Events held until the end of the frame are still to be dispatched.
+            if (!wheelEventCoalescer().hasEventsBeingProcessed())
+                reportWheelEventDispatchLatency();
+            if (auto* automationSession = process().processPool().automationSession())
+                automationSession->wheelEventsFlushedForPage(*this);
+        }
         break;
     }
 
@@ -7596,6 +7711,10 @@ void WebPageProxy::resetState(ResetStateReason resetStateReason)
     m_callbacks.invalidate(error);
     m_loadDependentStringCallbackIDs.clear();
 
+    auto contentStreams = std::exchange(m_contentStreams, { });
+    for (auto& stream : contentStreams.values())
+        stream.completionHandler(error);
+
     for (auto& editCommand : std::exchange(m_editCommandSet, { }))
         editCommand->invalidate();
 
@@ -7799,6 +7918,7 @@ WebPageCreationParameters WebPageProxy::creationParameters(WebProcessProxy& proc
     parameters.drawingAreaIdentifier = drawingArea.identifier();
     parameters.webPageProxyIdentifier = m_identifier;
     parameters.store = preferencesStore();
+    m_preferencesStoreSentToWebProcess = std::make_pair(process.coreProcessIdentifier(), parameters.store);
     parameters.pageGroupData = m_pageGroup->data();
     parameters.isEditable = m_isEditable;
     parameters.underlayColor = m_underlayColor;
@@ -8946,6 +9066,128 @@ void WebPageProxy::takeSnapshot(IntRect rect, IntSize bitmapSize, SnapshotOption
     send(Messages::WebPage::TakeSnapshot(rect, bitmapSize, options, callbackID));
 }
 
+class TiledSnapshotRequest : public RefCounted<TiledSnapshotRequest> {
+public:
+    static Ref<TiledSnapshotRequest> create(WebPageProxy& page, IntRect rect, IntSize bitmapSize, SnapshotOptions options, int tileHeight, WebPageProxy::SnapshotTileHandler&& tileHandler, CompletionHandler<void(CallbackBase::Error)>&& completionHandler)
+    {
+        return adoptRef(*new TiledSnapshotRequest(page, rect, bitmapSize, options, tileHeight, WTFMove(tileHandler), WTFMove(completionHandler)));
+    }
+
+    void start()
+    {
+        m_page->send(Messages::WebPage::BeginTiledSnapshot(m_identifier));
+        requestTile(0);
+    }
+
+    // At most two tiles are alive at once: the one being handled and the next one, which the web process
+    // renders meanwhile.
+    void requestTile(int tileY)
+    {
+        if (!m_page || !m_page->hasRunningProcess()) {
+            finish(CallbackBase::Error::OwnerWasInvalidated);
+            return;
+        }
+
+        IntRect tileRect(0, tileY, m_bitmapSize.width(), std::min(m_tileHeight, m_bitmapSize.height() - tileY));
+        m_page->sendWithAsyncReply(Messages::WebPage::TakeSnapshotTile(m_rect, m_bitmapSize, tileRect, m_options), [protectedThis = makeRef(*this), tileRect, activity = m_page->process().throttler().backgroundActivity("WebPageProxy::takeTiledSnapshot"_s)](ShareableBitmap::Handle&& handle) mutable {
+            if (!protectedThis->m_completionHandler)
+                return;
+
+            if (handle.isNull()) {
+                protectedThis->finish(CallbackBase::Error::Unknown);
+                return;
+            }
+
+            protectedThis->m_pendingTile = std::make_pair(WTFMove(handle), tileRect);
+            protectedThis->handlePendingTile();
+        });
+    }
+
+private:
+    TiledSnapshotRequest(WebPageProxy& page, IntRect rect, IntSize bitmapSize, SnapshotOptions options, int tileHeight, WebPageProxy::SnapshotTileHandler&& tileHandler, CompletionHandler<void(CallbackBase::Error)>&& completionHandler)
+        : m_page(makeWeakPtr(page))
+        , m_identifier(generateIdentifier())
+        , m_rect(rect)
+        , m_bitmapSize(bitmapSize)
+        , m_options(options)
+        , m_tileHeight(tileHeight)
+        , m_tileHandler(WTFMove(tileHandler))
+        , m_completionHandler(WTFMove(completionHandler))
+    {
+    }
+
+    static uint64_t generateIdentifier()
+    {
+        static uint64_t identifier;
+        return ++identifier;
+    }
+
+    void handlePendingTile()
+    {
+        if (m_isHandlingTile || !m_pendingTile)
+            return;
+
+        auto [handle, tileRect] = WTFMove(*m_pendingTile);
+        m_pendingTile = WTF::nullopt;
+        bool isLastTile = tileRect.maxY() == m_bitmapSize.height();
+        if (!isLastTile)
+            requestTile(tileRect.maxY());
+
+        m_isHandlingTile = true;
+        m_tileHandler(handle, tileRect, [protectedThis = makeRef(*this), isLastTile](bool shouldContinue) {
+            protectedThis->m_isHandlingTile = false;
+            if (!shouldContinue || isLastTile) {
+                protectedThis->finish(CallbackBase::Error::None);
+                return;
+            }
+            protectedThis->handlePendingTile();
+        });
+    }
+
+    void finish(CallbackBase::Error error)
+    {
+        if (!m_completionHandler)
+            return;
+
+        // The web process ignores this if it was swapped or relaunched since the snapshot began, or if it gave
+        // up on the snapshot after its timeout.
+        if (m_page && m_page->hasRunningProcess())
+            m_page->send(Messages::WebPage::EndTiledSnapshot(m_identifier));
+        m_completionHandler(error);
+    }
+
+    WeakPtr<WebPageProxy> m_page;
+    uint64_t m_identifier;
+    IntRect m_rect;
+    IntSize m_bitmapSize;
+    SnapshotOptions m_options;
+    int m_tileHeight;
+    WebPageProxy::SnapshotTileHandler m_tileHandler;
+    CompletionHandler<void(CallbackBase::Error)> m_completionHandler;
+    Optional<std::pair<ShareableBitmap::Handle, IntRect>> m_pendingTile;
+    bool m_isHandlingTile { false };
+};
+
+void WebPageProxy::takeTiledSnapshot(IntRect rect, IntSize bitmapSize, SnapshotOptions options, int tileHeight, SnapshotTileHandler&& tileHandler, CompletionHandler<void(CallbackBase::Error)>&& completionHandler)
+{
+    if (!hasRunningProcess() || rect.isEmpty() || bitmapSize.isEmpty() || tileHeight <= 0 || options & SnapshotOptionsPrinting) {
+        completionHandler(CallbackBase::Error::Unknown);
+        return;
+    }
+
+    TiledSnapshotRequest::create(*this, rect, bitmapSize, options, tileHeight, WTFMove(tileHandler), WTFMove(completionHandler))->start();
+}
+
+void WebPageProxy::getMainFrameScrollGeometry(CompletionHandler<void(const IntRect&, const IntSize&)>&& completionHandler)
+{
+    if (!hasRunningProcess()) {
+        completionHandler({ }, { });
+        return;
+    }
+
+    sendWithAsyncReply(Messages::WebPage::GetMainFrameScrollGeometry(), WTFMove(completionHandler));
+}
+
 void WebPageProxy::navigationGestureDidBegin()
 {
     PageClientProtector protector(pageClient());
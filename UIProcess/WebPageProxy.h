@@ -1136,6 +1136,15 @@ public:
     void getSelectionAsWebArchiveData(Function<void (API::Data*, CallbackBase::Error)>&&);
     void getSourceForFrame(WebFrameProxy*, WTF::Function<void (const String&, CallbackBase::Error)>&&);
     void getWebArchiveOfFrame(WebFrameProxy*, Function<void (API::Data*, CallbackBase::Error)>&&);
+
+    // Streaming variants of the above. The chunk handler is called with each piece of the
+    // contents as the web process produces it, and the completion handler once the stream ends.
+    using ContentStreamChunkHandler = WTF::Function<void(const uint8_t*, size_t)>;
+    void streamContentsAsString(ContentAsStringIncludesChildFrames, ContentStreamChunkHandler&&, CompletionHandler<void(CallbackBase::Error)>&&);
+#if ENABLE(MHTML)
+    void streamContentsAsMHTMLData(ContentStreamChunkHandler&&, CompletionHandler<void(CallbackBase::Error)>&&);
+#endif
+    void streamWebArchiveOfFrame(WebFrameProxy*, ContentStreamChunkHandler&&, CompletionHandler<void(CallbackBase::Error)>&&);
     void runJavaScriptInMainFrame(WebCore::RunJavaScriptParameters&&, CompletionHandler<void(Expected<RefPtr<API::SerializedScriptValue>, WebCore::ExceptionDetails>&&)>&&);
     void runJavaScriptInFrameInScriptWorld(WebCore::RunJavaScriptParameters&&, Optional<WebCore::FrameIdentifier>, API::ContentWorld&, CompletionHandler<void(Expected<RefPtr<API::SerializedScriptValue>, WebCore::ExceptionDetails>&&)>&&);
     void forceRepaint(CompletionHandler<void()>&&);
@@ -1427,6 +1436,11 @@ public:
     void signedPublicKeyAndChallengeString(unsigned keySizeIndex, const String& challengeString, const URL&, CompletionHandler<void(String)>&&);
 
     void takeSnapshot(WebCore::IntRect, WebCore::IntSize bitmapSize, SnapshotOptions, WTF::Function<void (const ShareableBitmap::Handle&, CallbackBase::Error)>&&);
+    // Delivers the snapshot as consecutive full width tiles of at most tileHeight rows, top to bottom. The next tile
+    // is rendered while the tile handler runs, passing false to its completion handler stops the snapshot.
+    using SnapshotTileHandler = WTF::Function<void(const ShareableBitmap::Handle&, const WebCore::IntRect& tileRect, CompletionHandler<void(bool shouldContinue)>&&)>;
+    void takeTiledSnapshot(WebCore::IntRect, WebCore::IntSize bitmapSize, SnapshotOptions, int tileHeight, SnapshotTileHandler&&, CompletionHandler<void(CallbackBase::Error)>&&);
+    void getMainFrameScrollGeometry(CompletionHandler<void(const WebCore::IntRect& visibleContentRect, const WebCore::IntSize& contentsSize)>&&);
 
     void navigationGestureDidBegin();
     void navigationGestureWillEnd(bool willNavigate, WebBackForwardListItem&);
@@ -2143,6 +2157,9 @@ private:
     void boolCallback(bool result, CallbackID);
     void stringCallback(const String&, CallbackID);
     void invalidateStringCallback(CallbackID);
+    void didReceiveContentStreamChunk(uint64_t streamID, const SharedMemory::IPCHandle&, CompletionHandler<void()>&&);
+    void didFinishContentStream(uint64_t streamID, bool success);
+    uint64_t startContentStream(ContentStreamChunkHandler&&, CompletionHandler<void(CallbackBase::Error)>&&, ASCIILiteral activityName);
     void computedPagesCallback(const Vector<WebCore::IntRect>&, double totalScaleFactorForPrinting, const WebCore::FloatBoxExtent& computedPageMargin, CallbackID);
     void unsignedCallback(uint64_t, CallbackID);
 #if ENABLE(APPLICATION_MANIFEST)
@@ -2237,6 +2254,7 @@ private:
     void sendWheelEvent(const WebWheelEvent&);
 
     WebWheelEventCoalescer& wheelEventCoalescer();
+    void reportWheelEventDispatchLatency();
 
 #if ENABLE(TOUCH_EVENTS)
     void updateTouchEventTracking(const WebTouchEvent&);
@@ -2478,6 +2496,13 @@ private:
     CallbackMap m_callbacks;
     HashSet<CallbackID> m_loadDependentStringCallbackIDs;
 
+    struct ContentStream {
+        ContentStreamChunkHandler chunkHandler;
+        CompletionHandler<void(CallbackBase::Error)> completionHandler;
+        ProcessThrottler::ActivityVariant activity;
+    };
+    HashMap<uint64_t, ContentStream> m_contentStreams;
+
     HashSet<WebEditCommandProxy*> m_editCommandSet;
 
 #if PLATFORM(COCOA)
@@ -2574,6 +2599,9 @@ private:
     bool m_isInPrintingMode { false };
     bool m_isPerformingDOMPrintOperation { false };
 
+    // The preferences last sent to a web process for this page, so that later changes can be sent as a delta.
+    Optional<std::pair<WebCore::ProcessIdentifier, WebPreferencesStore>> m_preferencesStoreSentToWebProcess;
+
     WebCore::ResourceRequest m_decidePolicyForResponseRequest;
     bool m_shouldSuppressAppLinksInNextNavigationPolicyDecision { false };
 
@@ -2583,6 +2611,7 @@ private:
 #endif
 
     std::unique_ptr<WebWheelEventCoalescer> m_wheelEventCoalescer;
+    Optional<unsigned> m_displayNominalFramesPerSecond;
 
     Deque<NativeWebMouseEvent> m_mouseEventQueue;
     Deque<NativeWebKeyboardEvent> m_keyEventQueue;
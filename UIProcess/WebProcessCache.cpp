@@ -33,6 +33,14 @@
 #include <wtf/RAMSize.h>
 #include <wtf/StdLibExtras.h>
 
+#if OS(LINUX)
+#include <cmath>
+#include <stdio.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/WorkQueue.h>
+#include <wtf/text/StringConcatenateNumbers.h>
+#endif
+
 #define WEBPROCESSCACHE_RELEASE_LOG(fmt, ...) RELEASE_LOG(ProcessSwapping, "%p - [PID=%d] WebProcessCache::" fmt, this, ##__VA_ARGS__)
 #define WEBPROCESSCACHE_RELEASE_LOG_ERROR(fmt, ...) RELEASE_LOG_ERROR(ProcessSwapping, "%p - [PID=%d] WebProcessCache::" fmt, this, ##__VA_ARGS__)
 
@@ -41,6 +49,63 @@ namespace WebKit {
 Seconds WebProcessCache::cachedProcessLifetime { 30_min };
 Seconds WebProcessCache::clearingDelayAfterApplicationResignsActive { 5_min };
 
+#if OS(LINUX)
+// How quickly the visit frequency of a domain and the value of an idle cached process fade.
+static const Seconds visitFrequencyHalfLife { 1_h };
+static const Seconds cachedProcessValueHalfLife { 10_min };
+static const size_t maximumDomainVisitsCount = 1000;
+// Used when the memory of a process can't be measured.
+static const size_t defaultProcessMemoryFootprint = 64 * MB;
+
+struct ProcessMemoryUsage {
+    size_t resident { 0 };
+    size_t privateDirty { 0 };
+};
+
+static Optional<ProcessMemoryUsage> processMemoryUsage(ProcessID pid)
+{
+    auto path = makeString("/proc/", pid, "/smaps_rollup");
+    FILE* file = fopen(path.utf8().data(), "r");
+    if (!file)
+        return WTF::nullopt;
+
+    ProcessMemoryUsage usage;
+    char line[128];
+    while (fgets(line, sizeof(line), file)) {
+        size_t valueInKB;
+        if (sscanf(line, "Rss: %zu kB", &valueInKB) == 1)
+            usage.resident = valueInKB * KB;
+        else if (sscanf(line, "Private_Dirty: %zu kB", &valueInKB) == 1)
+            usage.privateDirty = valueInKB * KB;
+    }
+    fclose(file);
+
+    if (!usage.resident)
+        return WTF::nullopt;
+    return usage;
+}
+
+static size_t processMemoryFootprint(ProcessID pid)
+{
+    // Private dirty memory is what terminating the process gives back.
+    auto usage = processMemoryUsage(pid);
+    if (!usage)
+        return defaultProcessMemoryFootprint;
+    return usage->privateDirty ? usage->privateDirty : usage->resident;
+}
+
+static WorkQueue& memoryFootprintQueue()
+{
+    static NeverDestroyed<Ref<WorkQueue>> queue(WorkQueue::create("com.apple.WebKit.WebProcessCache.MemoryFootprint", WorkQueue::Type::Serial, WorkQueue::QOS::Utility));
+    return queue.get();
+}
+
+static double decayFactor(Seconds elapsed, Seconds halfLife)
+{
+    return std::exp2(-(elapsed / halfLife));
+}
+#endif
+
 static uint64_t generateAddRequestIdentifier()
 {
     static uint64_t identifier = 0;
@@ -96,16 +161,33 @@ bool WebProcessCache::addProcessIfPossible(Ref<WebProcessProxy>&& process)
     m_pendingAddRequests.add(requestIdentifier, makeUnique<CachedProcess>(process.copyRef()));
 
     WEBPROCESSCACHE_RELEASE_LOG("addProcessIfPossible: Checking if process is responsive before caching it", process->processIdentifier());
-    process->isResponsive([this, processPool = WTFMove(protectedProcessPool), process, requestIdentifier](bool isResponsive) {
-        auto cachedProcess = m_pendingAddRequests.take(requestIdentifier);
-        if (!cachedProcess)
+    process->isResponsive([this, processPool = WTFMove(protectedProcessPool), process, requestIdentifier](bool isResponsive) mutable {
+        if (!m_pendingAddRequests.contains(requestIdentifier))
             return;
 
         if (!isResponsive) {
+            auto cachedProcess = m_pendingAddRequests.take(requestIdentifier);
             WEBPROCESSCACHE_RELEASE_LOG_ERROR("addProcessIfPossible(): Not caching process because it is not responsive", cachedProcess->process().processIdentifier());
             return;
         }
-        processPool->webProcessCache().addProcess(WTFMove(cachedProcess));
+
+#if OS(LINUX)
+        // Reading smaps_rollup walks every mapping of the process, so it is done off the main thread. The process
+        // stays a pending request in the meantime, so it can still be removed or taken back.
+        memoryFootprintQueue().dispatch([this, processPool = WTFMove(processPool), pid = process->processIdentifier(), requestIdentifier]() mutable {
+            size_t memoryFootprint = processMemoryFootprint(pid);
+            RunLoop::main().dispatch([this, processPool = WTFMove(processPool), requestIdentifier, memoryFootprint]() mutable {
+                auto cachedProcess = m_pendingAddRequests.take(requestIdentifier);
+                if (!cachedProcess)
+                    return;
+
+                cachedProcess->setMemoryFootprint(memoryFootprint);
+                processPool->webProcessCache().addProcess(WTFMove(cachedProcess));
+            });
+        });
+#else
+        processPool->webProcessCache().addProcess(m_pendingAddRequests.take(requestIdentifier));
+#endif
     });
     return true;
 }
@@ -126,8 +208,31 @@ bool WebProcessCache::addProcess(std::unique_ptr<CachedProcess>&& cachedProcess)
     if (auto previousProcess = m_processesPerRegistrableDomain.take(registrableDomain))
         WEBPROCESSCACHE_RELEASE_LOG("addProcess: Evicting process from WebProcess cache because a new process was added for the same domain", previousProcess->process().processIdentifier());
 
+#if OS(LINUX)
+    recordVisit(registrableDomain);
+
+    auto now = MonotonicTime::now();
+    double newProcessScore = score(registrableDomain, *cachedProcess, now);
+    size_t footprint = memoryFootprint();
+    while (footprint + cachedProcess->memoryFootprint() > m_memoryBudget) {
+        // Only make room for the new process if it is worth more than what it would replace.
+        auto it = lowestScoredProcess();
+        if (it == m_processesPerRegistrableDomain.end() || score(it->key, *it->value, now) >= newProcessScore) {
+            WEBPROCESSCACHE_RELEASE_LOG("addProcess: Not caching process because it does not fit in the memory budget (footprint=%zu, budget=%zu)", cachedProcess->process().processIdentifier(), cachedProcess->memoryFootprint(), m_memoryBudget);
+            return false;
+        }
+        WEBPROCESSCACHE_RELEASE_LOG("addProcess: Evicting process from WebProcess cache because the memory budget was reached", it->value->process().processIdentifier());
+        footprint -= it->value->memoryFootprint();
+        m_processesPerRegistrableDomain.remove(it);
+    }
+#endif
+
     while (m_processesPerRegistrableDomain.size() >= capacity()) {
+#if OS(LINUX)
+        auto it = lowestScoredProcess();
+#else
         auto it = m_processesPerRegistrableDomain.random();
+#endif
         WEBPROCESSCACHE_RELEASE_LOG("addProcess: Evicting process from WebProcess cache because capacity was reached", it->value->process().processIdentifier());
         m_processesPerRegistrableDomain.remove(it);
     }
@@ -176,16 +281,98 @@ void WebProcessCache::updateCapacity(WebProcessPool& processPool)
             m_capacity = 0;
             WEBPROCESSCACHE_RELEASE_LOG("updateCapacity: Cache is disabled because device does not have enough RAM", 0);
         } else {
+#if OS(LINUX)
+            // Processes are evicted by memory footprint against a sixteenth of the RAM, the count only bounds bookkeeping.
+            m_capacity = std::min<unsigned>(memorySize * 4, 100);
+            m_memoryBudget = ramSize() / 16;
+            WEBPROCESSCACHE_RELEASE_LOG("updateCapacity: Cache has a capacity of %u processes and a memory budget of %zu bytes", 0, capacity(), m_memoryBudget);
+#else
             // Allow 4 processes in the cache per GB of RAM, up to 30 processes.
             m_capacity = std::min<unsigned>(memorySize * 4, 30);
             WEBPROCESSCACHE_RELEASE_LOG("updateCapacity: Cache has a capacity of %u processes", 0, capacity());
+#endif
         }
     }
 
+#if OS(LINUX)
+    if (!m_capacity)
+        m_memoryBudget = 0;
+#endif
+
     if (!m_capacity)
         clear();
 }
 
+#if OS(LINUX)
+size_t WebProcessCache::memoryFootprint() const
+{
+    size_t footprint = 0;
+    for (auto& cachedProcess : m_processesPerRegistrableDomain.values())
+        footprint += cachedProcess->memoryFootprint();
+    return footprint;
+}
+
+void WebProcessCache::recordVisit(const WebCore::RegistrableDomain& registrableDomain)
+{
+    auto now = MonotonicTime::now();
+    auto& visits = m_domainVisits.add(registrableDomain, DomainVisits { }).iterator->value;
+    visits.frequency = visits.frequency * decayFactor(now - visits.lastVisitTime, visitFrequencyHalfLife) + 1;
+    visits.lastVisitTime = now;
+
+    if (m_domainVisits.size() > maximumDomainVisitsCount) {
+        m_domainVisits.removeIf([now](auto& entry) {
+            return entry.value.frequency * decayFactor(now - entry.value.lastVisitTime, visitFrequencyHalfLife) < 0.5;
+        });
+    }
+}
+
+// The value of keeping a process warm per MB: how often its domain is visited, faded by how long it has been idle.
+double WebProcessCache::score(const WebCore::RegistrableDomain& registrableDomain, const CachedProcess& cachedProcess, MonotonicTime now) const
+{
+    double frequency = 0;
+    auto it = m_domainVisits.find(registrableDomain);
+    if (it != m_domainVisits.end())
+        frequency = it->value.frequency * decayFactor(now - it->value.lastVisitTime, visitFrequencyHalfLife);
+
+    double recency = decayFactor(now - cachedProcess.cachedTime(), cachedProcessValueHalfLife);
+    double footprintInMB = std::max<double>(cachedProcess.memoryFootprint() / static_cast<double>(MB), 1);
+    return (1 + frequency) * recency / footprintInMB;
+}
+
+auto WebProcessCache::lowestScoredProcess() -> HashMap<WebCore::RegistrableDomain, std::unique_ptr<CachedProcess>>::iterator
+{
+    auto now = MonotonicTime::now();
+    auto lowest = m_processesPerRegistrableDomain.end();
+    double lowestScore = std::numeric_limits<double>::infinity();
+    for (auto it = m_processesPerRegistrableDomain.begin(); it != m_processesPerRegistrableDomain.end(); ++it) {
+        double processScore = score(it->key, *it->value, now);
+        if (processScore < lowestScore) {
+            lowest = it;
+            lowestScore = processScore;
+        }
+    }
+    return lowest;
+}
+
+bool WebProcessCache::shrinkForMemoryPressure()
+{
+    if (m_processesPerRegistrableDomain.isEmpty())
+        return false;
+
+    // Keep the most valuable half of the cached memory warm. If the pressure persists, the next shedding step,
+    // MemoryPressureSheddingStep::WebProcessCache, clears the rest.
+    size_t targetFootprint = memoryFootprint() / 2;
+    size_t footprint = memoryFootprint();
+    while (footprint > targetFootprint && !m_processesPerRegistrableDomain.isEmpty()) {
+        auto it = lowestScoredProcess();
+        WEBPROCESSCACHE_RELEASE_LOG("shrinkForMemoryPressure: Evicting process from WebProcess cache because of memory pressure", it->value->process().processIdentifier());
+        footprint -= it->value->memoryFootprint();
+        m_processesPerRegistrableDomain.remove(it);
+    }
+    return true;
+}
+#endif
+
 void WebProcessCache::clear()
 {
     if (m_pendingAddRequests.isEmpty() && m_processesPerRegistrableDomain.isEmpty())
@@ -264,6 +451,9 @@ WebProcessCache::CachedProcess::CachedProcess(Ref<WebProcessProxy>&& process)
     RELEASE_ASSERT_WITH_MESSAGE(!m_process->websiteDataStore().processes().contains(*m_process), "Only processes with pages should be registered with the data store");
     m_process->setIsInProcessCache(true);
     m_evictionTimer.startOneShot(cachedProcessLifetime);
+#if OS(LINUX)
+    m_cachedTime = MonotonicTime::now();
+#endif
 }
 
 WebProcessCache::CachedProcess::~CachedProcess()
@@ -29,6 +29,7 @@
 #include <WebCore/RegistrableDomain.h>
 #include <pal/SessionID.h>
 #include <wtf/HashMap.h>
+#include <wtf/MonotonicTime.h>
 #include <wtf/RunLoop.h>
 #include <wtf/text/WTFString.h>
 
@@ -51,6 +52,12 @@ public:
 
     unsigned size() const { return m_processesPerRegistrableDomain.size(); }
 
+#if OS(LINUX)
+    size_t memoryBudget() const { return m_memoryBudget; }
+    size_t memoryFootprint() const;
+    bool shrinkForMemoryPressure();
+#endif
+
     void clear();
     void setApplicationIsActive(bool);
 
@@ -72,22 +79,49 @@ private:
         Ref<WebProcessProxy> takeProcess();
         WebProcessProxy& process() { ASSERT(m_process); return *m_process; }
 
+#if OS(LINUX)
+        MonotonicTime cachedTime() const { return m_cachedTime; }
+        size_t memoryFootprint() const { return m_memoryFootprint; }
+        void setMemoryFootprint(size_t memoryFootprint) { m_memoryFootprint = memoryFootprint; }
+#endif
+
     private:
         void evictionTimerFired();
 
         RefPtr<WebProcessProxy> m_process;
         RunLoop::Timer<CachedProcess> m_evictionTimer;
+#if OS(LINUX)
+        MonotonicTime m_cachedTime;
+        size_t m_memoryFootprint { 0 };
+#endif
     };
 
     bool canCacheProcess(WebProcessProxy&) const;
     void platformInitialize();
     bool addProcess(std::unique_ptr<CachedProcess>&&);
 
+#if OS(LINUX)
+    struct DomainVisits {
+        double frequency { 0 };
+        MonotonicTime lastVisitTime;
+    };
+
+    void recordVisit(const WebCore::RegistrableDomain&);
+    double score(const WebCore::RegistrableDomain&, const CachedProcess&, MonotonicTime) const;
+    HashMap<WebCore::RegistrableDomain, std::unique_ptr<CachedProcess>>::iterator lowestScoredProcess();
+#endif
+
     unsigned m_capacity { 0 };
 
     HashMap<uint64_t, std::unique_ptr<CachedProcess>> m_pendingAddRequests;
     HashMap<WebCore::RegistrableDomain, std::unique_ptr<CachedProcess>> m_processesPerRegistrableDomain;
     RunLoop::Timer<WebProcessCache> m_evictionTimer;
+
+#if OS(LINUX)
+    // Cached processes are evicted by value per byte once their memory exceeds the budget.
+    size_t m_memoryBudget { 0 };
+    HashMap<WebCore::RegistrableDomain, DomainVisits> m_domainVisits;
+#endif
 };
 
 } // namespace WebKit
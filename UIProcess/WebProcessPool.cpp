@@ -444,6 +444,53 @@ void WebProcessPool::sendMemoryPressureEvent(bool isCritical)
     PluginProcessManager::singleton().sendMemoryPressureEvent(isCritical);
 #endif
 }
+
+bool WebProcessPool::shedMemory(MemoryPressureSheddingStep step)
+{
+    switch (step) {
+    case MemoryPressureSheddingStep::BackForwardCache:
+        if (!m_backForwardCache->size())
+            return false;
+        WEBPROCESSPOOL_RELEASE_LOG(PerformanceLogging, "shedMemory: Clearing the back/forward cache");
+        m_backForwardCache->clear();
+        return true;
+    case MemoryPressureSheddingStep::HalfOfWebProcessCache:
+        if (!m_webProcessCache->size())
+            return false;
+        WEBPROCESSPOOL_RELEASE_LOG(PerformanceLogging, "shedMemory: Shrinking the WebProcess cache");
+        return m_webProcessCache->shrinkForMemoryPressure();
+    case MemoryPressureSheddingStep::WebProcessCache:
+        if (!m_webProcessCache->size())
+            return false;
+        WEBPROCESSPOOL_RELEASE_LOG(PerformanceLogging, "shedMemory: Clearing the WebProcess cache");
+        m_webProcessCache->clear();
+        return true;
+    case MemoryPressureSheddingStep::PrewarmedProcess:
+        if (!m_prewarmedProcess)
+            return false;
+        WEBPROCESSPOOL_RELEASE_LOG(PerformanceLogging, "shedMemory: Shutting down the prewarmed process");
+        m_prewarmedProcess->shutDown();
+        ASSERT(!m_prewarmedProcess);
+        return true;
+    case MemoryPressureSheddingStep::BackgroundProcesses: {
+        bool didShedMemory = false;
+        for (auto& process : m_processes) {
+            if (!process->pageCount())
+                continue;
+            auto pages = process->pages();
+            if (std::any_of(pages.begin(), pages.end(), [](auto* page) { return page->isViewVisible(); }))
+                continue;
+            process->send(Messages::AuxiliaryProcess::DidReceiveMemoryPressureEvent(false), 0);
+            didShedMemory = true;
+        }
+        if (didShedMemory)
+            WEBPROCESSPOOL_RELEASE_LOG(PerformanceLogging, "shedMemory: Asked background processes to release memory");
+        return didShedMemory;
+    }
+    }
+    ASSERT_NOT_REACHED();
+    return false;
+}
 #endif
 
 void WebProcessPool::textCheckerStateChanged()
@@ -806,6 +853,7 @@ void WebProcessPool::initializeNewWebProcess(WebProcessProxy& process, WebsiteDa
 
     parameters.shouldAlwaysUseComplexTextCodePath = m_alwaysUsesComplexTextCodePath;
     parameters.shouldUseFontSmoothing = m_shouldUseFontSmoothing;
+    parameters.coalescesTouchMovesWithinDisplayFrame = m_configuration->coalescesInputEventsWithinDisplayFrame();
 
     parameters.terminationTimeout = 0_s;
 
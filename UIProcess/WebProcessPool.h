@@ -341,6 +341,18 @@ public:
     void fullKeyboardAccessModeChanged(bool fullKeyboardAccessEnabled);
 #if OS(LINUX)
     void sendMemoryPressureEvent(bool isCritical);
+
+    // Ordered from the cheapest to reclaim to the most disruptive. The back/forward cache goes first, like in
+    // handleMemoryPressureWarning(), as processes removed from it will likely be added to the WebProcess cache.
+    enum class MemoryPressureSheddingStep : uint8_t {
+        BackForwardCache,
+        HalfOfWebProcessCache,
+        WebProcessCache,
+        PrewarmedProcess,
+        BackgroundProcesses,
+    };
+    // Returns false if there was nothing to shed for that step.
+    bool shedMemory(MemoryPressureSheddingStep);
 #endif
     void textCheckerStateChanged();
 
@@ -734,6 +734,15 @@ void WebProcessProxy::updateBackForwardItem(const BackForwardListItemState& item
     }
 }
 
+void WebProcessProxy::getBackForwardItemState(const BackForwardItemIdentifier& itemID, CompletionHandler<void(Optional<BackForwardListItemState>&&)>&& completionHandler)
+{
+    auto* item = WebBackForwardListItem::itemForID(itemID);
+    if (!item || !isAllowedToUpdateBackForwardItem(*item))
+        return completionHandler(WTF::nullopt);
+
+    completionHandler(item->itemState());
+}
+
 #if ENABLE(NETSCAPE_PLUGIN_API)
 void WebProcessProxy::getPlugins(bool refresh, CompletionHandler<void(Vector<PluginInfo>&& plugins, Vector<PluginInfo>&& applicationPlugins, Optional<Vector<WebCore::SupportedPluginIdentifier>>&& supportedPluginIdentifiers)>&& completionHandler)
 {
@@ -73,6 +73,7 @@ class PageConfiguration;
 namespace WebCore {
 class DeferrableOneShotTimer;
 class ResourceRequest;
+struct BackForwardItemIdentifier;
 struct PluginInfo;
 struct PrewarmInformation;
 struct SecurityOriginData;
@@ -443,6 +444,7 @@ private:
 
     // IPC message handlers.
     void updateBackForwardItem(const BackForwardListItemState&);
+    void getBackForwardItemState(const WebCore::BackForwardItemIdentifier&, CompletionHandler<void(Optional<BackForwardListItemState>&&)>&&);
     void didDestroyFrame(WebCore::FrameIdentifier);
     void didDestroyUserGestureToken(uint64_t);
 
@@ -140,6 +140,32 @@ auto WebURLSchemeTask::didReceiveData(Ref<SharedBuffer>&& buffer) -> ExceptionTy
     return ExceptionType::None;
 }
 
+auto WebURLSchemeTask::didReceiveSharedData(Ref<SharedMemory>&& sharedMemory, size_t dataSize) -> ExceptionType
+{
+    ASSERT(RunLoop::isMain());
+    ASSERT(dataSize <= sharedMemory->size());
+
+    if (m_stopped)
+        return ExceptionType::TaskAlreadyStopped;
+
+    if (m_completed)
+        return ExceptionType::CompleteAlreadyCalled;
+
+    if (!m_responseSent)
+        return ExceptionType::NoResponseSent;
+
+    if (isSync())
+        return didReceiveData(SharedBuffer::create(static_cast<const char*>(sharedMemory->data()), dataSize));
+
+    SharedMemory::Handle handle;
+    if (!sharedMemory->createHandle(handle, SharedMemory::Protection::ReadOnly))
+        return didReceiveData(SharedBuffer::create(static_cast<const char*>(sharedMemory->data()), dataSize));
+
+    m_dataSent = true;
+    m_process->send(Messages::WebPage::URLSchemeTaskDidReceiveSharedData(m_urlSchemeHandler->identifier(), m_identifier, SharedMemory::IPCHandle { WTFMove(handle), dataSize }), m_webPageID);
+    return ExceptionType::None;
+}
+
 auto WebURLSchemeTask::didComplete(const ResourceError& error) -> ExceptionType
 {
     ASSERT(RunLoop::isMain());
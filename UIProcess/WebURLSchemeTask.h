@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "SharedMemory.h"
 #include "WebProcessProxy.h"
 #include <WebCore/ResourceRequest.h>
 #include <WebCore/ResourceResponse.h>
@@ -81,6 +82,8 @@ public:
     ExceptionType didPerformRedirection(WebCore::ResourceResponse&&, WebCore::ResourceRequest&&);
     ExceptionType didReceiveResponse(const WebCore::ResourceResponse&);
     ExceptionType didReceiveData(Ref<WebCore::SharedBuffer>&&);
+    // Shares the first dataSize bytes of the memory with the web process instead of copying them into a message.
+    ExceptionType didReceiveSharedData(Ref<SharedMemory>&&, size_t dataSize);
     ExceptionType didComplete(const WebCore::ResourceError&);
 
     void stop();
@@ -283,6 +283,8 @@ public:
     bool ignoreTLSErrors() const { return m_ignoreTLSErrors; }
     void setNetworkProxySettings(WebCore::SoupNetworkProxySettings&&);
     const WebCore::SoupNetworkProxySettings& networkProxySettings() const { return m_networkProxySettings; }
+    void setDownloadSegmentCount(unsigned);
+    unsigned downloadSegmentCount() const { return m_downloadSegmentCount; }
 #endif
 
     static void allowWebsiteDataRecordsForAllOrigins();
@@ -421,6 +423,7 @@ private:
     bool m_persistentCredentialStorageEnabled { true };
     bool m_ignoreTLSErrors { true };
     WebCore::SoupNetworkProxySettings m_networkProxySettings;
+    unsigned m_downloadSegmentCount { 1 };
 #endif
 
     WeakHashSet<WebProcessProxy> m_processes;
@@ -41,6 +41,7 @@ void WebsiteDataStore::platformSetNetworkParameters(WebsiteDataStoreParameters&
     networkSessionParameters.persistentCredentialStorageEnabled = m_persistentCredentialStorageEnabled;
     networkSessionParameters.ignoreTLSErrors = m_ignoreTLSErrors;
     networkSessionParameters.proxySettings = m_networkProxySettings;
+    networkSessionParameters.downloadSegmentCount = m_downloadSegmentCount;
 
     networkProcess().cookieManager().getCookiePersistentStorage(m_sessionID, networkSessionParameters.cookiePersistentStoragePath, networkSessionParameters.cookiePersistentStorageType);
 }
@@ -72,4 +73,14 @@ void WebsiteDataStore::setNetworkProxySettings(WebCore::SoupNetworkProxySettings
     networkProcess().send(Messages::NetworkProcess::SetNetworkProxySettings(m_sessionID, m_networkProxySettings), 0);
 }
 
+void WebsiteDataStore::setDownloadSegmentCount(unsigned segmentCount)
+{
+    segmentCount = std::max(segmentCount, 1U);
+    if (m_downloadSegmentCount == segmentCount)
+        return;
+
+    m_downloadSegmentCount = segmentCount;
+    networkProcess().send(Messages::NetworkProcess::SetDownloadSegmentCount(m_sessionID, m_downloadSegmentCount), 0);
+}
+
 } // namespace WebKit
@@ -333,8 +333,11 @@ void ViewGestureController::beginSwipeGesture(WebBackForwardListItem* targetItem
         m_currentSwipeSnapshot = snapshot;
 
         FloatSize viewSize(m_webPageProxy.viewSize());
-        if (snapshot->hasImage() && shouldUseSnapshotForSize(*snapshot, viewSize, 0))
-            m_currentSwipeSnapshotPattern = adoptRef(cairo_pattern_create_for_surface(snapshot->surface()));
+        if (snapshot->hasImage() && shouldUseSnapshotForSize(*snapshot, viewSize, 0)) {
+            // Compressed snapshots are decoded here; the pattern keeps the decoded surface alive until the swipe ends.
+            if (auto surface = snapshot->imageSurface())
+                m_currentSwipeSnapshotPattern = adoptRef(cairo_pattern_create_for_surface(surface.get()));
+        }
 
         Color color = snapshot->backgroundColor();
         if (color.isValid()) {
@@ -27,10 +27,137 @@
 #include "ViewSnapshotStore.h"
 
 #include <WebCore/CairoUtilities.h>
+#include <wtf/RunLoop.h>
 
 namespace WebKit {
 using namespace WebCore;
 
+// Snapshot images are compressed with a lossless run-length encoding of the XOR between each pixel and the one
+// above it. Page snapshots are dominated by flat areas and vertically repeated content, so this typically shrinks
+// them several times while encoding and decoding at memory bandwidth speed.
+// The stream is a sequence of 16-bit headers. If the top bit is set, the header is followed by one pixel repeated
+// (header & 0x7fff) + 1 times; otherwise it is followed by header + 1 literal pixels.
+static const uint16_t runFlag = 0x8000;
+static const size_t maximumTokenLength = 0x8000;
+static const size_t minimumRunLength = 3;
+
+template<typename T>
+static void appendValue(Vector<uint8_t>& buffer, T value)
+{
+    buffer.append(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+}
+
+static Vector<uint8_t> compressSurface(cairo_surface_t* surface)
+{
+    cairo_surface_flush(surface);
+
+    int width = cairo_image_surface_get_width(surface);
+    int height = cairo_image_surface_get_height(surface);
+    int stride = cairo_image_surface_get_stride(surface);
+    const unsigned char* data = cairo_image_surface_get_data(surface);
+    if (!data || width <= 0 || height <= 0)
+        return { };
+
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    Vector<uint32_t> deltas;
+    deltas.reserveInitialCapacity(pixelCount);
+    for (int y = 0; y < height; ++y) {
+        auto* row = reinterpret_cast<const uint32_t*>(data + y * stride);
+        auto* previousRow = y ? reinterpret_cast<const uint32_t*>(data + (y - 1) * stride) : nullptr;
+        for (int x = 0; x < width; ++x)
+            deltas.uncheckedAppend(previousRow ? row[x] ^ previousRow[x] : row[x]);
+    }
+
+    // Give up as soon as the encoding stops paying for itself.
+    size_t maximumCompressedSize = static_cast<size_t>(stride) * height / 2;
+    Vector<uint8_t> compressedImage;
+    size_t position = 0;
+    while (position < pixelCount) {
+        size_t runLength = 1;
+        while (position + runLength < pixelCount && runLength < maximumTokenLength && deltas[position + runLength] == deltas[position])
+            ++runLength;
+
+        if (runLength >= minimumRunLength) {
+            appendValue<uint16_t>(compressedImage, runFlag | (runLength - 1));
+            appendValue(compressedImage, deltas[position]);
+            position += runLength;
+        } else {
+            size_t literalEnd = position + 1;
+            while (literalEnd < pixelCount && literalEnd - position < maximumTokenLength) {
+                if (literalEnd + minimumRunLength <= pixelCount && deltas[literalEnd] == deltas[literalEnd + 1] && deltas[literalEnd] == deltas[literalEnd + 2])
+                    break;
+                ++literalEnd;
+            }
+            appendValue<uint16_t>(compressedImage, literalEnd - position - 1);
+            compressedImage.append(reinterpret_cast<const uint8_t*>(deltas.data() + position), (literalEnd - position) * sizeof(uint32_t));
+            position = literalEnd;
+        }
+
+        if (compressedImage.size() > maximumCompressedSize)
+            return { };
+    }
+
+    compressedImage.shrinkToFit();
+    return compressedImage;
+}
+
+static RefPtr<cairo_surface_t> decompressSurface(const Vector<uint8_t>& compressedImage, cairo_format_t format, const IntSize& size)
+{
+    auto surface = adoptRef(cairo_image_surface_create(format, size.width(), size.height()));
+    if (cairo_surface_status(surface.get()) != CAIRO_STATUS_SUCCESS)
+        return nullptr;
+
+    int width = size.width();
+    int height = size.height();
+    int stride = cairo_image_surface_get_stride(surface.get());
+    unsigned char* data = cairo_image_surface_get_data(surface.get());
+
+    int x = 0;
+    int y = 0;
+    auto writePixel = [&](uint32_t delta) {
+        auto* row = reinterpret_cast<uint32_t*>(data + y * stride);
+        row[x] = y ? delta ^ reinterpret_cast<const uint32_t*>(data + (y - 1) * stride)[x] : delta;
+        if (++x == width) {
+            x = 0;
+            ++y;
+        }
+    };
+
+    const uint8_t* position = compressedImage.data();
+    const uint8_t* end = position + compressedImage.size();
+    while (position < end && y < height) {
+        if (end - position < static_cast<ptrdiff_t>(sizeof(uint16_t)))
+            return nullptr;
+        uint16_t header;
+        memcpy(&header, position, sizeof(header));
+        position += sizeof(header);
+
+        size_t length = (header & ~runFlag) + 1;
+        size_t remainingPixels = static_cast<size_t>(height - y) * width - x;
+        if (length > remainingPixels)
+            return nullptr;
+
+        size_t valueCount = header & runFlag ? 1 : length;
+        if (static_cast<size_t>(end - position) < valueCount * sizeof(uint32_t))
+            return nullptr;
+
+        uint32_t value = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (!(header & runFlag) || !i) {
+                memcpy(&value, position, sizeof(value));
+                position += sizeof(value);
+            }
+            writePixel(value);
+        }
+    }
+
+    if (y != height)
+        return nullptr;
+
+    cairo_surface_mark_dirty(surface.get());
+    return surface;
+}
+
 Ref<ViewSnapshot> ViewSnapshot::create(RefPtr<cairo_surface_t>&& surface)
 {
     return adoptRef(*new ViewSnapshot(WTFMove(surface)));
@@ -39,13 +166,18 @@ Ref<ViewSnapshot> ViewSnapshot::create(RefPtr<cairo_surface_t>&& surface)
 ViewSnapshot::ViewSnapshot(RefPtr<cairo_surface_t>&& surface)
     : m_surface(WTFMove(surface))
 {
+    if (m_surface) {
+        m_size = { cairo_image_surface_get_width(m_surface.get()), cairo_image_surface_get_height(m_surface.get()) };
+        m_format = cairo_image_surface_get_format(m_surface.get());
+    }
+
     if (hasImage())
         ViewSnapshotStore::singleton().didAddImageToSnapshot(*this);
 }
 
 bool ViewSnapshot::hasImage() const
 {
-    return !!m_surface;
+    return m_surface || isCompressed();
 }
 
 void ViewSnapshot::clearImage()
@@ -56,30 +188,79 @@ void ViewSnapshot::clearImage()
     ViewSnapshotStore::singleton().willRemoveImageFromSnapshot(*this);
 
     m_surface = nullptr;
+    m_compressedImage.clear();
+}
+
+RefPtr<cairo_surface_t> ViewSnapshot::imageSurface() const
+{
+    if (m_surface)
+        return m_surface;
+
+    if (!isCompressed())
+        return nullptr;
+
+    auto surface = decompressSurface(m_compressedImage, m_format, m_size);
+    if (surface)
+        cairo_surface_set_device_scale(surface.get(), m_deviceScaleFactor, m_deviceScaleFactor);
+    return surface;
+}
+
+void ViewSnapshot::compressImage()
+{
+    if (!m_surface)
+        return;
+
+    // Only the surface is shared with the compression queue; the store checks that the snapshot is still alive
+    // and still holds that surface before swapping in the compressed image.
+    ViewSnapshotStore::singleton().compressionQueue().dispatch([snapshot = this, surface = m_surface]() mutable {
+        auto compressedImage = compressSurface(surface.get());
+        RunLoop::main().dispatch([snapshot, surface = WTFMove(surface), compressedImage = WTFMove(compressedImage)]() mutable {
+            ViewSnapshotStore::singleton().didCompressSnapshotImage(snapshot, surface.get(), WTFMove(compressedImage));
+        });
+    });
+}
+
+void ViewSnapshot::setCompressedImage(Vector<uint8_t>&& compressedImage)
+{
+    ASSERT(!compressedImage.isEmpty());
+    m_compressedImage = WTFMove(compressedImage);
+    m_surface = nullptr;
 }
 
 size_t ViewSnapshot::imageSizeInBytes() const
 {
     if (!m_surface)
-        return 0;
+        return m_compressedImage.size();
 
     cairo_surface_t* surface = m_surface.get();
     int stride = cairo_image_surface_get_stride(surface);
-    int height = cairo_image_surface_get_width(surface);
+    int height = cairo_image_surface_get_height(surface);
 
     return stride * height;
 }
 
-WebCore::IntSize ViewSnapshot::size() const
+WorkQueue& ViewSnapshotStore::compressionQueue()
 {
-    if (!m_surface)
-        return { };
+    if (!m_compressionQueue)
+        m_compressionQueue = WorkQueue::create("org.webkit.ViewSnapshotCompression", WorkQueue::Type::Serial, WorkQueue::QOS::Utility);
+    return *m_compressionQueue;
+}
 
-    cairo_surface_t* surface = m_surface.get();
-    int width = cairo_image_surface_get_width(surface);
-    int height = cairo_image_surface_get_height(surface);
+void ViewSnapshotStore::didCompressSnapshotImage(ViewSnapshot* snapshot, cairo_surface_t* surface, Vector<uint8_t>&& compressedImage)
+{
+    if (compressedImage.isEmpty())
+        return;
+
+    // The snapshot may have been destroyed or lost its image while it was being compressed. The surface is kept
+    // alive by the caller, so a new snapshot at the same address cannot hold it.
+    if (!m_snapshotsWithImages.contains(snapshot) || snapshot->surface() != surface)
+        return;
 
-    return { width, height };
+    size_t uncompressedSize = snapshot->imageSizeInBytes();
+    snapshot->setCompressedImage(WTFMove(compressedImage));
+    m_snapshotCacheSize -= uncompressedSize;
+    m_snapshotCacheSize += snapshot->imageSizeInBytes();
+    m_compressedImageBytes += snapshot->imageSizeInBytes();
 }
 
 } // namespace WebKit
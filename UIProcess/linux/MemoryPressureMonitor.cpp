@@ -29,10 +29,14 @@
 #if OS(LINUX)
 
 #include "WebProcessPool.h"
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <wtf/RunLoop.h>
 #include <wtf/Threading.h>
 #include <wtf/UniStdExtras.h>
 #include <wtf/text/CString.h>
@@ -58,6 +62,19 @@ static const char* s_cgroupMemoryPath = "/sys/fs/cgroup/%s/%s/%s";
 static const char* s_procMeminfo = "/proc/meminfo";
 static const char* s_procZoneinfo = "/proc/zoneinfo";
 static const char* s_procSelfCgroup = "/proc/self/cgroup";
+
+// Pressure Stall Information (Documentation/accounting/psi.rst). Writing "<some|full> <stall us> <window us>"
+// to the file arms a trigger, and poll() reports POLLPRI once tasks stalled on memory for that long within
+// the window. "some" means at least one task was stalled, "full" means all non-idle tasks were.
+static const char* s_procPressureMemory = "/proc/pressure/memory";
+// The kernel only accepts windows of at least 500ms, and a 2s window keeps short stalls, like a burst of page
+// cache reclaim, from being reported as pressure.
+static const char s_pressureStallTrigger[] = "some 150000 2000000";
+static const char s_pressureStallCriticalTrigger[] = "full 100000 2000000";
+// Averages above which a fake PSI file given in test mode reports pressure.
+static const double s_pressureStallAverageThreshold = 10;
+// Shedding starts over from the cheapest step after this long without pressure.
+static const Seconds s_sheddingStepResetInterval { 30_s };
 static const unsigned maxCgroupPath = 4096; // PATH_MAX = 4096 from (Linux) include/uapi/linux/limits.h
 
 #define CGROUP_V2_HIERARCHY 0
@@ -346,6 +363,193 @@ static bool tryOpeningForUnbufferedReading(FileHandle& handle, const char* fileP
     return false;
 }
 
+// Parses the "some" and "full" avg10 values of a PSI file, like:
+//
+// some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+// full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+static bool readPressureStallAverages(FILE* file, double& someAverage, double& fullAverage)
+{
+    if (!file || fseek(file, 0, SEEK_SET))
+        return false;
+
+    someAverage = fullAverage = -1;
+    char kind[5];
+    double average;
+    while (fscanf(file, "%4s avg10=%lf %*[^\n]\n", kind, &average) == 2) {
+        if (!strcmp(kind, "some"))
+            someAverage = average;
+        else if (!strcmp(kind, "full"))
+            fullAverage = average;
+    }
+    return someAverage >= 0;
+}
+
+static int openPressureStallTrigger(const char* trigger, size_t length)
+{
+    int fd = open(s_procPressureMemory, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) {
+        WTFLogAlways("MemoryPressureMonitor: could not open %s to arm trigger \"%s\": %s", s_procPressureMemory, trigger, strerror(errno));
+        return -1;
+    }
+
+    // The trailing NUL is part of the write, as the kernel expects.
+    if (write(fd, trigger, length) == -1) {
+        WTFLogAlways("MemoryPressureMonitor: could not arm pressure stall trigger \"%s\": %s", trigger, strerror(errno));
+        closeWithRetry(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Parses the cgroup v2 memory.events counters that mean the cgroup is being throttled or has hit its limit.
+static bool readCgroupMemoryEvents(int fd, uint64_t& highCount, uint64_t& limitCount)
+{
+    char buffer[512];
+    ssize_t length = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    if (length <= 0)
+        return false;
+    buffer[length] = '\0';
+
+    highCount = limitCount = 0;
+    char* savePointer = nullptr;
+    for (char* line = strtok_r(buffer, "\n", &savePointer); line; line = strtok_r(nullptr, "\n", &savePointer)) {
+        char name[32];
+        uint64_t value;
+        if (sscanf(line, "%31s %" SCNu64, name, &value) != 2)
+            continue;
+        if (!strcmp(name, "high"))
+            highCount = value;
+        else if (!strcmp(name, "max") || !strcmp(name, "oom"))
+            limitCount += value;
+    }
+    return true;
+}
+
+static int openCgroupMemoryEvents()
+{
+    FileHandle cgroupControllerFile;
+    if (!tryOpeningForUnbufferedReading(cgroupControllerFile, s_procSelfCgroup))
+        return -1;
+
+    CString controllerPath = getCgroupControllerPath(cgroupControllerFile.get(), "");
+    if (controllerPath.isNull())
+        return -1;
+
+    char path[maxCgroupPath];
+    snprintf(path, maxCgroupPath, s_cgroupMemoryPath, "/", controllerPath.data(), "memory.events");
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+static void notifyMemoryPressure(bool isCritical)
+{
+    RunLoop::main().dispatch([isCritical] {
+        MemoryPressureMonitor::singleton().handleMemoryPressure(isCritical);
+    });
+}
+
+bool MemoryPressureMonitor::startPressureStallMonitor()
+{
+    // Test mode: a regular file in PSI format, polled since triggers can't be armed on it.
+    if (const char* fakePressureStallFile = getenv("WEBKIT_MEMORY_PRESSURE_PSI_FILE")) {
+        CString path = fakePressureStallFile;
+        Thread::create("MemoryPressureMonitor", [path = WTFMove(path)] {
+            FileHandle file;
+            while (true) {
+                sleep(s_minPollingInterval);
+                // Reopen every time, so that tests can replace the file.
+                file.reset();
+                if (!tryOpeningForUnbufferedReading(file, path.data()))
+                    continue;
+                double someAverage, fullAverage;
+                if (!readPressureStallAverages(file.get(), someAverage, fullAverage))
+                    continue;
+                if (fullAverage >= s_pressureStallAverageThreshold)
+                    notifyMemoryPressure(true);
+                else if (someAverage >= s_pressureStallAverageThreshold)
+                    notifyMemoryPressure(false);
+            }
+        })->detach();
+        return true;
+    }
+
+    int triggerFD = openPressureStallTrigger(s_pressureStallTrigger, sizeof(s_pressureStallTrigger));
+    if (triggerFD == -1)
+        return false;
+
+    int criticalTriggerFD = openPressureStallTrigger(s_pressureStallCriticalTrigger, sizeof(s_pressureStallCriticalTrigger));
+    int memoryEventsFD = openCgroupMemoryEvents();
+
+    Thread::create("MemoryPressureMonitor", [triggerFD, criticalTriggerFD, memoryEventsFD] {
+        uint64_t highCount = 0, limitCount = 0;
+        if (memoryEventsFD != -1)
+            readCgroupMemoryEvents(memoryEventsFD, highCount, limitCount);
+
+        struct pollfd fds[3] = {
+            { triggerFD, POLLPRI, 0 },
+            { criticalTriggerFD, POLLPRI, 0 },
+            // kernfs reports changes to memory.events as POLLPRI (and POLLERR).
+            { memoryEventsFD, POLLPRI, 0 },
+        };
+        while (true) {
+            if (poll(fds, 3, -1) == -1) {
+                if (errno == EINTR)
+                    continue;
+                WTFLogAlways("MemoryPressureMonitor: polling pressure stall information failed: %s", strerror(errno));
+                return;
+            }
+
+            bool isUnderPressure = fds[0].revents & POLLPRI;
+            bool isCritical = fds[1].revents & POLLPRI;
+            if (fds[2].revents & (POLLPRI | POLLERR)) {
+                uint64_t newHighCount, newLimitCount;
+                if (readCgroupMemoryEvents(memoryEventsFD, newHighCount, newLimitCount)) {
+                    isUnderPressure |= newHighCount > highCount;
+                    isCritical |= newLimitCount > limitCount;
+                    highCount = newHighCount;
+                    limitCount = newLimitCount;
+                }
+            }
+
+            if (isCritical || isUnderPressure)
+                notifyMemoryPressure(isCritical);
+        }
+    })->detach();
+    return true;
+}
+
+void MemoryPressureMonitor::handleMemoryPressure(bool isCritical)
+{
+    ASSERT(RunLoop::isMain());
+
+    auto now = MonotonicTime::now();
+    if (now - m_lastMemoryPressureTime > s_sheddingStepResetInterval)
+        m_nextSheddingStep = 0;
+    m_lastMemoryPressureTime = now;
+
+    const auto& processPools = WebProcessPool::allProcessPools();
+    if (isCritical) {
+        for (auto* processPool : processPools) {
+            processPool->handleMemoryPressureWarning(Critical::Yes);
+            processPool->sendMemoryPressureEvent(true);
+        }
+        return;
+    }
+
+    // Shed the cheapest step that still frees something.
+    while (m_nextSheddingStep <= static_cast<unsigned>(WebProcessPool::MemoryPressureSheddingStep::BackgroundProcesses)) {
+        auto step = static_cast<WebProcessPool::MemoryPressureSheddingStep>(m_nextSheddingStep++);
+        bool didShedMemory = false;
+        for (auto* processPool : processPools)
+            didShedMemory |= processPool->shedMemory(step);
+        if (didShedMemory)
+            return;
+    }
+
+    // Every cheaper step was already taken, ask every process to release memory.
+    for (auto* processPool : processPools)
+        processPool->sendMemoryPressureEvent(false);
+}
+
 void MemoryPressureMonitor::start()
 {
     if (m_started)
@@ -353,6 +557,12 @@ void MemoryPressureMonitor::start()
 
     m_started = true;
 
+    if (!startPressureStallMonitor())
+        startPollingMonitor();
+}
+
+void MemoryPressureMonitor::startPollingMonitor()
+{
     Thread::create("MemoryPressureMonitor", [] {
         FileHandle memInfoFile, zoneInfoFile, cgroupControllerFile;
         CGroupMemoryController memoryController = CGroupMemoryController();
@@ -377,11 +587,8 @@ void MemoryPressureMonitor::start()
                 continue;
             }
 
-            if (usedPercentage >= s_memoryPresurePercentageThreshold) {
-                bool isCritical = (usedPercentage >= s_memoryPresurePercentageThresholdCritical);
-                for (auto* processPool : WebProcessPool::allProcessPools())
-                    processPool->sendMemoryPressureEvent(isCritical);
-            }
+            if (usedPercentage >= s_memoryPresurePercentageThreshold)
+                notifyMemoryPressure(usedPercentage >= s_memoryPresurePercentageThresholdCritical);
             pollInterval = pollIntervalForUsedMemoryPercentage(usedPercentage);
         }
     })->detach();
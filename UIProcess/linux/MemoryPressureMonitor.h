@@ -27,6 +27,7 @@
 
 #if OS(LINUX)
 
+#include <wtf/MonotonicTime.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/text/CString.h>
@@ -46,9 +47,18 @@ public:
 
     ~MemoryPressureMonitor();
 
+    // Called on the main thread for every pressure event. Memory is shed in priority order, cheapest first:
+    // the back/forward cache, cached processes, the prewarmed process, background processes, then all processes.
+    void handleMemoryPressure(bool isCritical);
+
 private:
     MemoryPressureMonitor() = default;
+    bool startPressureStallMonitor();
+    void startPollingMonitor();
+
     bool m_started { false };
+    unsigned m_nextSheddingStep { 0 };
+    MonotonicTime m_lastMemoryPressureTime;
 };
 
 class CGroupMemoryController {
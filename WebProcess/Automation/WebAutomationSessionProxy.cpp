@@ -912,6 +912,22 @@ void WebAutomationSessionProxy::snapshotRectForScreenshot(WebCore::PageIdentifie
     completionHandler(WTF::nullopt, WebCore::IntRect(frame->coreFrame()->mainFrame().view()->documentToClientRect(snapshotRect)));
 }
 
+void WebAutomationSessionProxy::documentRectForScreenshot(WebCore::PageIdentifier pageID, Optional<WebCore::FrameIdentifier> frameID, String nodeHandle, bool scrollIntoViewIfNeeded, bool clipToViewport, CompletionHandler<void(Optional<String>, WebCore::IntRect&&)>&& completionHandler)
+{
+    snapshotRectForScreenshot(pageID, frameID, nodeHandle, scrollIntoViewIfNeeded, clipToViewport, [pageID, frameID, completionHandler = WTFMove(completionHandler)] (Optional<String> errorString, WebCore::IntRect&& rect) mutable {
+        if (errorString) {
+            completionHandler(errorString, { });
+            return;
+        }
+
+        WebPage* page = WebProcess::singleton().webPage(pageID);
+        ASSERT(page);
+        auto* frame = frameID ? WebProcess::singleton().webFrame(*frameID) : &page->mainWebFrame();
+        ASSERT(frame && frame->coreFrame());
+        completionHandler(WTF::nullopt, WebCore::IntRect(frame->coreFrame()->mainFrame().view()->clientToDocumentRect(rect)));
+    });
+}
+
 void WebAutomationSessionProxy::getCookiesForFrame(WebCore::PageIdentifier pageID, Optional<WebCore::FrameIdentifier> frameID, CompletionHandler<void(Optional<String>, Vector<WebCore::Cookie>)>&& completionHandler)
 {
     WebPage* page = WebProcess::singleton().webPage(pageID);
@@ -41,6 +41,9 @@
 #include <WebCore/WebAudioBufferList.h>
 #include <mach/mach_time.h>
 #include <wtf/cocoa/MachSemaphore.h>
+#elif OS(LINUX)
+#include "SharedAudioRingBuffer.h"
+#include <WebCore/AudioIOCallback.h>
 #endif
 
 namespace WebKit {
@@ -48,6 +51,11 @@ namespace WebKit {
 // Allocate a ring buffer large enough to contain 2 seconds of audio.
 constexpr size_t ringBufferSizeInSecond = 2;
 
+#if OS(LINUX)
+// Bounds how long the render thread sleeps before re-checking whether it should exit.
+constexpr Seconds renderRequestTimeout { 100_ms };
+#endif
+
 using AudioDestination = WebCore::AudioDestination;
 using AudioIOCallback = WebCore::AudioIOCallback;
 
@@ -66,6 +74,10 @@ RemoteAudioDestinationProxy::RemoteAudioDestinationProxy(AudioIOCallback& callba
 #else
     : WebCore::AudioDestinationGStreamer(callback, numberOfOutputChannels, sampleRate)
     , m_numberOfOutputChannels(numberOfOutputChannels)
+#if OS(LINUX)
+    , m_sampleRate(sampleRate)
+    , m_outputBus(WebCore::AudioBus::create(numberOfOutputChannels, WebCore::AudioUtilities::renderQuantumSize))
+#endif
 #endif
     , m_inputDeviceId(inputDeviceId)
     , m_numberOfInputChannels(numberOfInputChannels)
@@ -88,6 +100,23 @@ void RemoteAudioDestinationProxy::startRenderingThread()
         } while (!m_shouldStopThread);
     };
     m_renderThread = Thread::create("RemoteAudioDestinationProxy render thread", WTFMove(offThreadRendering), ThreadType::Audio, Thread::QOS::UserInteractive);
+#elif OS(LINUX)
+    ASSERT(!m_renderThread);
+    if (!m_ringBuffer)
+        return;
+
+    m_shouldStopThread = false;
+    auto offThreadRendering = [this]() mutable {
+        while (!m_shouldStopThread) {
+            if (!m_ringBuffer->waitForRenderRequest(renderRequestTimeout))
+                continue;
+            if (m_shouldStopThread)
+                break;
+
+            renderQuantum();
+        }
+    };
+    m_renderThread = Thread::create("RemoteAudioDestinationProxy render thread", WTFMove(offThreadRendering), ThreadType::Audio, Thread::QOS::UserInteractive);
 #endif
 }
 
@@ -102,6 +131,15 @@ void RemoteAudioDestinationProxy::stopRenderingThread()
         m_renderSemaphore->signal();
     m_renderThread->waitForCompletion();
     m_renderThread = nullptr;
+#elif OS(LINUX)
+    if (!m_renderThread)
+        return;
+
+    m_shouldStopThread = true;
+    if (m_ringBuffer)
+        m_ringBuffer->wakeUpProducer();
+    m_renderThread->waitForCompletion();
+    m_renderThread = nullptr;
 #endif
 }
 
@@ -110,6 +148,8 @@ void RemoteAudioDestinationProxy::connectToGPUProcess()
     RemoteAudioDestinationIdentifier destinationID;
 #if PLATFORM(COCOA)
     MachSendRight renderSemaphoreSendRight;
+#elif OS(LINUX)
+    SharedMemory::IPCHandle ringBufferHandle;
 #endif
 
     auto& connection = WebProcess::singleton().ensureGPUProcessConnection();
@@ -119,6 +159,8 @@ void RemoteAudioDestinationProxy::connectToGPUProcess()
         Messages::RemoteAudioDestinationManager::CreateAudioDestination::Reply(destinationID
 #if PLATFORM(COCOA)
             , renderSemaphoreSendRight
+#elif OS(LINUX)
+            , ringBufferHandle
 #endif
         ), 0);
 
@@ -137,6 +179,11 @@ void RemoteAudioDestinationProxy::connectToGPUProcess()
     m_ringBuffer->allocate(streamFormat, m_numberOfFrames);
     m_audioBufferList = makeUnique<WebCore::WebAudioBufferList>(streamFormat);
     m_renderSemaphore = makeUnique<MachSemaphore>(WTFMove(renderSemaphoreSendRight));
+#elif OS(LINUX)
+    m_currentFrame = 0;
+    m_ringBuffer = ringBufferHandle.handle.isNull() ? nullptr : SharedAudioRingBuffer::map(ringBufferHandle.handle, ringBufferHandle.dataSize, numberOfOutputChannels());
+    if (!m_ringBuffer)
+        RELEASE_LOG_ERROR(Media, "RemoteAudioDestinationProxy::connectToGPUProcess: Failed to map the shared audio ring buffer");
 #endif
 
     startRenderingThread();
@@ -179,6 +226,17 @@ void RemoteAudioDestinationProxy::renderQuantum()
     AudioDestinationCocoa::render(m_currentFrame / static_cast<double>(m_sampleRate), mach_absolute_time(), WebCore::AudioUtilities::renderQuantumSize, m_audioBufferList->list());
     m_ringBuffer->store(m_audioBufferList->list(), WebCore::AudioUtilities::renderQuantumSize, m_currentFrame);
     m_currentFrame += WebCore::AudioUtilities::renderQuantumSize;
+#elif OS(LINUX)
+    constexpr size_t framesToRender = WebCore::AudioUtilities::renderQuantumSize;
+    WebCore::AudioIOPosition outputPosition { Seconds { m_currentFrame / static_cast<double>(m_sampleRate) }, MonotonicTime::now() };
+    callRenderCallback(nullptr, m_outputBus.get(), framesToRender, outputPosition);
+
+    Vector<const float*, 8> channels;
+    for (unsigned i = 0; i < m_outputBus->numberOfChannels(); ++i)
+        channels.append(m_outputBus->channel(i)->data());
+    // An overrun means the GPU process asked for more than fits, drop the quantum rather than block the audio thread.
+    m_ringBuffer->write(channels.data(), framesToRender);
+    m_currentFrame += framesToRender;
 #endif
 }
 
@@ -207,6 +265,8 @@ void RemoteAudioDestinationProxy::gpuProcessConnectionDidClose(GPUProcessConnect
     stopRenderingThread();
 #if PLATFORM(COCOA)
     m_renderSemaphore = nullptr;
+#elif OS(LINUX)
+    m_ringBuffer = nullptr;
 #endif
     connectToGPUProcess();
 
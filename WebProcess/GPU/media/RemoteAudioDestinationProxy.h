@@ -43,6 +43,7 @@
 #endif
 
 namespace WebCore {
+class AudioBus;
 class CARingBuffer;
 class WebAudioBufferList;
 }
@@ -55,6 +56,7 @@ class MachSemaphore;
 
 namespace WebKit {
 
+class SharedAudioRingBuffer;
 class SharedRingBufferFrameBounds;
 
 class RemoteAudioDestinationProxy final
@@ -88,7 +90,12 @@ private:
     // GPUProcessConnection::Client.
     void gpuProcessConnectionDidClose(GPUProcessConnection&) final;
 
-#if !PLATFORM(COCOA)
+#if !PLATFORM(COCOA) && OS(LINUX)
+    bool isPlaying() final { return m_isPlaying; }
+    void setIsPlaying(bool isPlaying) { m_isPlaying = isPlaying; }
+    float sampleRate() const final { return m_sampleRate; }
+    unsigned numberOfOutputChannels() const { return m_numberOfOutputChannels; }
+#elif !PLATFORM(COCOA)
     bool isPlaying() final { return false; }
     void setIsPlaying(bool) { }
     float sampleRate() const final { return 0; }
@@ -108,6 +115,13 @@ private:
     std::unique_ptr<WebCore::WebAudioBufferList> m_audioBufferList;
     uint64_t m_currentFrame { 0 };
     float m_sampleRate;
+#elif OS(LINUX)
+    unsigned m_numberOfOutputChannels;
+    float m_sampleRate;
+    bool m_isPlaying { false };
+    RefPtr<SharedAudioRingBuffer> m_ringBuffer;
+    RefPtr<WebCore::AudioBus> m_outputBus;
+    uint64_t m_currentFrame { 0 };
 #else
     unsigned m_numberOfOutputChannels;
 #endif
@@ -97,6 +97,8 @@ using namespace WebCore;
 
 WebLoaderStrategy::WebLoaderStrategy()
     : m_internallyFailedLoadTimer(RunLoop::main(), this, &WebLoaderStrategy::internallyFailedLoadTimerFired)
+    , m_pendingResourceLoadsTimer(RunLoop::main(), this, &WebLoaderStrategy::sendPendingResourceLoads)
+    , m_webResourceLoaderThreadReceiver(WebResourceLoaderThreadReceiver::create())
 {
 }
 
@@ -283,6 +285,24 @@ static void addParametersShared(const Frame* frame, NetworkResourceLoadParameter
     }
 }
 
+// Loads whose data goes to an image or media decoder, or to fetch() and XMLHttpRequest consumers, rather than to
+// a document parser. Their messages are decoded off the main thread.
+static bool shouldReceiveMessagesOffMainThread(const ResourceLoader& resourceLoader)
+{
+    if (resourceLoader.options().mode == FetchOptions::Mode::Navigate)
+        return false;
+
+    switch (resourceLoader.options().destination) {
+    case FetchOptions::Destination::EmptyString:
+    case FetchOptions::Destination::Image:
+    case FetchOptions::Destination::Audio:
+    case FetchOptions::Destination::Video:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void WebLoaderStrategy::scheduleLoadFromNetworkProcess(ResourceLoader& resourceLoader, const ResourceRequest& request, const WebResourceLoader::TrackingParameters& trackingParameters, bool shouldClearReferrerOnHTTPSToHTTPRedirect, Seconds maximumBufferingTime)
 {
     ResourceLoadIdentifier identifier = resourceLoader.identifier();
@@ -397,18 +417,47 @@ void WebLoaderStrategy::scheduleLoadFromNetworkProcess(ResourceLoader& resourceL
     ASSERT((loadParameters.webPageID && loadParameters.webFrameID) || loadParameters.clientCredentialPolicy == ClientCredentialPolicy::CannotAskClientForCredentials);
 
     WEBLOADERSTRATEGY_RELEASE_LOG_IF_ALLOWED("scheduleLoad: Resource is being scheduled with the NetworkProcess (priority=%d)", static_cast<int>(resourceLoader.request().priority()));
-    if (!WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::ScheduleResourceLoad(loadParameters), 0)) {
-        WEBLOADERSTRATEGY_RELEASE_LOG_ERROR_IF_ALLOWED("scheduleLoad: Unable to schedule resource with the NetworkProcess (priority=%d)", static_cast<int>(resourceLoader.request().priority()));
-        // We probably failed to schedule this load with the NetworkProcess because it had crashed.
-        // This load will never succeed so we will schedule it to fail asynchronously.
-        scheduleInternallyFailedLoad(resourceLoader);
-        return;
-    }
+    // Register before sending, so that no message for this load can reach the main thread directly.
+    if (shouldReceiveMessagesOffMainThread(resourceLoader))
+        m_webResourceLoaderThreadReceiver->addLoader(WebProcess::singleton().ensureNetworkProcessConnection().connection(), identifier);
+
+    m_pendingResourceLoads.append(WTFMove(loadParameters));
+    if (!m_pendingResourceLoadsTimer.isActive())
+        m_pendingResourceLoadsTimer.startOneShot(0_s);
 
     auto loader = WebResourceLoader::create(resourceLoader, trackingParameters);
     m_webResourceLoaders.set(identifier, WTFMove(loader));
 }
 
+void WebLoaderStrategy::sendPendingResourceLoads()
+{
+    m_pendingResourceLoadsTimer.stop();
+    if (m_pendingResourceLoads.isEmpty())
+        return;
+
+    NetworkResourceLoadParameters::Batch batch { std::exchange(m_pendingResourceLoads, { }) };
+    auto& connection = WebProcess::singleton().ensureNetworkProcessConnection().connection();
+    bool didSend;
+    if (batch.loads.size() == 1)
+        didSend = connection.send(Messages::NetworkConnectionToWebProcess::ScheduleResourceLoad(batch.loads[0]), 0);
+    else
+        didSend = connection.send(Messages::NetworkConnectionToWebProcess::ScheduleResourceLoads(batch), 0);
+    if (didSend)
+        return;
+
+    RELEASE_LOG_ERROR_IF_ALLOWED("sendPendingResourceLoads: Unable to schedule %zu resources with the NetworkProcess", batch.loads.size());
+    // We probably failed to schedule these loads with the NetworkProcess because it had crashed.
+    // They will never succeed so we will schedule them to fail asynchronously.
+    for (auto& loadParameters : batch.loads) {
+        m_webResourceLoaderThreadReceiver->removeLoader(loadParameters.identifier);
+        auto loader = m_webResourceLoaders.take(loadParameters.identifier);
+        if (!loader || !loader->resourceLoader())
+            continue;
+        scheduleInternallyFailedLoad(*loader->resourceLoader());
+        loader->detachFromCoreLoader();
+    }
+}
+
 void WebLoaderStrategy::scheduleInternallyFailedLoad(WebCore::ResourceLoader& resourceLoader)
 {
     m_internallyFailedResourceLoaders.add(&resourceLoader);
@@ -465,7 +514,13 @@ void WebLoaderStrategy::remove(ResourceLoader* resourceLoader)
     if (!loader)
         return;
 
-    WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::RemoveLoadIdentifier(identifier), 0);
+    m_webResourceLoaderThreadReceiver->removeLoader(identifier);
+    // A load that was not sent yet only needs to be dropped from the batch.
+    bool wasPending = m_pendingResourceLoads.removeFirstMatching([&](auto& loadParameters) {
+        return loadParameters.identifier == identifier;
+    });
+    if (!wasPending)
+        WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::RemoveLoadIdentifier(identifier), 0);
 
     // It's possible that this WebResourceLoader might be just about to message back to the NetworkProcess (e.g. ContinueWillSendRequest)
     // but there's no point in doing so anymore.
@@ -508,6 +563,9 @@ void WebLoaderStrategy::networkProcessCrashed()
     }
 
     m_webResourceLoaders.clear();
+    m_webResourceLoaderThreadReceiver->removeAllLoaders();
+    m_pendingResourceLoads.clear();
+    m_pendingResourceLoadsTimer.stop();
 
     auto pingLoadCompletionHandlers = WTFMove(m_pingLoadCompletionHandlers);
     for (auto& pingLoadCompletionHandler : pingLoadCompletionHandlers.values())
@@ -549,6 +607,9 @@ Optional<WebLoaderStrategy::SyncLoadResult> WebLoaderStrategy::tryLoadingSynchro
 
 void WebLoaderStrategy::loadResourceSynchronously(FrameLoader& frameLoader, unsigned long resourceLoadIdentifier, const ResourceRequest& request, ClientCredentialPolicy clientCredentialPolicy,  const FetchOptions& options, const HTTPHeaderMap& originalRequestHeaders, ResourceError& error, ResourceResponse& response, Vector<char>& data)
 {
+    // Keep the order in which the page started its loads.
+    sendPendingResourceLoads();
+
     auto* webFrameLoaderClient = toWebFrameLoaderClient(frameLoader.client());
     auto* webFrame = webFrameLoaderClient ? &webFrameLoaderClient->webFrame() : nullptr;
     auto* webPage = webFrame ? webFrame->page() : nullptr;
@@ -625,12 +686,14 @@ void WebLoaderStrategy::loadResourceSynchronously(FrameLoader& frameLoader, unsi
 
 void WebLoaderStrategy::pageLoadCompleted(Page& page)
 {
+    sendPendingResourceLoads();
     WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::PageLoadCompleted(WebPage::fromCorePage(page).identifier()), 0);
 }
 
 void WebLoaderStrategy::browsingContextRemoved(Frame& frame)
 {
     ASSERT(frame.page());
+    sendPendingResourceLoads();
     auto& page = WebPage::fromCorePage(*frame.page());
     WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::BrowsingContextRemoved(page.webPageProxyIdentifier(), page.identifier(), WebFrame::fromCoreFrame(frame)->frameID()), 0);
 }
@@ -698,6 +761,7 @@ void WebLoaderStrategy::startPingLoad(Frame& frame, ResourceRequest& request, co
     if (completionHandler)
         m_pingLoadCompletionHandlers.add(loadParameters.identifier, WTFMove(completionHandler));
 
+    sendPendingResourceLoads();
     WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::LoadPing { loadParameters }, 0);
 }
 
@@ -785,6 +849,8 @@ void WebLoaderStrategy::isResourceLoadFinished(CachedResource& resource, Complet
         callback(true);
         return;
     }
+    // The network process has to know about the load to tell whether it finished.
+    sendPendingResourceLoads();
     WebProcess::singleton().ensureNetworkProcessConnection().connection().sendWithAsyncReply(Messages::NetworkConnectionToWebProcess::IsResourceLoadFinished(resource.loader()->identifier()), WTFMove(callback), 0);
 }
 
@@ -806,6 +872,7 @@ void WebLoaderStrategy::setCaptureExtraNetworkLoadMetricsEnabled(bool enabled)
 ResourceResponse WebLoaderStrategy::responseFromResourceLoadIdentifier(uint64_t resourceLoadIdentifier)
 {
     ResourceResponse response;
+    sendPendingResourceLoads();
     WebProcess::singleton().ensureNetworkProcessConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::GetNetworkLoadInformationResponse { resourceLoadIdentifier }, Messages::NetworkConnectionToWebProcess::GetNetworkLoadInformationResponse::Reply { response }, 0);
     return response;
 }
@@ -813,6 +880,7 @@ ResourceResponse WebLoaderStrategy::responseFromResourceLoadIdentifier(uint64_t
 Vector<NetworkTransactionInformation> WebLoaderStrategy::intermediateLoadInformationFromResourceLoadIdentifier(uint64_t resourceLoadIdentifier)
 {
     Vector<NetworkTransactionInformation> information;
+    sendPendingResourceLoads();
     WebProcess::singleton().ensureNetworkProcessConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::GetNetworkLoadIntermediateInformation { resourceLoadIdentifier }, Messages::NetworkConnectionToWebProcess::GetNetworkLoadIntermediateInformation::Reply { information }, 0);
     return information;
 }
@@ -820,6 +888,7 @@ Vector<NetworkTransactionInformation> WebLoaderStrategy::intermediateLoadInforma
 NetworkLoadMetrics WebLoaderStrategy::networkMetricsFromResourceLoadIdentifier(uint64_t resourceLoadIdentifier)
 {
     NetworkLoadMetrics networkMetrics;
+    sendPendingResourceLoads();
     WebProcess::singleton().ensureNetworkProcessConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::TakeNetworkLoadInformationMetrics { resourceLoadIdentifier }, Messages::NetworkConnectionToWebProcess::TakeNetworkLoadInformationMetrics::Reply { networkMetrics }, 0);
     return networkMetrics;
 }
@@ -25,7 +25,9 @@
 
 #pragma once
 
+#include "NetworkResourceLoadParameters.h"
 #include "WebResourceLoader.h"
+#include "WebResourceLoaderThreadReceiver.h"
 #include <WebCore/LoaderStrategy.h>
 #include <WebCore/ResourceError.h>
 #include <WebCore/ResourceLoader.h>
@@ -95,6 +97,7 @@ private:
     void scheduleLoad(WebCore::ResourceLoader&, WebCore::CachedResource*, bool shouldClearReferrerOnHTTPSToHTTPRedirect);
     void scheduleInternallyFailedLoad(WebCore::ResourceLoader&);
     void internallyFailedLoadTimerFired();
+    void sendPendingResourceLoads();
     void startLocalLoad(WebCore::ResourceLoader&);
     bool tryLoadingUsingURLSchemeHandler(WebCore::ResourceLoader&, const WebResourceLoader::TrackingParameters&);
     
@@ -123,8 +126,13 @@ private:
 
     HashSet<RefPtr<WebCore::ResourceLoader>> m_internallyFailedResourceLoaders;
     RunLoop::Timer<WebLoaderStrategy> m_internallyFailedLoadTimer;
+
+    // Loads scheduled during this run loop iteration, sent together to the network process.
+    Vector<NetworkResourceLoadParameters> m_pendingResourceLoads;
+    RunLoop::Timer<WebLoaderStrategy> m_pendingResourceLoadsTimer;
     
     HashMap<unsigned long, RefPtr<WebResourceLoader>> m_webResourceLoaders;
+    Ref<WebResourceLoaderThreadReceiver> m_webResourceLoaderThreadReceiver;
     HashMap<unsigned long, WebURLSchemeTaskProxy*> m_urlSchemeTasks;
     HashMap<unsigned long, PingLoadCompletionHandler> m_pingLoadCompletionHandlers;
     HashMap<unsigned long, PreconnectCompletionHandler> m_preconnectCompletionHandlers;
@@ -210,6 +210,40 @@ void WebResourceLoader::didReceiveData(const IPC::DataReference& data, int64_t e
     m_coreLoader->didReceiveData(reinterpret_cast<const char*>(data.data()), data.size(), encodedDataLength, DataPayloadBytes);
 }
 
+void WebResourceLoader::didReceiveBuffer(Ref<SharedBuffer>&& buffer, int64_t encodedDataLength)
+{
+    LOG(Network, "(WebProcess) WebResourceLoader::didReceiveBuffer of size %zu for '%s'", buffer->size(), m_coreLoader->url().string().latin1().data());
+    ASSERT_WITH_MESSAGE(!m_isProcessingNetworkResponse, "Network process should not send data until we've validated the response");
+
+    if (UNLIKELY(m_interceptController.isIntercepting(m_coreLoader->identifier()))) {
+        m_interceptController.defer(m_coreLoader->identifier(), [this, protectedThis = makeRef(*this), buffer = WTFMove(buffer), encodedDataLength]() mutable {
+            if (m_coreLoader)
+                didReceiveBuffer(WTFMove(buffer), encodedDataLength);
+        });
+        return;
+    }
+
+    if (!m_numBytesReceived)
+        RELEASE_LOG_IF_ALLOWED("didReceiveBuffer: Started receiving data");
+    m_numBytesReceived += buffer->size();
+
+    m_coreLoader->didReceiveBuffer(WTFMove(buffer), encodedDataLength, DataPayloadBytes);
+}
+
+void WebResourceLoader::didReceiveDataInSharedMemory(SharedMemory::IPCHandle&& ipcHandle, int64_t encodedDataLength)
+{
+    if (ipcHandle.handle.isNull())
+        return;
+
+    auto sharedMemory = SharedMemory::map(ipcHandle.handle, SharedMemory::Protection::ReadOnly);
+    if (!sharedMemory || ipcHandle.dataSize > sharedMemory->size()) {
+        RELEASE_LOG_IF_ALLOWED("didReceiveDataInSharedMemory: Unable to map shared memory");
+        return;
+    }
+
+    didReceiveData({ static_cast<const uint8_t*>(sharedMemory->data()), static_cast<size_t>(ipcHandle.dataSize) }, encodedDataLength);
+}
+
 void WebResourceLoader::didFinishResourceLoad(const NetworkLoadMetrics& networkLoadMetrics)
 {
     LOG(Network, "(WebProcess) WebResourceLoader::didFinishResourceLoad for '%s'", m_coreLoader->url().string().latin1().data());
@@ -29,6 +29,7 @@
 #include "DataReference.h"
 #include "MessageSender.h"
 #include "ShareableResource.h"
+#include "SharedMemory.h"
 #include "WebPageProxyIdentifier.h"
 #include "WebResourceInterceptController.h"
 #include <WebCore/FrameIdentifier.h>
@@ -46,6 +47,7 @@ class ResourceError;
 class ResourceLoader;
 class ResourceRequest;
 class ResourceResponse;
+class SharedBuffer;
 }
 
 namespace WebKit {
@@ -74,6 +76,8 @@ public:
     bool isAlwaysOnLoggingAllowed() const;
 
 private:
+    friend class WebResourceLoaderThreadReceiver;
+
     WebResourceLoader(Ref<WebCore::ResourceLoader>&&, const TrackingParameters&);
 
     // IPC::MessageSender
@@ -84,6 +88,8 @@ private:
     void didSendData(uint64_t bytesSent, uint64_t totalBytesToBeSent);
     void didReceiveResponse(const WebCore::ResourceResponse&, bool needsContinueDidReceiveResponseMessage);
     void didReceiveData(const IPC::DataReference&, int64_t encodedDataLength);
+    void didReceiveDataInSharedMemory(SharedMemory::IPCHandle&&, int64_t encodedDataLength);
+    void didReceiveBuffer(Ref<WebCore::SharedBuffer>&&, int64_t encodedDataLength);
     void didFinishResourceLoad(const WebCore::NetworkLoadMetrics&);
     void didFailResourceLoad(const WebCore::ResourceError&);
     void didFailServiceWorkerLoad(const WebCore::ResourceError&);
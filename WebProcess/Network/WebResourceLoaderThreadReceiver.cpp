@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WebResourceLoaderThreadReceiver.h"
+
+#include "FormDataReference.h"
+#include "HandleMessage.h"
+#include "Logging.h"
+#include "SharedBufferDataReference.h"
+#include "WebCoreArgumentCoders.h"
+#include "WebLoaderStrategy.h"
+#include "WebProcess.h"
+#include "WebResourceLoader.h"
+#include "WebResourceLoaderMessages.h"
+#include <WebCore/NetworkLoadMetrics.h>
+#include <WebCore/ResourceError.h>
+#include <WebCore/ResourceRequest.h>
+#include <WebCore/ResourceResponse.h>
+
+namespace WebKit {
+using namespace WebCore;
+
+WebResourceLoaderThreadReceiver::WebResourceLoaderThreadReceiver()
+    : m_queue(WorkQueue::create("WebResourceLoaderThreadReceiver", WorkQueue::Type::Serial, WorkQueue::QOS::UserInitiated))
+{
+}
+
+void WebResourceLoaderThreadReceiver::addLoader(IPC::Connection& connection, ResourceLoadIdentifier identifier)
+{
+    ASSERT(RunLoop::isMain());
+
+    auto addResult = m_connections.add(identifier, makeRef(connection));
+    ASSERT_UNUSED(addResult, addResult.isNewEntry);
+    connection.addThreadMessageReceiver(Messages::WebResourceLoader::messageReceiverName(), this, identifier);
+}
+
+void WebResourceLoaderThreadReceiver::removeLoader(ResourceLoadIdentifier identifier)
+{
+    ASSERT(RunLoop::isMain());
+
+    // Messages already on the queue are dropped on the main thread, once the WebResourceLoader is gone.
+    if (auto connection = m_connections.take(identifier))
+        connection->removeThreadMessageReceiver(Messages::WebResourceLoader::messageReceiverName(), identifier);
+}
+
+void WebResourceLoaderThreadReceiver::removeAllLoaders()
+{
+    ASSERT(RunLoop::isMain());
+
+    for (auto& [identifier, connection] : std::exchange(m_connections, { }))
+        connection->removeThreadMessageReceiver(Messages::WebResourceLoader::messageReceiverName(), identifier);
+}
+
+void WebResourceLoaderThreadReceiver::dispatchToThread(Function<void()>&& function)
+{
+    m_queue->dispatch(WTFMove(function));
+}
+
+void WebResourceLoaderThreadReceiver::didReceiveMessage(IPC::Connection&, IPC::Decoder& decoder)
+{
+    ASSERT(!RunLoop::isMain());
+
+    auto identifier = decoder.destinationID();
+    if (decoder.messageName() == Messages::WebResourceLoader::DidReceiveData::name()) {
+        Optional<IPC::DataReference> data;
+        decoder >> data;
+        Optional<int64_t> encodedDataLength;
+        decoder >> encodedDataLength;
+        if (!data || !encodedDataLength) {
+            decoder.markInvalid();
+            return;
+        }
+        didReceiveData(identifier, SharedBuffer::create(data->data(), data->size()), *encodedDataLength);
+        return;
+    }
+    if (decoder.messageName() == Messages::WebResourceLoader::DidReceiveDataInSharedMemory::name()) {
+        Optional<SharedMemory::IPCHandle> ipcHandle;
+        decoder >> ipcHandle;
+        Optional<int64_t> encodedDataLength;
+        decoder >> encodedDataLength;
+        if (!ipcHandle || !encodedDataLength) {
+            decoder.markInvalid();
+            return;
+        }
+        if (ipcHandle->handle.isNull())
+            return;
+        auto sharedMemory = SharedMemory::map(ipcHandle->handle, SharedMemory::Protection::ReadOnly);
+        if (!sharedMemory || ipcHandle->dataSize > sharedMemory->size()) {
+            RELEASE_LOG_ERROR(Network, "WebResourceLoaderThreadReceiver::didReceiveMessage: Unable to map shared memory");
+            return;
+        }
+        didReceiveData(identifier, SharedBuffer::create(static_cast<const char*>(sharedMemory->data()), static_cast<size_t>(ipcHandle->dataSize)), *encodedDataLength);
+        return;
+    }
+
+    if (decoder.messageName() == Messages::WebResourceLoader::WillSendRequest::name())
+        return forwardToMainThread<Messages::WebResourceLoader::WillSendRequest>(decoder, &WebResourceLoader::willSendRequest);
+    if (decoder.messageName() == Messages::WebResourceLoader::DidSendData::name())
+        return forwardToMainThread<Messages::WebResourceLoader::DidSendData>(decoder, &WebResourceLoader::didSendData);
+    if (decoder.messageName() == Messages::WebResourceLoader::DidReceiveResponse::name())
+        return forwardToMainThread<Messages::WebResourceLoader::DidReceiveResponse>(decoder, &WebResourceLoader::didReceiveResponse);
+    if (decoder.messageName() == Messages::WebResourceLoader::DidFinishResourceLoad::name())
+        return forwardToMainThread<Messages::WebResourceLoader::DidFinishResourceLoad>(decoder, &WebResourceLoader::didFinishResourceLoad);
+    if (decoder.messageName() == Messages::WebResourceLoader::DidFailResourceLoad::name())
+        return forwardToMainThread<Messages::WebResourceLoader::DidFailResourceLoad>(decoder, &WebResourceLoader::didFailResourceLoad);
+    if (decoder.messageName() == Messages::WebResourceLoader::DidFailServiceWorkerLoad::name())
+        return forwardToMainThread<Messages::WebResourceLoader::DidFailServiceWorkerLoad>(decoder, &WebResourceLoader::didFailServiceWorkerLoad);
+    if (decoder.messageName() == Messages::WebResourceLoader::ServiceWorkerDidNotHandle::name())
+        return forwardToMainThread<Messages::WebResourceLoader::ServiceWorkerDidNotHandle>(decoder, &WebResourceLoader::serviceWorkerDidNotHandle);
+    if (decoder.messageName() == Messages::WebResourceLoader::DidBlockAuthenticationChallenge::name())
+        return forwardToMainThread<Messages::WebResourceLoader::DidBlockAuthenticationChallenge>(decoder, &WebResourceLoader::didBlockAuthenticationChallenge);
+    if (decoder.messageName() == Messages::WebResourceLoader::StopLoadingAfterXFrameOptionsOrContentSecurityPolicyDenied::name())
+        return forwardToMainThread<Messages::WebResourceLoader::StopLoadingAfterXFrameOptionsOrContentSecurityPolicyDenied>(decoder, &WebResourceLoader::stopLoadingAfterXFrameOptionsOrContentSecurityPolicyDenied);
+#if ENABLE(SHAREABLE_RESOURCE)
+    if (decoder.messageName() == Messages::WebResourceLoader::DidReceiveResource::name())
+        return forwardToMainThread<Messages::WebResourceLoader::DidReceiveResource>(decoder, &WebResourceLoader::didReceiveResource);
+#endif
+    decoder.markInvalid();
+}
+
+void WebResourceLoaderThreadReceiver::didReceiveData(ResourceLoadIdentifier identifier, Ref<SharedBuffer>&& buffer, int64_t encodedDataLength)
+{
+    LockHolder locker(m_pendingDataLock);
+    auto iterator = m_pendingData.find(identifier);
+    if (iterator != m_pendingData.end()) {
+        // The main thread has not picked up the previous chunk yet, deliver both at once.
+        iterator->value.buffer->append(buffer.get());
+        iterator->value.encodedDataLength += encodedDataLength;
+        return;
+    }
+    m_pendingData.add(identifier, PendingData { WTFMove(buffer), encodedDataLength });
+
+    RunLoop::main().dispatch([this, protectedThis = makeRef(*this), identifier] {
+        deliverPendingData(identifier, takePendingData(identifier));
+    });
+}
+
+auto WebResourceLoaderThreadReceiver::takePendingData(ResourceLoadIdentifier identifier) -> Optional<PendingData>
+{
+    LockHolder locker(m_pendingDataLock);
+    auto iterator = m_pendingData.find(identifier);
+    if (iterator == m_pendingData.end())
+        return WTF::nullopt;
+    auto pendingData = WTFMove(iterator->value);
+    m_pendingData.remove(iterator);
+    return pendingData;
+}
+
+void WebResourceLoaderThreadReceiver::deliverPendingData(ResourceLoadIdentifier identifier, Optional<PendingData>&& pendingData)
+{
+    ASSERT(RunLoop::isMain());
+
+    if (!pendingData)
+        return;
+    if (auto* loader = WebProcess::singleton().webLoaderStrategy().webResourceLoaderForIdentifier(identifier))
+        loader->didReceiveBuffer(WTFMove(pendingData->buffer), pendingData->encodedDataLength);
+}
+
+template<typename T, typename MF>
+void WebResourceLoaderThreadReceiver::forwardToMainThread(IPC::Decoder& decoder, MF function)
+{
+    Optional<typename IPC::CodingType<typename T::Arguments>::Type> arguments;
+    decoder >> arguments;
+    if (!arguments) {
+        decoder.markInvalid();
+        return;
+    }
+
+    // Data still waiting for the main thread goes with this message, so that later data can't overtake it.
+    auto identifier = decoder.destinationID();
+    RunLoop::main().dispatch([identifier, pendingData = takePendingData(identifier), arguments = WTFMove(*arguments), function]() mutable {
+        deliverPendingData(identifier, WTFMove(pendingData));
+        if (auto* loader = WebProcess::singleton().webLoaderStrategy().webResourceLoaderForIdentifier(identifier))
+            IPC::callMemberFunction(WTFMove(arguments), loader, function);
+    });
+}
+
+} // namespace WebKit
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "Connection.h"
+#include <WebCore/SharedBuffer.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/WorkQueue.h>
+
+namespace WebKit {
+
+typedef uint64_t ResourceLoadIdentifier;
+
+// Receives WebResourceLoader messages of selected loads on a background queue. Data is copied out of the IPC
+// message (or mapped shared memory) there, and consecutive chunks are coalesced, so that the main thread only
+// hands ready buffers to the ResourceLoader. Other messages are decoded on the queue and forwarded in order.
+class WebResourceLoaderThreadReceiver : public IPC::Connection::ThreadMessageReceiverRefCounted {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static Ref<WebResourceLoaderThreadReceiver> create() { return adoptRef(*new WebResourceLoaderThreadReceiver); }
+
+    void addLoader(IPC::Connection&, ResourceLoadIdentifier);
+    void removeLoader(ResourceLoadIdentifier);
+    void removeAllLoaders();
+
+    void didReceiveMessage(IPC::Connection&, IPC::Decoder&) final;
+
+private:
+    WebResourceLoaderThreadReceiver();
+
+    // IPC::Connection::ThreadMessageReceiver
+    void dispatchToThread(Function<void()>&&) final;
+
+    struct PendingData {
+        Ref<WebCore::SharedBuffer> buffer;
+        int64_t encodedDataLength { 0 };
+    };
+    void didReceiveData(ResourceLoadIdentifier, Ref<WebCore::SharedBuffer>&&, int64_t encodedDataLength);
+    Optional<PendingData> takePendingData(ResourceLoadIdentifier);
+    template<typename T, typename MF> void forwardToMainThread(IPC::Decoder&, MF);
+
+    static void deliverPendingData(ResourceLoadIdentifier, Optional<PendingData>&&);
+
+    Ref<WorkQueue> m_queue;
+
+    // Data received on the queue and not yet delivered to the main thread.
+    Lock m_pendingDataLock;
+    HashMap<ResourceLoadIdentifier, PendingData> m_pendingData;
+
+    // Main thread member.
+    HashMap<ResourceLoadIdentifier, Ref<IPC::Connection>> m_connections;
+};
+
+} // namespace WebKit
@@ -57,10 +57,10 @@ NetworkSendQueue WebSocketChannel::createMessageQueue(Document& document, WebSoc
 {
     return { document, [&channel](auto& utf8String) {
         channel.notifySendFrame(WebSocketFrame::OpCode::OpCodeText, utf8String.data(), utf8String.length());
-        channel.sendMessage(Messages::NetworkSocketChannel::SendString { IPC::DataReference { reinterpret_cast<const uint8_t*>(utf8String.data()), utf8String.length() } }, utf8String.length());
+        channel.sendFrame(WebSocketFrameBatch::FrameType::Text, reinterpret_cast<const uint8_t*>(utf8String.data()), utf8String.length());
     }, [&channel](const char* data, size_t byteLength) {
         channel.notifySendFrame(WebSocketFrame::OpCode::OpCodeBinary, data, byteLength);
-        channel.sendMessage(Messages::NetworkSocketChannel::SendData { IPC::DataReference { reinterpret_cast<const uint8_t*>(data), byteLength } }, byteLength);
+        channel.sendFrame(WebSocketFrameBatch::FrameType::Binary, reinterpret_cast<const uint8_t*>(data), byteLength);
     }, [&channel](ExceptionCode exceptionCode) {
         auto code = static_cast<int>(exceptionCode);
         channel.fail(makeString("Failed to load Blob: exception code = ", code));
@@ -72,6 +72,7 @@ WebSocketChannel::WebSocketChannel(Document& document, WebSocketChannelClient& c
     : m_document(makeWeakPtr(document))
     , m_client(makeWeakPtr(client))
     , m_messageQueue(createMessageQueue(document, *this))
+    , m_pendingFramesTimer(*this, &WebSocketChannel::flushPendingFrames)
     , m_inspector(document)
 {
     WebProcess::singleton().webSocketChannelManager().addChannel(*this);
@@ -149,12 +150,45 @@ void WebSocketChannel::decreaseBufferedAmount(size_t byteLength)
         m_client->didUpdateBufferedAmount(m_bufferedAmount);
 }
 
-template<typename T> void WebSocketChannel::sendMessage(T&& message, size_t byteLength)
+void WebSocketChannel::sendFrame(WebSocketFrameBatch::FrameType type, const uint8_t* data, size_t byteLength)
+{
+    if (byteLength >= WebSocketFrameBatch::largeFrameThreshold) {
+        if (auto sharedMemory = SharedMemory::allocate(byteLength)) {
+            SharedMemory::Handle handle;
+            if (sharedMemory->createHandle(handle, SharedMemory::Protection::ReadOnly)) {
+                memcpy(sharedMemory->data(), data, byteLength);
+                // Frames must reach the network process in order, send the ones batched so far first.
+                flushPendingFrames();
+                sendWithAsyncReply(Messages::NetworkSocketChannel::SendFrameInSharedMemory { type, SharedMemory::IPCHandle { WTFMove(handle), byteLength } }, [this, protectedThis = makeRef(*this), byteLength] {
+                    decreaseBufferedAmount(byteLength);
+                });
+                return;
+            }
+        }
+    }
+
+    m_pendingFrames.append(type, data, byteLength);
+    if (m_pendingFrames.byteLength() >= WebSocketFrameBatch::maximumByteLength) {
+        flushPendingFrames();
+        return;
+    }
+
+    if (!m_pendingFramesTimer.isActive())
+        m_pendingFramesTimer.startOneShot(0_s);
+}
+
+void WebSocketChannel::flushPendingFrames()
 {
-    CompletionHandler<void()> completionHandler = [this, protectedThis = makeRef(*this), byteLength] {
+    m_pendingFramesTimer.stop();
+    if (m_pendingFrames.isEmpty())
+        return;
+
+    // The network process acknowledges the whole batch once, after all of its frames were handed to the socket.
+    auto byteLength = m_pendingFrames.byteLength();
+    sendWithAsyncReply(Messages::NetworkSocketChannel::SendFrames { m_pendingFrames }, [this, protectedThis = makeRef(*this), byteLength] {
         decreaseBufferedAmount(byteLength);
-    };
-    sendWithAsyncReply(WTFMove(message), WTFMove(completionHandler));
+    });
+    m_pendingFrames.clear();
 }
 
 WebSocketChannel::SendResult WebSocketChannel::send(const String& message)
@@ -208,6 +242,7 @@ void WebSocketChannel::close(int code, const String& reason)
     WebSocketFrame closingFrame(WebSocketFrame::OpCodeClose, true, false, true);
     m_inspector.didSendWebSocketFrame(m_document.get(), closingFrame);
 
+    flushPendingFrames();
     MessageSender::send(Messages::NetworkSocketChannel::Close { code, reason });
 }
 
@@ -233,6 +268,8 @@ void WebSocketChannel::disconnect()
     m_document = nullptr;
     m_pendingTasks.clear();
     m_messageQueue.clear();
+    m_pendingFrames.clear();
+    m_pendingFramesTimer.stop();
 
 
     m_inspector.didCloseWebSocket(m_document.get());
@@ -278,6 +315,33 @@ static inline WebSocketFrame createWebSocketFrameForWebInspector(const char* dat
     return frame;
 }
 
+void WebSocketChannel::didReceiveFrames(WebSocketFrameBatch&& frames)
+{
+    auto protectedThis = makeRef(*this);
+    frames.forEachFrame([&](auto type, auto* data, size_t length) {
+        switch (type) {
+        case WebSocketFrameBatch::FrameType::Text:
+            didReceiveText(String::fromUTF8(data, length));
+            break;
+        case WebSocketFrameBatch::FrameType::Binary:
+            didReceiveBinaryData(Vector<uint8_t> { data, length });
+            break;
+        }
+    });
+}
+
+void WebSocketChannel::didReceiveBinaryDataInSharedMemory(SharedMemory::IPCHandle&& ipcHandle)
+{
+    if (ipcHandle.handle.isNull())
+        return;
+
+    auto sharedMemory = SharedMemory::map(ipcHandle.handle, SharedMemory::Protection::ReadOnly);
+    if (!sharedMemory || ipcHandle.dataSize > sharedMemory->size())
+        return;
+
+    didReceiveBinaryData(Vector<uint8_t> { static_cast<const uint8_t*>(sharedMemory->data()), static_cast<size_t>(ipcHandle.dataSize) });
+}
+
 void WebSocketChannel::didReceiveText(String&& message)
 {
     if (m_isClosing)
@@ -298,7 +362,7 @@ void WebSocketChannel::didReceiveText(String&& message)
     m_client->didReceiveMessage(message);
 }
 
-void WebSocketChannel::didReceiveBinaryData(IPC::DataReference&& data)
+void WebSocketChannel::didReceiveBinaryData(Vector<uint8_t>&& data)
 {
     if (m_isClosing)
         return;
@@ -307,7 +371,7 @@ void WebSocketChannel::didReceiveBinaryData(IPC::DataReference&& data)
         return;
 
     if (m_isSuspended) {
-        enqueueTask([this, data = data.vector()] () mutable {
+        enqueueTask([this, data = WTFMove(data)] () mutable {
             if (!m_isClosing && m_client)
                 m_client->didReceiveBinaryData(WTFMove(data));
         });
@@ -316,7 +380,7 @@ void WebSocketChannel::didReceiveBinaryData(IPC::DataReference&& data)
 
     m_inspector.didReceiveWebSocketFrame(m_document.get(), createWebSocketFrameForWebInspector(reinterpret_cast<const char*>(data.data()), data.size(), WebSocketFrame::OpCode::OpCodeBinary));
 
-    m_client->didReceiveBinaryData(data.vector());
+    m_client->didReceiveBinaryData(WTFMove(data));
 }
 
 void WebSocketChannel::didClose(unsigned short code, String&& reason)
@@ -28,10 +28,13 @@
 #include "DataReference.h"
 #include "MessageReceiver.h"
 #include "MessageSender.h"
+#include "SharedMemory.h"
+#include "WebSocketFrameBatch.h"
 #include <WebCore/NetworkSendQueue.h>
 #include <WebCore/ResourceRequest.h>
 #include <WebCore/ResourceResponse.h>
 #include <WebCore/ThreadableWebSocketChannel.h>
+#include <WebCore/Timer.h>
 #include <WebCore/WebSocketChannelInspector.h>
 #include <WebCore/WebSocketFrame.h>
 #include <wtf/WeakPtr.h>
@@ -81,8 +84,10 @@ private:
 
     // Message receivers
     void didConnect(String&& subprotocol, String&& extensions);
+    void didReceiveFrames(WebSocketFrameBatch&&);
+    void didReceiveBinaryDataInSharedMemory(SharedMemory::IPCHandle&&);
     void didReceiveText(String&&);
-    void didReceiveBinaryData(IPC::DataReference&&);
+    void didReceiveBinaryData(Vector<uint8_t>&&);
     void didClose(unsigned short code, String&&);
     void didReceiveMessageError(String&&);
     void didSendHandshakeRequest(WebCore::ResourceRequest&&);
@@ -94,7 +99,8 @@ private:
 
     bool increaseBufferedAmount(size_t);
     void decreaseBufferedAmount(size_t);
-    template<typename T> void sendMessage(T&&, size_t byteLength);
+    void sendFrame(WebSocketFrameBatch::FrameType, const uint8_t* data, size_t byteLength);
+    void flushPendingFrames();
     void enqueueTask(Function<void()>&&);
 
     unsigned long progressIdentifier() const final { return m_inspector.progressIdentifier(); }
@@ -113,6 +119,8 @@ private:
     bool m_isSuspended { false };
     Deque<Function<void()>> m_pendingTasks;
     WebCore::NetworkSendQueue m_messageQueue;
+    WebSocketFrameBatch m_pendingFrames;
+    WebCore::Timer m_pendingFramesTimer;
     WebCore::WebSocketChannelInspector m_inspector;
     WebCore::ResourceRequest m_handshakeRequest;
     WebCore::ResourceResponse m_handshakeResponse;
@@ -42,6 +42,10 @@
 namespace WebKit {
 using namespace WebCore;
 
+// Larger chunks are written once to shared memory whose handle the network process forwards to the client
+// process as is, rather than being copied through the network process.
+static constexpr size_t minimumSizeForSharedMemoryTransfer = 64 * KB;
+
 WebServiceWorkerFetchTaskClient::WebServiceWorkerFetchTaskClient(Ref<IPC::Connection>&& connection, WebCore::ServiceWorkerIdentifier serviceWorkerIdentifier, WebCore::SWServerConnectionIdentifier serverConnectionIdentifier, FetchIdentifier fetchIdentifier, bool needsContinueDidReceiveResponseMessage)
     : m_connection(WTFMove(connection))
     , m_serverConnectionIdentifier(serverConnectionIdentifier)
@@ -84,9 +88,25 @@ void WebServiceWorkerFetchTaskClient::didReceiveData(Ref<SharedBuffer>&& buffer)
         return;
     }
 
+    if (buffer->size() >= minimumSizeForSharedMemoryTransfer && sendDataInSharedMemory(SharedMemory::copyBuffer(buffer.get()), buffer->size()))
+        return;
+
     m_connection->send(Messages::ServiceWorkerFetchTask::DidReceiveData { buffer.get(), static_cast<int64_t>(buffer->size()) }, m_fetchIdentifier);
 }
 
+bool WebServiceWorkerFetchTaskClient::sendDataInSharedMemory(RefPtr<SharedMemory>&& sharedMemory, size_t size)
+{
+    if (!sharedMemory)
+        return false;
+
+    SharedMemory::Handle handle;
+    if (!sharedMemory->createHandle(handle, SharedMemory::Protection::ReadOnly))
+        return false;
+
+    m_connection->send(Messages::ServiceWorkerFetchTask::DidReceiveDataInSharedMemory { SharedMemory::IPCHandle { WTFMove(handle), size }, static_cast<int64_t>(size) }, m_fetchIdentifier);
+    return true;
+}
+
 void WebServiceWorkerFetchTaskClient::didReceiveFormDataAndFinish(Ref<FormData>&& formData)
 {
     if (auto sharedBuffer = formData->asSharedBuffer()) {
@@ -135,6 +155,15 @@ void WebServiceWorkerFetchTaskClient::didReceiveBlobChunk(const char* data, size
     if (!m_connection)
         return;
 
+    if (size >= minimumSizeForSharedMemoryTransfer) {
+        auto sharedMemory = SharedMemory::allocate(size);
+        if (sharedMemory) {
+            memcpy(sharedMemory->data(), data, size);
+            if (sendDataInSharedMemory(WTFMove(sharedMemory), size))
+                return;
+        }
+    }
+
     m_connection->send(Messages::ServiceWorkerFetchTask::DidReceiveData { { reinterpret_cast<const uint8_t*>(data), size }, static_cast<int64_t>(size) }, m_fetchIdentifier);
 }
 
@@ -28,6 +28,7 @@
 #if ENABLE(SERVICE_WORKER)
 
 #include "Connection.h"
+#include "SharedMemory.h"
 #include <WebCore/FetchIdentifier.h>
 #include <WebCore/FetchLoader.h>
 #include <WebCore/FetchLoaderClient.h>
@@ -59,6 +60,7 @@ private:
 
     void cleanup();
     
+    bool sendDataInSharedMemory(RefPtr<SharedMemory>&&, size_t);
     void didReceiveBlobChunk(const char* data, size_t size);
     void didFinishBlobLoading();
 
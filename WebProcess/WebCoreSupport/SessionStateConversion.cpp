@@ -189,11 +189,16 @@ static void applyFrameState(HistoryItem& historyItem, const FrameState& frameSta
 Ref<HistoryItem> toHistoryItem(const BackForwardListItemState& itemState)
 {
     Ref<HistoryItem> historyItem = HistoryItem::create(itemState.pageState.mainFrameState.urlString, itemState.pageState.title, { }, itemState.identifier);
-    historyItem->setShouldOpenExternalURLsPolicy(itemState.pageState.shouldOpenExternalURLsPolicy);
-    historyItem->setStateObject(itemState.pageState.sessionStateObject.get());
-    applyFrameState(historyItem, itemState.pageState.mainFrameState);
+    applyBackForwardListItemState(historyItem, itemState);
 
     return historyItem;
 }
 
+void applyBackForwardListItemState(HistoryItem& historyItem, const BackForwardListItemState& itemState)
+{
+    historyItem.setShouldOpenExternalURLsPolicy(itemState.pageState.shouldOpenExternalURLsPolicy);
+    historyItem.setStateObject(itemState.pageState.sessionStateObject.get());
+    applyFrameState(historyItem, itemState.pageState.mainFrameState);
+}
+
 } // namespace WebKit
@@ -37,5 +37,6 @@ struct BackForwardListItemState;
 
 BackForwardListItemState toBackForwardListItemState(const WebCore::HistoryItem&);
 Ref<WebCore::HistoryItem> toHistoryItem(const BackForwardListItemState&);
+void applyBackForwardListItemState(WebCore::HistoryItem&, const BackForwardListItemState&);
 
 } // namespace WebKit
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ContentStreamSender.h"
+
+#include "WebPageProxyMessages.h"
+#include "WebProcess.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/RunLoop.h>
+#include <wtf/text/StringView.h>
+
+namespace WebKit {
+
+static const size_t contentStreamChunkSize = 1024 * 1024;
+static const Seconds contentStreamTimeSlice = 8_ms;
+// Characters converted to UTF-8 at once, so that long strings are never converted as a whole.
+static const unsigned contentStreamUTF8ConversionLength = 64 * 1024;
+
+ContentStreamSender::ContentStreamSender(WebCore::PageIdentifier pageID, uint64_t streamID, Producer&& producer)
+    : m_pageID(pageID)
+    , m_streamID(streamID)
+    , m_producer(WTFMove(producer))
+{
+}
+
+void ContentStreamSender::start()
+{
+    scheduleProduce();
+}
+
+void ContentStreamSender::scheduleProduce()
+{
+    if (m_isProduceScheduled)
+        return;
+
+    m_isProduceScheduled = true;
+    RunLoop::main().dispatch([protectedThis = makeRef(*this)] {
+        protectedThis->m_isProduceScheduled = false;
+        protectedThis->produce();
+    });
+}
+
+void ContentStreamSender::produce()
+{
+    auto deadline = MonotonicTime::now() + contentStreamTimeSlice;
+    while (m_producer && !m_failed && m_pendingData.size() < contentStreamChunkSize) {
+        if (!m_producer(*this)) {
+            m_producer = nullptr;
+            break;
+        }
+
+        if (MonotonicTime::now() >= deadline) {
+            scheduleProduce();
+            return;
+        }
+    }
+
+    sendChunk();
+}
+
+void ContentStreamSender::append(const uint8_t* data, size_t size)
+{
+    if (!m_failed)
+        m_pendingData.append(data, size);
+}
+
+void ContentStreamSender::appendUTF8(StringView string)
+{
+    for (unsigned offset = 0; offset < string.length() && !m_failed;) {
+        unsigned length = std::min(contentStreamUTF8ConversionLength, string.length() - offset);
+        // Keep surrogate pairs together.
+        if (offset + length < string.length() && U16_IS_LEAD(string[offset + length - 1]))
+            --length;
+
+        auto utf8 = string.substring(offset, length).utf8();
+        append(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length());
+        offset += length;
+    }
+}
+
+void ContentStreamSender::sendChunk()
+{
+    if (m_isWaitingForChunkReply)
+        return;
+
+    if (m_failed || m_pendingData.isEmpty()) {
+        if (m_failed || !m_producer)
+            finish();
+        else
+            scheduleProduce();
+        return;
+    }
+
+    // The shared memory is reused for every chunk, and only grows to the size of the largest one.
+    size_t chunkSize = std::min(m_pendingData.size(), contentStreamChunkSize);
+    if (!m_chunk || m_chunk->size() < chunkSize) {
+        m_chunk = SharedMemory::allocate(chunkSize);
+        if (!m_chunk) {
+            m_failed = true;
+            finish();
+            return;
+        }
+    }
+
+    SharedMemory::Handle handle;
+    if (!m_chunk->createHandle(handle, SharedMemory::Protection::ReadOnly)) {
+        m_failed = true;
+        finish();
+        return;
+    }
+
+    memcpy(m_chunk->data(), m_pendingData.data(), chunkSize);
+    m_pendingData.remove(0, chunkSize);
+    m_isWaitingForChunkReply = true;
+    WebProcess::singleton().parentProcessConnection()->sendWithAsyncReply(Messages::WebPageProxy::DidReceiveContentStreamChunk(m_streamID, SharedMemory::IPCHandle { WTFMove(handle), chunkSize }), [protectedThis = makeRef(*this)] {
+        protectedThis->didSendChunk();
+    }, m_pageID);
+}
+
+void ContentStreamSender::didSendChunk()
+{
+    m_isWaitingForChunkReply = false;
+    if (!m_producer || m_failed || m_pendingData.size() >= contentStreamChunkSize)
+        sendChunk();
+    else
+        scheduleProduce();
+}
+
+void ContentStreamSender::finish()
+{
+    m_producer = nullptr;
+    m_pendingData.clear();
+    m_chunk = nullptr;
+    WebProcess::singleton().parentProcessConnection()->send(Messages::WebPageProxy::DidFinishContentStream(m_streamID, !m_failed), m_pageID);
+}
+
+} // namespace WebKit
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "SharedMemory.h"
+#include <WebCore/PageIdentifier.h>
+#include <wtf/Forward.h>
+#include <wtf/Function.h>
+#include <wtf/RefCounted.h>
+#include <wtf/Vector.h>
+
+namespace WebKit {
+
+// Sends contents that can be too large for a single message, like the text of a whole page or an archive,
+// to the UI process as a sequence of shared memory chunks. The producer is called repeatedly until it has
+// appended everything, yielding to the run loop every few milliseconds so that the page stays responsive.
+// Only one chunk is in flight at a time: production pauses once the next chunk is ready and resumes when
+// the UI process has consumed the previous one, which also allows the shared memory to be reused.
+class ContentStreamSender : public RefCounted<ContentStreamSender> {
+public:
+    // Appends the next part of the contents, returns false once there is nothing left.
+    using Producer = Function<bool(ContentStreamSender&)>;
+
+    static Ref<ContentStreamSender> create(WebCore::PageIdentifier pageID, uint64_t streamID, Producer&& producer)
+    {
+        return adoptRef(*new ContentStreamSender(pageID, streamID, WTFMove(producer)));
+    }
+
+    void start();
+
+    void append(const uint8_t*, size_t);
+    void appendUTF8(StringView);
+    void fail() { m_failed = true; }
+
+private:
+    ContentStreamSender(WebCore::PageIdentifier, uint64_t streamID, Producer&&);
+
+    void scheduleProduce();
+    void produce();
+    void sendChunk();
+    void didSendChunk();
+    void finish();
+
+    WebCore::PageIdentifier m_pageID;
+    uint64_t m_streamID;
+    Producer m_producer;
+    Vector<uint8_t> m_pendingData;
+    RefPtr<SharedMemory> m_chunk;
+    bool m_isProduceScheduled { false };
+    bool m_isWaitingForChunkReply { false };
+    bool m_failed { false };
+};
+
+} // namespace WebKit
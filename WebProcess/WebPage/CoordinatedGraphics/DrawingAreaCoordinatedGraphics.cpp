@@ -416,6 +416,9 @@ void DrawingAreaCoordinatedGraphics::updateBackingStoreState(uint64_t stateID, b
         m_backingStoreStateID = stateID;
         m_shouldSendDidUpdateBackingStoreState = true;
 
+        // The UI process drops its mappings of the ring when it discards its backing store.
+        discardUpdateBitmapSlots();
+
         m_webPage.setDeviceScaleFactor(deviceScaleFactor);
         m_webPage.setSize(size);
         m_webPage.updateRendering();
@@ -476,6 +479,18 @@ void DrawingAreaCoordinatedGraphics::didUpdate()
     displayTimerFired();
 }
 
+void DrawingAreaCoordinatedGraphics::releaseUpdateBitmapSlot(uint32_t slot)
+{
+#if !USE(DIRECT2D)
+    if (slot >= m_updateBitmapSlots.size())
+        return;
+
+    m_updateBitmapSlots[slot].isInUse = false;
+#else
+    UNUSED_PARAM(slot);
+#endif
+}
+
 void DrawingAreaCoordinatedGraphics::sendDidUpdateBackingStoreState()
 {
     ASSERT(!m_isWaitingForDidUpdate);
@@ -492,6 +507,7 @@ void DrawingAreaCoordinatedGraphics::sendDidUpdateBackingStoreState()
             m_compositingAccordingToProxyMessages = false;
             return;
         }
+        discardUpdateBitmap(updateInfo);
     }
 
     ASSERT(m_shouldSendDidUpdateBackingStoreState);
@@ -582,6 +598,8 @@ void DrawingAreaCoordinatedGraphics::enterAcceleratedCompositingMode(GraphicsLay
     m_exitCompositingTimer.stop();
     m_wantsToExitAcceleratedCompositingMode = false;
 
+    discardUpdateBitmapSlots();
+
     auto changeWindowScreen = [&] {
         // In order to ensure that we get a unique DisplayRefreshMonitor per-DrawingArea (necessary because ThreadedDisplayRefreshMonitor
         // is driven by the ThreadedCompositor of the drawing area), give each page a unique DisplayID derived from WebPage's unique ID.
@@ -722,6 +740,7 @@ void DrawingAreaCoordinatedGraphics::display()
     if (m_layerTreeHost) {
         // The call to update caused layout which turned on accelerated compositing.
         // Don't send an Update message in this case.
+        discardUpdateBitmap(updateInfo);
         return;
     }
 
@@ -750,6 +769,68 @@ static bool shouldPaintBoundsRect(const IntRect& bounds, const Vector<IntRect, 1
     return wastedSpace <= wastedSpaceThreshold;
 }
 
+RefPtr<ShareableBitmap> DrawingAreaCoordinatedGraphics::updateBitmap(const IntSize& bitmapSize, UpdateInfo& updateInfo)
+{
+#if !USE(DIRECT2D)
+    // Ring bitmaps cover the whole view so that any update fits; the handle is only sent when a slot's bitmap is (re)created.
+    IntSize slotSize = m_webPage.size();
+    slotSize.scale(m_webPage.corePage()->deviceScaleFactor());
+    for (size_t i = 0; i < m_updateBitmapSlots.size(); ++i) {
+        auto& slot = m_updateBitmapSlots[i];
+        if (slot.isInUse)
+            continue;
+
+        if (!slot.bitmap || slot.bitmap->size() != slotSize) {
+            slot.bitmap = ShareableBitmap::createShareable(slotSize, { });
+            if (!slot.bitmap || !slot.bitmap->createHandle(updateInfo.bitmapHandle)) {
+                slot.bitmap = nullptr;
+                break;
+            }
+        }
+
+        ASSERT(IntRect(IntPoint(), slotSize).contains(IntRect(IntPoint(), bitmapSize)));
+        slot.isInUse = true;
+        updateInfo.bitmapSlot = i;
+        return slot.bitmap;
+    }
+#endif
+
+    // All slots are still held by the UI process, use a one-off bitmap for this update.
+    auto bitmap = ShareableBitmap::createShareable(bitmapSize, { });
+    if (!bitmap)
+        return nullptr;
+
+    if (!bitmap->createHandle(updateInfo.bitmapHandle))
+        return nullptr;
+
+    return bitmap;
+}
+
+void DrawingAreaCoordinatedGraphics::discardUpdateBitmap(const UpdateInfo& updateInfo)
+{
+#if !USE(DIRECT2D)
+    if (!updateInfo.bitmapSlot)
+        return;
+
+    auto& slot = m_updateBitmapSlots[*updateInfo.bitmapSlot];
+    slot.isInUse = false;
+    // The UI process never saw this bitmap, so it can't be reused without sending its handle again.
+    if (!updateInfo.bitmapHandle.isNull())
+        slot.bitmap = nullptr;
+#else
+    UNUSED_PARAM(updateInfo);
+#endif
+}
+
+void DrawingAreaCoordinatedGraphics::discardUpdateBitmapSlots()
+{
+#if !USE(DIRECT2D)
+    // Slots still in use are freed when the UI process releases them, so only the bitmaps are dropped here.
+    for (auto& slot : m_updateBitmapSlots)
+        slot.bitmap = nullptr;
+#endif
+}
+
 void DrawingAreaCoordinatedGraphics::display(UpdateInfo& updateInfo)
 {
     ASSERT(!m_isPaintingSuspended);
@@ -774,13 +855,10 @@ void DrawingAreaCoordinatedGraphics::display(UpdateInfo& updateInfo)
     IntSize bitmapSize = bounds.size();
     float deviceScaleFactor = m_webPage.corePage()->deviceScaleFactor();
     bitmapSize.scale(deviceScaleFactor);
-    auto bitmap = ShareableBitmap::createShareable(bitmapSize, { });
+    auto bitmap = updateBitmap(bitmapSize, updateInfo);
     if (!bitmap)
         return;
 
-    if (!bitmap->createHandle(updateInfo.bitmapHandle))
-        return;
-
     auto rects = m_dirtyRegion.rects();
     if (shouldPaintBoundsRect(bounds, rects)) {
         rects.clear();
@@ -803,8 +881,12 @@ void DrawingAreaCoordinatedGraphics::display(UpdateInfo& updateInfo)
     updateInfo.updateRectBounds = bounds;
 
     for (const auto& rect : rects) {
-        if (graphicsContext)
+        if (graphicsContext) {
+            // Ring bitmaps still hold a previous frame, which must not show through transparent content.
+            if (updateInfo.bitmapSlot)
+                graphicsContext->clearRect(rect);
             m_webPage.drawRect(*graphicsContext, rect);
+        }
         updateInfo.updateRects.append(rect);
     }
 
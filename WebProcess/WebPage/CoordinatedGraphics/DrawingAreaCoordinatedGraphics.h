@@ -28,6 +28,7 @@
 #pragma once
 
 #include "DrawingArea.h"
+#include "UpdateInfo.h"
 #include <WebCore/Region.h>
 #include <wtf/RunLoop.h>
 
@@ -38,7 +39,6 @@ class GraphicsContext;
 namespace WebKit {
 
 class ShareableBitmap;
-class UpdateInfo;
 
 class DrawingAreaCoordinatedGraphics final : public DrawingArea {
 public:
@@ -83,6 +83,7 @@ private:
     // IPC message handlers.
     void updateBackingStoreState(uint64_t backingStoreStateID, bool respondImmediately, float deviceScaleFactor, const WebCore::IntSize&, const WebCore::IntSize& scrollOffset) override;
     void didUpdate() override;
+    void releaseUpdateBitmapSlot(uint32_t) override;
 
     void sendDidUpdateBackingStoreState();
 
@@ -100,6 +101,9 @@ private:
     void displayTimerFired();
     void display();
     void display(UpdateInfo&);
+    RefPtr<ShareableBitmap> updateBitmap(const WebCore::IntSize&, UpdateInfo&);
+    void discardUpdateBitmap(const UpdateInfo&);
+    void discardUpdateBitmapSlots();
 
     uint64_t m_backingStoreStateID { 0 };
 
@@ -144,6 +148,17 @@ private:
     // web process won't paint more frequent than the UI process can handle.
     bool m_isWaitingForDidUpdate { false };
 
+#if !USE(DIRECT2D)
+    // View-sized bitmaps that stay mapped in both processes, so that non-composited updates don't allocate
+    // and map a new bitmap every frame. A slot is in use from the time it is painted until the UI process
+    // sends ReleaseUpdateBitmapSlot.
+    struct UpdateBitmapSlot {
+        RefPtr<ShareableBitmap> bitmap;
+        bool isInUse { false };
+    };
+    std::array<UpdateBitmapSlot, UpdateInfo::bitmapSlotCount> m_updateBitmapSlots;
+#endif
+
     bool m_alwaysUseCompositing { false };
     bool m_supportsAsyncScrolling { true };
     bool m_forceRepaintAfterBackingStoreStateUpdate { false };
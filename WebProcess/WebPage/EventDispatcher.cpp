@@ -27,6 +27,7 @@
 #include "EventDispatcher.h"
 
 #include "EventDispatcherMessages.h"
+#include "Logging.h"
 #include "WebEventConversion.h"
 #include "WebPage.h"
 #include "WebPageProxyMessages.h"
@@ -38,6 +39,7 @@
 #include <wtf/MainThread.h>
 #include <wtf/RunLoop.h>
 #include <wtf/SystemTracing.h>
+#include <wtf/text/TextStream.h>
 
 #if ENABLE(ASYNC_SCROLLING)
 #include <WebCore/AsyncScrollingCoordinator.h>
@@ -192,12 +194,26 @@ void EventDispatcher::takeQueuedTouchEventsForPage(const WebPage& webPage, Touch
     destinationQueue = m_touchEvents.take(webPage.identifier());
 }
 
+// FIXME: This should be the refresh interval of the display the page is on.
+static constexpr Seconds touchEventDispatchFrameInterval = 1_s / 60;
+
+void EventDispatcher::setCoalescesTouchMovesWithinDisplayFrame(bool coalesces)
+{
+    LockHolder locker(&m_touchEventsLock);
+    m_coalescesTouchMovesWithinDisplayFrame = coalesces;
+}
+
 void EventDispatcher::touchEvent(PageIdentifier pageID, const WebKit::WebTouchEvent& touchEvent, Optional<CallbackID> callbackID)
 {
-    bool updateListWasEmpty;
+    bool shouldScheduleDispatch = false;
+    Seconds dispatchDelay;
     {
         LockHolder locker(&m_touchEventsLock);
-        updateListWasEmpty = m_touchEvents.isEmpty();
+        bool updateListWasEmpty = m_touchEvents.isEmpty();
+        auto now = MonotonicTime::now();
+        if (updateListWasEmpty)
+            m_oldestQueuedTouchEventTime = now;
+
         auto addResult = m_touchEvents.add(pageID, TouchEventQueue());
         if (addResult.isNewEntry)
             addResult.iterator->value.append({ touchEvent, callbackID });
@@ -211,13 +227,36 @@ void EventDispatcher::touchEvent(PageIdentifier pageID, const WebKit::WebTouchEv
             else
                 queuedEvents.append({ touchEvent, callbackID });
         }
+
+        // When enabled, touch moves are dispatched at most once per display frame, the ones received in between
+        // are coalesced. Any other event is dispatched right away, along with the moves queued before it.
+        bool canWaitForNextFrame = m_coalescesTouchMovesWithinDisplayFrame && touchEvent.type() == WebEvent::TouchMove && !callbackID;
+        if (updateListWasEmpty) {
+            shouldScheduleDispatch = true;
+            auto nextFrameTime = m_lastTouchEventDispatchTime + touchEventDispatchFrameInterval;
+            if (canWaitForNextFrame && now < nextFrameTime) {
+                dispatchDelay = nextFrameTime - now;
+                m_touchEventDispatchIsDelayed = true;
+            }
+        } else if (m_touchEventDispatchIsDelayed && !canWaitForNextFrame) {
+            shouldScheduleDispatch = true;
+            m_touchEventDispatchIsDelayed = false;
+        }
     }
 
-    if (updateListWasEmpty) {
-        RunLoop::main().dispatch([protectedThis = makeRef(*this)]() mutable {
+    if (!shouldScheduleDispatch)
+        return;
+
+    if (dispatchDelay > 0_s) {
+        RunLoop::main().dispatchAfter(dispatchDelay, [protectedThis = makeRef(*this)]() mutable {
             protectedThis->dispatchTouchEvents();
         });
+        return;
     }
+
+    RunLoop::main().dispatch([protectedThis = makeRef(*this)]() mutable {
+        protectedThis->dispatchTouchEvents();
+    });
 }
 
 void EventDispatcher::dispatchTouchEvents()
@@ -228,6 +267,14 @@ void EventDispatcher::dispatchTouchEvents()
     {
         LockHolder locker(&m_touchEventsLock);
         localCopy.swap(m_touchEvents);
+        // An earlier dispatch may already have delivered the events.
+        if (localCopy.isEmpty())
+            return;
+
+        auto now = MonotonicTime::now();
+        LOG_WITH_STREAM(TouchEvents, stream << "EventDispatcher::dispatchTouchEvents - dispatching touch events " << (now - m_oldestQueuedTouchEventTime).milliseconds() << "ms after receiving the oldest one");
+        m_lastTouchEventDispatchTime = now;
+        m_touchEventDispatchIsDelayed = false;
     }
 
     for (auto& slot : localCopy) {
@@ -34,6 +34,7 @@
 #include <memory>
 #include <wtf/HashMap.h>
 #include <wtf/Lock.h>
+#include <wtf/MonotonicTime.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/RefPtr.h>
 #include <wtf/ThreadingPrimitives.h>
@@ -69,6 +70,7 @@ public:
 #if ENABLE(IOS_TOUCH_EVENTS)
     using TouchEventQueue = Vector<std::pair<WebTouchEvent, Optional<CallbackID>>, 1>;
     void takeQueuedTouchEventsForPage(const WebPage&, TouchEventQueue&);
+    void setCoalescesTouchMovesWithinDisplayFrame(bool);
 #endif
 
     void initializeConnection(IPC::Connection*);
@@ -123,6 +125,10 @@ private:
 #if ENABLE(IOS_TOUCH_EVENTS)
     Lock m_touchEventsLock;
     HashMap<WebCore::PageIdentifier, TouchEventQueue> m_touchEvents;
+    MonotonicTime m_lastTouchEventDispatchTime;
+    MonotonicTime m_oldestQueuedTouchEventTime;
+    bool m_touchEventDispatchIsDelayed { false };
+    bool m_coalescesTouchMovesWithinDisplayFrame { false };
 #endif
 };
 
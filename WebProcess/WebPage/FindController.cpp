@@ -34,6 +34,7 @@
 #include "WebCoreArgumentCoders.h"
 #include "WebPage.h"
 #include "WebPageProxyMessages.h"
+#include <WebCore/Document.h>
 #include <WebCore/DocumentMarkerController.h>
 #include <WebCore/FloatQuad.h>
 #include <WebCore/FocusController.h>
@@ -48,6 +49,7 @@
 #include <WebCore/PluginDocument.h>
 #include <WebCore/Range.h>
 #include <WebCore/SimpleRange.h>
+#include <WebCore/TextIterator.h>
 
 #if PLATFORM(COCOA)
 #include <WebCore/TextIndicatorWindow.h>
@@ -72,8 +74,81 @@ WebCore::FindOptions core(OptionSet<FindOptions> options)
     return result;
 }
 
+static const unsigned countStringMatchesChunkLength = 16 * 1024;
+static const Seconds countStringMatchesTimeSlice = 5_ms;
+
+// The direction and wrapping only affect which match gets selected, not which ones are found. They must not
+// reach findPlainText() either, which would otherwise return the last match of the range instead of the first.
+static WebCore::FindOptions matchingOptions(WebCore::FindOptions options)
+{
+    options.remove({ WebCore::Backwards, WebCore::WrapAround, WebCore::DoNotRevealSelection });
+    return options;
+}
+
+static uint64_t domTreeVersion(Page& page)
+{
+    // Tree versions come from a single global counter, so the largest one changes whenever the tree of any frame does.
+    uint64_t version = 0;
+    for (Frame* frame = &page.mainFrame(); frame; frame = frame->tree().traverseNext()) {
+        if (auto* document = frame->document())
+            version = std::max(version, document->domTreeVersion());
+    }
+    return version;
+}
+
+// Searches don't return overlapping matches, so when a proper prefix of the string is also a suffix,
+// some occurrences are missing from the results. Non-ASCII characters are considered equal to any
+// other character since searches can ignore diacritics.
+static bool occurrencesCanOverlap(const String& string)
+{
+    auto lowercaseString = string.convertToASCIILowercase();
+    unsigned length = lowercaseString.length();
+    for (unsigned borderLength = 1; borderLength < length; ++borderLength) {
+        bool isBorder = true;
+        for (unsigned i = 0; i < borderLength && isBorder; ++i) {
+            UChar prefixCharacter = lowercaseString[i];
+            UChar suffixCharacter = lowercaseString[length - borderLength + i];
+            isBorder = !isASCII(prefixCharacter) || !isASCII(suffixCharacter) || prefixCharacter == suffixCharacter;
+        }
+        if (isBorder)
+            return true;
+    }
+    return false;
+}
+
+static Optional<SimpleRange> findMatchStartingAt(const BoundaryPoint& start, const String& string, WebCore::FindOptions options)
+{
+    // Case folding can make the matched text longer than the string, so leave some room for it.
+    SimpleRange remainingRange { start, makeBoundaryPointAfterNodeContents(start.document()) };
+    CharacterIterator iterator { remainingRange, TextIteratorEntersTextControls };
+    iterator.advance(2 * string.length());
+    auto match = findPlainText({ start, iterator.atEnd() ? remainingRange.end : iterator.range().start }, string, matchingOptions(options));
+    if (match.collapsed() || match.start.container.ptr() != start.container.ptr() || match.start.offset != start.offset)
+        return WTF::nullopt;
+    return match;
+}
+
+static int indexForSelection(Page& page, const Vector<SimpleRange>& matches)
+{
+    auto selectedRange = page.selection().firstRange();
+    if (!selectedRange)
+        return kWKFindResultNoMatchAfterUserSelection;
+
+    auto liveSelectedRange = createLiveRange(*selectedRange);
+    for (size_t i = 0; i < matches.size(); ++i) {
+        auto& start = matches[i].start;
+        if (&start.document() != &selectedRange->start.document())
+            continue;
+        auto comparison = liveSelectedRange->comparePoint(start.container.get(), start.offset);
+        if (!comparison.hasException() && comparison.returnValue() >= 0)
+            return static_cast<int>(i);
+    }
+    return kWKFindResultNoMatchAfterUserSelection;
+}
+
 FindController::FindController(WebPage* webPage)
     : m_webPage(webPage)
+    , m_countStringMatchesTimer(RunLoop::main(), this, &FindController::continueCountingStringMatches)
 {
 }
 
@@ -81,24 +156,192 @@ FindController::~FindController()
 {
 }
 
+FindController::TextMatches FindController::findTextMatches(const String& string, WebCore::FindOptions options, unsigned maxMatchCount)
+{
+    auto& page = *m_webPage->corePage();
+    if (auto refinedMatches = refinedFindMatches(string, options, maxMatchCount)) {
+        updateFindSession(string, options, maxMatchCount, *refinedMatches);
+        int index = indexForSelection(page, *refinedMatches);
+        return { WTFMove(*refinedMatches), index };
+    }
+
+    auto result = page.findTextMatches(string, options, maxMatchCount);
+    updateFindSession(string, options, maxMatchCount, result.ranges);
+    return { WTFMove(result.ranges), result.indexForSelection };
+}
+
+bool FindController::canUseFindSession(WebCore::FindOptions options) const
+{
+    // FIXME: Style changes can also reveal or hide text without touching the tree.
+    return m_findSession && m_findSession->options == matchingOptions(options) && m_findSession->domTreeVersion == domTreeVersion(*m_webPage->corePage());
+}
+
+Optional<Vector<SimpleRange>> FindController::refinedFindMatches(const String& string, WebCore::FindOptions options, unsigned maxMatchCount) const
+{
+    if (!canUseFindSession(options))
+        return WTF::nullopt;
+
+    // Every match of a string extending the previous one starts where a previous match does,
+    // as long as neither of them can overlap itself.
+    auto& previousString = m_findSession->string;
+    if (string.length() <= previousString.length() || !string.startsWith(previousString) || occurrencesCanOverlap(previousString) || occurrencesCanOverlap(string))
+        return WTF::nullopt;
+
+    Vector<SimpleRange> matches;
+    for (auto& previousMatch : m_findSession->matches) {
+        if (matches.size() >= maxMatchCount)
+            break;
+        if (auto match = findMatchStartingAt(previousMatch.start, string, options))
+            matches.append(WTFMove(*match));
+    }
+    return matches;
+}
+
+Optional<unsigned> FindController::findSessionMatchCount(const String& string, WebCore::FindOptions options)
+{
+    if (canUseFindSession(options) && m_findSession->string == string)
+        return m_findSession->matches.size();
+
+    auto refinedMatches = refinedFindMatches(string, options, std::numeric_limits<unsigned>::max());
+    if (!refinedMatches)
+        return WTF::nullopt;
+
+    updateFindSession(string, options, std::numeric_limits<unsigned>::max(), *refinedMatches);
+    return refinedMatches->size();
+}
+
+void FindController::updateFindSession(const String& string, WebCore::FindOptions options, unsigned maxMatchCount, const Vector<SimpleRange>& matches)
+{
+    // A search that stopped at the maximum may have missed some matches.
+    if (matches.size() >= maxMatchCount) {
+        m_findSession = WTF::nullopt;
+        return;
+    }
+
+    m_findSession = FindSession { string, matchingOptions(options), domTreeVersion(*m_webPage->corePage()), matches };
+}
+
 void FindController::countStringMatches(const String& string, OptionSet<FindOptions> options, unsigned maxMatchCount)
 {
     if (maxMatchCount == std::numeric_limits<unsigned>::max())
         --maxMatchCount;
-    
+
+    m_countStringMatchesTimer.stop();
+    m_pendingStringMatchCount = WTF::nullopt;
+
     auto* pluginView = WebPage::pluginViewForFrame(m_webPage->mainFrame());
-    
-    unsigned matchCount;
-    if (pluginView)
-        matchCount = pluginView->countFindMatches(string, core(options), maxMatchCount + 1);
-    else {
-        matchCount = m_webPage->corePage()->countFindMatches(string, core(options), maxMatchCount + 1);
-        m_webPage->corePage()->unmarkAllTextMatches();
+    if (pluginView) {
+        didCountStringMatches(string, pluginView->countFindMatches(string, core(options), maxMatchCount + 1), maxMatchCount);
+        return;
+    }
+
+    auto& page = *m_webPage->corePage();
+    page.unmarkAllTextMatches();
+
+    if (string.isEmpty()) {
+        didCountStringMatches(string, 0, maxMatchCount);
+        return;
+    }
+
+    auto coreOptions = core(options);
+    if (auto matchCount = findSessionMatchCount(string, coreOptions)) {
+        didCountStringMatches(string, *matchCount, maxMatchCount);
+        return;
+    }
+
+    m_pendingStringMatchCount = PendingStringMatchCount { string, coreOptions, maxMatchCount, domTreeVersion(page), &page.mainFrame(), WTF::nullopt, { } };
+    continueCountingStringMatches();
+}
+
+void FindController::continueCountingStringMatches()
+{
+    ASSERT(m_pendingStringMatchCount);
+    auto& page = *m_webPage->corePage();
+
+    // The positions kept between chunks may no longer be valid after a mutation, so the rest of
+    // the page is counted synchronously instead.
+    if (m_pendingStringMatchCount->domTreeVersion != domTreeVersion(page)) {
+        auto pendingCount = WTFMove(*m_pendingStringMatchCount);
+        m_pendingStringMatchCount = WTF::nullopt;
+        unsigned matchCount = page.countFindMatches(pendingCount.string, pendingCount.options, pendingCount.maxMatchCount + 1);
+        page.unmarkAllTextMatches();
+        didCountStringMatches(pendingCount.string, matchCount, pendingCount.maxMatchCount);
+        return;
+    }
+
+    auto sliceEndTime = MonotonicTime::now() + countStringMatchesTimeSlice;
+    while (m_pendingStringMatchCount->frame && m_pendingStringMatchCount->matches.size() <= m_pendingStringMatchCount->maxMatchCount) {
+        if (MonotonicTime::now() >= sliceEndTime) {
+            m_countStringMatchesTimer.startOneShot(0_s);
+            return;
+        }
+
+        if (!countStringMatchesInNextChunk()) {
+            m_pendingStringMatchCount->frame = m_pendingStringMatchCount->frame->tree().traverseNext();
+            m_pendingStringMatchCount->position = WTF::nullopt;
+        }
     }
 
+    auto pendingCount = WTFMove(*m_pendingStringMatchCount);
+    m_pendingStringMatchCount = WTF::nullopt;
+    updateFindSession(pendingCount.string, pendingCount.options, pendingCount.maxMatchCount + 1, pendingCount.matches);
+    didCountStringMatches(pendingCount.string, pendingCount.matches.size(), pendingCount.maxMatchCount);
+}
+
+// Collects the matches starting in the next chunk of the current frame. Returns false once the end of its document was reached.
+bool FindController::countStringMatchesInNextChunk()
+{
+    auto& count = *m_pendingStringMatchCount;
+    auto* document = count.frame->document();
+    if (!document)
+        return false;
+
+    document->updateLayoutIgnorePendingStylesheets();
+    if (!count.position)
+        count.position = makeBoundaryPointBeforeNodeContents(*document);
+
+    SimpleRange remainingRange { *count.position, makeBoundaryPointAfterNodeContents(*document) };
+    CharacterIterator iterator { remainingRange, TextIteratorEntersTextControls };
+    iterator.advance(countStringMatchesChunkLength);
+    bool isLastChunk = iterator.atEnd();
+    auto chunkEnd = isLastChunk ? remainingRange.end : iterator.range().start;
+
+    // Search a bit past the end of the chunk so that a match crossing it is found, and counted with this chunk.
+    auto searchEnd = remainingRange.end;
+    if (!isLastChunk) {
+        iterator.advance(count.string.length() - 1);
+        if (!iterator.atEnd())
+            searchEnd = iterator.range().start;
+    }
+
+    auto searchStart = *count.position;
+    uint64_t searchedLength = 0;
+    while (count.matches.size() <= count.maxMatchCount) {
+        auto match = findPlainText({ searchStart, searchEnd }, count.string, matchingOptions(count.options));
+        if (match.collapsed())
+            break;
+
+        uint64_t matchOffset = searchedLength + characterCount({ searchStart, match.start }, TextIteratorEntersTextControls);
+        if (!isLastChunk && matchOffset >= countStringMatchesChunkLength)
+            break;
+
+        searchedLength = matchOffset + characterCount(match, TextIteratorEntersTextControls);
+        searchStart = match.end;
+        count.matches.append(WTFMove(match));
+    }
+
+    if (isLastChunk)
+        return false;
+
+    count.position = searchedLength > countStringMatchesChunkLength ? searchStart : chunkEnd;
+    return true;
+}
+
+void FindController::didCountStringMatches(const String& string, unsigned matchCount, unsigned maxMatchCount)
+{
     if (matchCount > maxMatchCount)
         matchCount = static_cast<unsigned>(kWKMoreThanMaximumMatchCount);
-    
+
     m_webPage->send(Messages::WebPageProxy::DidCountStringMatches(string, matchCount));
 }
 
@@ -162,6 +405,8 @@ void FindController::updateFindUIAfterPageScroll(bool found, const String& strin
         if (shouldDetermineMatchIndex) {
             if (pluginView)
                 matchCount = pluginView->countFindMatches(string, core(options), maxMatchCount + 1);
+            else if (auto sessionMatchCount = findSessionMatchCount(string, core(options)))
+                matchCount = *sessionMatchCount > maxMatchCount ? maxMatchCount + 1 : *sessionMatchCount;
             else
                 matchCount = m_webPage->corePage()->countFindMatches(string, core(options), maxMatchCount + 1);
         }
@@ -245,7 +490,7 @@ void FindController::findString(const String& string, OptionSet<FindOptions> opt
     if (!pluginView) {
         if (Frame* selectedFrame = frameWithSelection(m_webPage->corePage())) {
             if (selectedFrame->selection().selectionBounds().isEmpty()) {
-                auto result = m_webPage->corePage()->findTextMatches(string, coreOptions, maxMatchCount);
+                auto result = findTextMatches(string, coreOptions, maxMatchCount);
                 m_findMatches = WTFMove(result.ranges);
                 m_foundStringMatchIndex = result.indexForSelection;
                 foundStringStartsAfterSelection = true;
@@ -283,7 +528,7 @@ void FindController::findString(const String& string, OptionSet<FindOptions> opt
 
 void FindController::findStringMatches(const String& string, OptionSet<FindOptions> options, unsigned maxMatchCount)
 {
-    auto result = m_webPage->corePage()->findTextMatches(string, core(options), maxMatchCount);
+    auto result = findTextMatches(string, core(options), maxMatchCount);
     m_findMatches = WTFMove(result.ranges);
 
     Vector<Vector<IntRect>> matchRects;
@@ -358,6 +603,9 @@ void FindController::indicateFindMatch(uint32_t matchIndex)
 void FindController::hideFindUI()
 {
     m_findMatches.clear();
+    m_findSession = WTF::nullopt;
+    m_countStringMatchesTimer.stop();
+    m_pendingStringMatchCount = WTF::nullopt;
     if (m_findPageOverlay)
         m_webPage->corePage()->pageOverlayController().uninstallPageOverlay(*m_findPageOverlay, PageOverlay::FadeMode::Fade);
 
@@ -470,6 +718,13 @@ Vector<FloatRect> FindController::rectsForTextMatchesInRect(IntRect clipRect)
         if (!document)
             continue;
 
+        // Don't compute the marker rects of subframes that are entirely outside the clip rect.
+        if (!frame->isMainFrame()) {
+            auto* frameView = frame->view();
+            if (!frameView || !mainFrameView->windowToContents(frameView->contentsToWindow(frameView->visibleContentRect())).intersects(clipRect))
+                continue;
+        }
+
         for (FloatRect rect : document->markers().renderedRectsForMarkers(DocumentMarker::TextMatch)) {
             if (!frame->isMainFrame())
                 rect = mainFrameView->windowToContents(frame->view()->contentsToWindow(enclosingIntRect(rect)));
@@ -33,6 +33,8 @@
 #include <WebCore/SimpleRange.h>
 #include <wtf/Forward.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/Optional.h>
+#include <wtf/RunLoop.h>
 #include <wtf/Vector.h>
 
 #if PLATFORM(IOS_FAMILY)
@@ -100,6 +102,21 @@ private:
     bool shouldHideFindIndicatorOnScroll() const;
     void didScrollAffectingFindIndicatorPosition();
 
+    struct TextMatches {
+        Vector<WebCore::SimpleRange> ranges;
+        int indexForSelection;
+    };
+    TextMatches findTextMatches(const String&, WebCore::FindOptions, unsigned maxMatchCount);
+
+    bool canUseFindSession(WebCore::FindOptions) const;
+    Optional<Vector<WebCore::SimpleRange>> refinedFindMatches(const String&, WebCore::FindOptions, unsigned maxMatchCount) const;
+    Optional<unsigned> findSessionMatchCount(const String&, WebCore::FindOptions);
+    void updateFindSession(const String&, WebCore::FindOptions, unsigned maxMatchCount, const Vector<WebCore::SimpleRange>&);
+
+    void continueCountingStringMatches();
+    bool countStringMatchesInNextChunk();
+    void didCountStringMatches(const String&, unsigned matchCount, unsigned maxMatchCount);
+
     WebPage* m_webPage;
     WebCore::PageOverlay* m_findPageOverlay { nullptr };
 
@@ -111,6 +128,29 @@ private:
     // Index value is -1 if not found or if number of matches exceeds provided maximum.
     int m_foundStringMatchIndex { -1 };
 
+    // Every match of the last complete search, so that a search for a longer query only has to
+    // check which of them still match instead of scanning the whole page again.
+    struct FindSession {
+        String string;
+        WebCore::FindOptions options;
+        uint64_t domTreeVersion { 0 };
+        Vector<WebCore::SimpleRange> matches;
+    };
+    Optional<FindSession> m_findSession;
+
+    // Match counting is done a chunk of text at a time, yielding to the run loop in between.
+    struct PendingStringMatchCount {
+        String string;
+        WebCore::FindOptions options;
+        unsigned maxMatchCount { 0 };
+        uint64_t domTreeVersion { 0 };
+        RefPtr<WebCore::Frame> frame;
+        Optional<WebCore::BoundaryPoint> position;
+        Vector<WebCore::SimpleRange> matches;
+    };
+    Optional<PendingStringMatchCount> m_pendingStringMatchCount;
+    RunLoop::Timer<FindController> m_countStringMatchesTimer;
+
 #if PLATFORM(IOS_FAMILY)
     RefPtr<WebCore::PageOverlay> m_findIndicatorOverlay;
     std::unique_ptr<FindIndicatorOverlayClientIOS> m_findIndicatorOverlayClient;
@@ -41,6 +41,7 @@
 #include <wtf/HashMap.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/ProcessID.h>
+#include <wtf/SetForScope.h>
 
 namespace WebKit {
 using namespace WebCore;
@@ -55,17 +56,31 @@ static IDToHistoryItemMap& idToHistoryItemMap()
     return map;
 }
 
-void WebBackForwardListProxy::addItemFromUIProcess(const BackForwardItemIdentifier& itemID, Ref<HistoryItem>&& item, PageIdentifier pageID, OverwriteExistingItem overwriteExistingItem)
+static HashSet<BackForwardItemIdentifier>& stubItemIDs()
+{
+    static NeverDestroyed<HashSet<BackForwardItemIdentifier>> itemIDs;
+    return itemIDs;
+}
+
+void WebBackForwardListProxy::addItemFromUIProcess(const BackForwardItemIdentifier& itemID, Ref<HistoryItem>&& item, PageIdentifier pageID, OverwriteExistingItem overwriteExistingItem, ItemStateIsStub itemStateIsStub)
 {
     if (overwriteExistingItem == OverwriteExistingItem::No && idToHistoryItemMap().contains(itemID))
         return;
 
     idToHistoryItemMap().set(itemID, item.ptr());
+    if (itemStateIsStub == ItemStateIsStub::Yes)
+        stubItemIDs().add(itemID);
+    else
+        stubItemIDs().remove(itemID);
     clearCachedListCounts();
 }
 
 static void WK2NotifyHistoryItemChanged(HistoryItem& item)
 {
+    // The UI process has the full state of stub items, which must not be overwritten with the stub.
+    if (stubItemIDs().contains(item.identifier()))
+        return;
+
     WebProcess::singleton().parentProcessConnection()->send(Messages::WebProcessProxy::UpdateBackForwardItem(toBackForwardListItemState(item)), 0);
 }
 
@@ -74,11 +89,29 @@ HistoryItem* WebBackForwardListProxy::itemForID(const BackForwardItemIdentifier&
     return idToHistoryItemMap().get(itemID);
 }
 
+HistoryItem* WebBackForwardListProxy::itemWithFullStateForID(const BackForwardItemIdentifier& itemID)
+{
+    auto* item = idToHistoryItemMap().get(itemID);
+    if (!item || !stubItemIDs().remove(itemID))
+        return item;
+
+    Optional<BackForwardListItemState> itemState;
+    if (!WebProcess::singleton().parentProcessConnection()->sendSync(Messages::WebProcessProxy::GetBackForwardItemState(itemID), Messages::WebProcessProxy::GetBackForwardItemState::Reply(itemState), 0) || !itemState)
+        return item;
+
+    // The item is filled in place since WebCore may already hold references to it.
+    SetForScope<void (*)(HistoryItem&)> bypassHistoryItemUpdateNotifications(WebCore::notifyHistoryItemChanged, [](HistoryItem&) { });
+    applyBackForwardListItemState(*item, *itemState);
+    return item;
+}
+
 void WebBackForwardListProxy::removeItem(const BackForwardItemIdentifier& itemID)
 {
     RefPtr<HistoryItem> item = idToHistoryItemMap().take(itemID);
     if (!item)
         return;
+
+    stubItemIDs().remove(itemID);
         
     BackForwardCache::singleton().remove(*item);
     WebCore::Page::clearPreviousItemFromAllPages(item.get());
@@ -126,7 +159,7 @@ RefPtr<HistoryItem> WebBackForwardListProxy::itemAtIndex(int itemIndex)
     if (!itemID)
         return nullptr;
 
-    return idToHistoryItemMap().get(*itemID);
+    return itemWithFullStateForID(*itemID);
 }
 
 unsigned WebBackForwardListProxy::backListCount() const
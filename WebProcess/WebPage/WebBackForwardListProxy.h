@@ -43,13 +43,16 @@ public:
     static Ref<WebBackForwardListProxy> create(WebPage& page) { return adoptRef(*new WebBackForwardListProxy(page)); }
 
     static WebCore::HistoryItem* itemForID(const WebCore::BackForwardItemIdentifier&);
+    // Like itemForID(), but first fetches the full state of the item from the UI process if only a stub was restored.
+    static WebCore::HistoryItem* itemWithFullStateForID(const WebCore::BackForwardItemIdentifier&);
     static void removeItem(const WebCore::BackForwardItemIdentifier&);
 
     enum class OverwriteExistingItem {
         Yes,
         No
     };
-    void addItemFromUIProcess(const WebCore::BackForwardItemIdentifier&, Ref<WebCore::HistoryItem>&&, WebCore::PageIdentifier, OverwriteExistingItem);
+    enum class ItemStateIsStub : bool { No, Yes };
+    void addItemFromUIProcess(const WebCore::BackForwardItemIdentifier&, Ref<WebCore::HistoryItem>&&, WebCore::PageIdentifier, OverwriteExistingItem, ItemStateIsStub = ItemStateIsStub::No);
 
     void clear();
 
@@ -30,6 +30,7 @@
 
 #include "APIArray.h"
 #include "APIGeometry.h"
+#include "ContentStreamSender.h"
 #include "DataReference.h"
 #include "DragControllerAction.h"
 #include "DrawingArea.h"
@@ -352,6 +353,8 @@ using namespace WebCore;
 static const Seconds pageScrollHysteresisDuration { 300_ms };
 static const Seconds initialLayerVolatilityTimerInterval { 20_ms };
 static const Seconds maximumLayerVolatilityTimerInterval { 2_s };
+// Tiled snapshots that get no tile request for this long are abandoned, so that the page does not stay frozen.
+static const Seconds tiledSnapshotTimeout { 30_s };
 
 #define RELEASE_LOG_IF_ALLOWED(channel, fmt, ...) RELEASE_LOG_IF(isAlwaysOnLoggingAllowed(), channel, "%p - [webPageID=%" PRIu64 "] WebPage::" fmt, this, m_identifier.toUInt64(), ##__VA_ARGS__)
 #define RELEASE_LOG_ERROR_IF_ALLOWED(channel, fmt, ...) RELEASE_LOG_ERROR_IF(isAlwaysOnLoggingAllowed(), channel, "%p - [webPageID=%" PRIu64 "] WebPage::" fmt, this, m_identifier.toUInt64(), ##__VA_ARGS__)
@@ -451,6 +454,7 @@ WebPage::WebPage(PageIdentifier pageID, WebPageCreationParameters&& parameters)
     , m_nativeWindowHandle(parameters.nativeWindowHandle)
 #endif
     , m_setCanStartMediaTimer(RunLoop::main(), this, &WebPage::setCanStartMediaTimerFired)
+    , m_tiledSnapshotTimeoutTimer(RunLoop::main(), this, &WebPage::tiledSnapshotTimeoutTimerFired)
 #if ENABLE(CONTEXT_MENUS)
     , m_contextMenuClient(makeUnique<API::InjectedBundle::PageContextMenuClient>())
 #endif
@@ -901,6 +905,16 @@ void WebPage::reinitializeWebPage(WebPageCreationParameters&& parameters)
     setMinimumSizeForAutoLayout(parameters.minimumSizeForAutoLayout);
     setSizeToContentAutoSizeMaximumSize(parameters.sizeToContentAutoSizeMaximumSize);
 
+    // The UI process computes later preference deltas against parameters.store, so it has to be applied here too.
+    if (auto delta = parameters.store.deltaFrom(m_preferencesStore)) {
+        auto changedKeys = m_preferencesStore.applyDelta(*delta);
+        if (!changedKeys.isEmpty()) {
+            updateChangedPreferencesGenerated(m_preferencesStore, changedKeys);
+            updatePreferencesNotGenerated(m_preferencesStore);
+        }
+    } else
+        updatePreferences(parameters.store);
+
     if (m_activityState != parameters.activityState)
         setActivityState(parameters.activityState, ActivityStateChangeAsynchronous, Vector<CallbackID>());
     if (m_layerHostingMode != parameters.layerHostingMode)
@@ -1754,7 +1768,7 @@ void WebPage::goToBackForwardItem(uint64_t navigationID, const BackForwardItemId
 
     ASSERT(isBackForwardLoadType(backForwardType));
 
-    HistoryItem* item = WebBackForwardListProxy::itemForID(backForwardItemID);
+    HistoryItem* item = WebBackForwardListProxy::itemWithFullStateForID(backForwardItemID);
     ASSERT(item);
     if (!item)
         return;
@@ -2421,6 +2435,66 @@ void WebPage::takeSnapshot(IntRect snapshotRect, IntSize bitmapSize, uint32_t op
     send(Messages::WebPageProxy::ImageCallback(handle, callbackID));
 }
 
+// Tiles are painted by separate messages, so the page is kept still in between: layer tree commits are
+// frozen and timers, animations and active DOM objects are suspended until the last tile is taken.
+// Work that isn't suspended, like parsing incoming network data, can still change the page between tiles.
+void WebPage::beginTiledSnapshot(uint64_t snapshotID)
+{
+    m_tiledSnapshotTimeoutTimer.startOneShot(tiledSnapshotTimeout);
+    if (!m_tiledSnapshots.add(snapshotID).isNewEntry || m_tiledSnapshots.size() > 1)
+        return;
+
+    freezeLayerTree(LayerTreeFreezeReason::TiledSnapshot);
+    m_page->suspendActiveDOMObjectsAndAnimations();
+}
+
+void WebPage::endTiledSnapshot(uint64_t snapshotID)
+{
+    if (!m_tiledSnapshots.remove(snapshotID) || !m_tiledSnapshots.isEmpty())
+        return;
+
+    m_tiledSnapshotTimeoutTimer.stop();
+    m_page->resumeActiveDOMObjectsAndAnimations();
+    unfreezeLayerTree(LayerTreeFreezeReason::TiledSnapshot);
+}
+
+void WebPage::tiledSnapshotTimeoutTimerFired()
+{
+    if (m_tiledSnapshots.isEmpty())
+        return;
+
+    RELEASE_LOG_ERROR_IF_ALLOWED(Layers, "tiledSnapshotTimeoutTimerFired: Unfreezing the page after %u tiled snapshots were abandoned", m_tiledSnapshots.size());
+    m_tiledSnapshots.clear();
+    m_page->resumeActiveDOMObjectsAndAnimations();
+    unfreezeLayerTree(LayerTreeFreezeReason::TiledSnapshot);
+}
+
+void WebPage::takeSnapshotTile(IntRect snapshotRect, IntSize bitmapSize, IntRect tileRect, uint32_t options, CompletionHandler<void(const ShareableBitmap::Handle&)>&& completionHandler)
+{
+    if (!m_tiledSnapshots.isEmpty())
+        m_tiledSnapshotTimeoutTimer.startOneShot(tiledSnapshotTimeout);
+
+    SnapshotOptions snapshotOptions = static_cast<SnapshotOptions>(options);
+    snapshotOptions |= SnapshotOptionsShareable;
+
+    ShareableBitmap::Handle handle;
+    if (auto image = snapshotTileAtSize(snapshotRect, bitmapSize, tileRect, snapshotOptions))
+        image->bitmap().createHandle(handle, SharedMemory::Protection::ReadOnly);
+
+    completionHandler(handle);
+}
+
+void WebPage::getMainFrameScrollGeometry(CompletionHandler<void(const IntRect&, const IntSize&)>&& completionHandler)
+{
+    auto* frameView = mainFrameView();
+    if (!frameView) {
+        completionHandler({ }, { });
+        return;
+    }
+
+    completionHandler(frameView->visibleContentRect(), frameView->contentsSize());
+}
+
 RefPtr<WebImage> WebPage::scaledSnapshotWithOptions(const IntRect& rect, double additionalScaleFactor, SnapshotOptions options)
 {
     IntRect snapshotRect = rect;
@@ -2441,7 +2515,7 @@ RefPtr<WebImage> WebPage::scaledSnapshotWithOptions(const IntRect& rect, double
     return snapshotAtSize(rect, bitmapSize, options);
 }
 
-void WebPage::paintSnapshotAtSize(const IntRect& rect, const IntSize& bitmapSize, SnapshotOptions options, Frame& frame, FrameView& frameView, GraphicsContext& graphicsContext)
+void WebPage::paintSnapshotAtSize(const IntRect& rect, const IntSize& bitmapSize, SnapshotOptions options, Frame& frame, FrameView& frameView, GraphicsContext& graphicsContext, const IntRect& tileRect)
 {
     IntRect snapshotRect = rect;
     float horizontalScaleFactor = static_cast<float>(bitmapSize.width()) / rect.width();
@@ -2453,9 +2527,29 @@ void WebPage::paintSnapshotAtSize(const IntRect& rect, const IntSize& bitmapSize
         return;
     }
 
-    Color documentBackgroundColor = frameView.documentBackgroundColor();
-    Color backgroundColor = (frame.settings().backgroundShouldExtendBeyondPage() && documentBackgroundColor.isValid()) ? documentBackgroundColor : frameView.baseBackgroundColor();
-    graphicsContext.fillRect(IntRect(IntPoint(), bitmapSize), backgroundColor);
+    // A tile is painted with the same transform as the whole bitmap, shifted so that the tile is at the origin,
+    // and only the part of the page that it covers is painted.
+    IntRect bitmapRect(IntPoint(), bitmapSize);
+    IntRect paintRect = snapshotRect;
+    if (!tileRect.isEmpty()) {
+        graphicsContext.translate(-tileRect.location());
+        bitmapRect = tileRect;
+        FloatRect tileRectInSnapshot = tileRect;
+        tileRectInSnapshot.scale(1 / scaleFactor);
+        tileRectInSnapshot.moveBy(snapshotRect.location());
+        paintRect.intersect(enclosingIntRect(tileRectInSnapshot));
+    }
+
+    Color savedBaseBackgroundColor;
+    if (options & SnapshotOptionsTransparentBackground) {
+        graphicsContext.clearRect(bitmapRect);
+        savedBaseBackgroundColor = frameView.baseBackgroundColor();
+        frameView.setBaseBackgroundColor(Color::transparentBlack);
+    } else {
+        Color documentBackgroundColor = frameView.documentBackgroundColor();
+        Color backgroundColor = (frame.settings().backgroundShouldExtendBeyondPage() && documentBackgroundColor.isValid()) ? documentBackgroundColor : frameView.baseBackgroundColor();
+        graphicsContext.fillRect(bitmapRect, backgroundColor);
+    }
 
     if (!(options & SnapshotOptionsExcludeDeviceScaleFactor)) {
         double deviceScaleFactor = frame.page()->deviceScaleFactor();
@@ -2474,7 +2568,10 @@ void WebPage::paintSnapshotAtSize(const IntRect& rect, const IntSize& bitmapSize
     if (options & SnapshotOptionsInViewCoordinates)
         coordinateSpace = FrameView::ViewCoordinates;
 
-    frameView.paintContentsForSnapshot(graphicsContext, snapshotRect, shouldPaintSelection, coordinateSpace);
+    frameView.paintContentsForSnapshot(graphicsContext, paintRect, shouldPaintSelection, coordinateSpace);
+
+    if (options & SnapshotOptionsTransparentBackground)
+        frameView.setBaseBackgroundColor(savedBaseBackgroundColor);
 
     if (options & SnapshotOptionsPaintSelectionRectangle) {
         FloatRect selectionRectangle = frame.selection().selectionBounds();
@@ -2494,6 +2591,11 @@ static ShareableBitmap::Configuration snapshotOptionsToBitmapConfiguration(Snaps
 }
 
 RefPtr<WebImage> WebPage::snapshotAtSize(const IntRect& rect, const IntSize& bitmapSize, SnapshotOptions options)
+{
+    return snapshotTileAtSize(rect, bitmapSize, { }, options);
+}
+
+RefPtr<WebImage> WebPage::snapshotTileAtSize(const IntRect& rect, const IntSize& bitmapSize, const IntRect& tileRect, SnapshotOptions options)
 {
     Frame* coreFrame = m_mainFrame->coreFrame();
     if (!coreFrame)
@@ -2503,14 +2605,17 @@ RefPtr<WebImage> WebPage::snapshotAtSize(const IntRect& rect, const IntSize& bit
     if (!frameView)
         return nullptr;
 
-    auto snapshot = WebImage::create(bitmapSize, snapshotOptionsToImageOptions(options), snapshotOptionsToBitmapConfiguration(options, *this));
+    if (!tileRect.isEmpty() && (!IntRect(IntPoint(), bitmapSize).contains(tileRect) || rect.isEmpty() || options & SnapshotOptionsPrinting))
+        return nullptr;
+
+    auto snapshot = WebImage::create(tileRect.isEmpty() ? bitmapSize : tileRect.size(), snapshotOptionsToImageOptions(options), snapshotOptionsToBitmapConfiguration(options, *this));
     if (!snapshot)
         return nullptr;
     auto graphicsContext = snapshot->bitmap().createGraphicsContext();
     if (!graphicsContext)
         return nullptr;
 
-    paintSnapshotAtSize(rect, bitmapSize, options, *coreFrame, *frameView, *graphicsContext);
+    paintSnapshotAtSize(rect, bitmapSize, options, *coreFrame, *frameView, *graphicsContext, tileRect);
 
     return snapshot;
 }
@@ -3001,7 +3106,8 @@ void WebPage::restoreSessionInternal(const Vector<BackForwardListItemState>& ite
     for (const auto& itemState : itemStates) {
         auto historyItem = toHistoryItem(itemState);
         historyItem->setWasRestoredFromSession(restoredByAPIRequest == WasRestoredByAPIRequest::Yes);
-        static_cast<WebBackForwardListProxy&>(corePage()->backForward().client()).addItemFromUIProcess(itemState.identifier, WTFMove(historyItem), m_identifier, overwrite);
+        auto itemStateIsStub = itemState.isStub ? WebBackForwardListProxy::ItemStateIsStub::Yes : WebBackForwardListProxy::ItemStateIsStub::No;
+        static_cast<WebBackForwardListProxy&>(corePage()->backForward().client()).addItemFromUIProcess(itemState.identifier, WTFMove(historyItem), m_identifier, overwrite, itemStateIsStub);
     }
 }
 
@@ -3615,6 +3721,70 @@ void WebPage::getContentsAsMHTMLData(CallbackID callbackID)
 }
 #endif
 
+void WebPage::streamContentsAsString(ContentAsStringIncludesChildFrames includeChildFrames, uint64_t streamID)
+{
+    Vector<RefPtr<WebFrame>> frames;
+    if (includeChildFrames == ContentAsStringIncludesChildFrames::Yes) {
+        for (RefPtr<Frame> frame = m_mainFrame->coreFrame(); frame; frame = frame->tree().traverseNextRendered()) {
+            if (auto* webFrame = WebFrame::fromCoreFrame(*frame))
+                frames.append(webFrame);
+        }
+    } else
+        frames.append(m_mainFrame.copyRef());
+
+    // Each frame is converted to text in one go, the text is then sent a piece at a time.
+    size_t frameIndex = 0;
+    String frameText;
+    unsigned offset = 0;
+    bool isEmpty = true;
+    ContentStreamSender::create(m_identifier, streamID, [frames = WTFMove(frames), frameIndex, frameText, offset, isEmpty](ContentStreamSender& sender) mutable {
+        static const unsigned maximumLengthPerCall = 256 * 1024;
+        if (offset == frameText.length()) {
+            if (frameIndex == frames.size())
+                return false;
+            if (!isEmpty)
+                sender.append(reinterpret_cast<const uint8_t*>("\n\n"), 2);
+            frameText = frames[frameIndex++]->contentsAsString();
+            offset = 0;
+            return true;
+        }
+
+        unsigned length = std::min(maximumLengthPerCall, frameText.length() - offset);
+        sender.appendUTF8(StringView(frameText).substring(offset, length));
+        offset += length;
+        isEmpty = false;
+        return true;
+    })->start();
+}
+
+static ContentStreamSender::Producer sharedBufferProducer(Ref<SharedBuffer>&& buffer)
+{
+    static const size_t maximumSizePerCall = 1024 * 1024;
+    // The buffer is not modified anymore, so the segment iterator stays valid.
+    auto segment = buffer->begin();
+    size_t offset = 0;
+    return [buffer = WTFMove(buffer), segment, offset](ContentStreamSender& sender) mutable {
+        while (segment != buffer->end() && offset == segment->segment->size()) {
+            ++segment;
+            offset = 0;
+        }
+        if (segment == buffer->end())
+            return false;
+
+        size_t size = std::min(maximumSizePerCall, segment->segment->size() - offset);
+        sender.append(reinterpret_cast<const uint8_t*>(segment->segment->data()) + offset, size);
+        offset += size;
+        return true;
+    };
+}
+
+#if ENABLE(MHTML)
+void WebPage::streamContentsAsMHTMLData(uint64_t streamID)
+{
+    ContentStreamSender::create(m_identifier, streamID, sharedBufferProducer(MHTMLArchive::generateMHTMLData(m_page.get())))->start();
+}
+#endif
+
 void WebPage::getRenderTreeExternalRepresentation(CallbackID callbackID)
 {
     String resultString = renderTreeExternalRepresentation();
@@ -3728,6 +3898,30 @@ void WebPage::getWebArchiveOfFrame(FrameIdentifier frameID, CallbackID callbackI
     send(Messages::WebPageProxy::DataCallback(dataReference, callbackID));
 }
 
+void WebPage::streamWebArchiveOfFrame(FrameIdentifier frameID, uint64_t streamID)
+{
+    RefPtr<SharedBuffer> buffer;
+#if PLATFORM(COCOA)
+    if (WebFrame* frame = WebProcess::singleton().webFrame(frameID)) {
+        if (auto data = frame->webArchiveData(nullptr, nullptr))
+            buffer = SharedBuffer::create(data.get());
+    }
+#else
+    UNUSED_PARAM(frameID);
+#endif
+
+    if (!buffer) {
+        // Web archives are only supported on Cocoa ports. Fail the stream rather than report an empty archive.
+        ContentStreamSender::create(m_identifier, streamID, [](ContentStreamSender& sender) {
+            sender.fail();
+            return false;
+        })->start();
+        return;
+    }
+
+    ContentStreamSender::create(m_identifier, streamID, sharedBufferProducer(buffer.releaseNonNull()))->start();
+}
+
 void WebPage::forceRepaintWithoutCallback()
 {
     m_drawingArea->forceRepaint();
@@ -3744,11 +3938,28 @@ void WebPage::preferencesDidChange(const WebPreferencesStore& store)
     updatePreferences(store);
 }
 
+void WebPage::preferencesDidChangeDelta(const WebPreferencesStore::Delta& delta)
+{
+    // Keys overridden by the test runner revert to their stored values, so they have to be reapplied as well.
+    auto changedKeys = WebPreferencesStore::testRunnerOverriddenKeys();
+    WebPreferencesStore::removeTestRunnerOverrides();
+
+    changedKeys.appendVector(m_preferencesStore.applyDelta(delta));
+    updateChangedPreferencesGenerated(m_preferencesStore, changedKeys);
+    updatePreferencesNotGenerated(m_preferencesStore);
+}
+
 void WebPage::updatePreferences(const WebPreferencesStore& store)
 {
+    m_preferencesStore = store;
+
     updatePreferencesGenerated(store);
     updateSettingsGenerated(store);
+    updatePreferencesNotGenerated(store);
+}
 
+void WebPage::updatePreferencesNotGenerated(const WebPreferencesStore& store)
+{
     Settings& settings = m_page->settings();
 
 #if !PLATFORM(GTK) && !PLATFORM(WIN)
@@ -6620,6 +6831,18 @@ void WebPage::urlSchemeTaskDidReceiveData(uint64_t handlerIdentifier, uint64_t t
     handler->taskDidReceiveData(taskIdentifier, data.size(), data.data());
 }
 
+void WebPage::urlSchemeTaskDidReceiveSharedData(uint64_t handlerIdentifier, uint64_t taskIdentifier, SharedMemory::IPCHandle&& data)
+{
+    auto* handler = m_identifierToURLSchemeHandlerProxyMap.get(handlerIdentifier);
+    ASSERT(handler);
+
+    auto sharedMemory = SharedMemory::map(data.handle, SharedMemory::Protection::ReadOnly);
+    if (!sharedMemory || data.dataSize > sharedMemory->size())
+        return;
+
+    handler->taskDidReceiveData(taskIdentifier, data.dataSize, static_cast<const uint8_t*>(sharedMemory->data()));
+}
+
 void WebPage::urlSchemeTaskDidComplete(uint64_t handlerIdentifier, uint64_t taskIdentifier, const ResourceError& error)
 {
     auto* handler = m_identifierToURLSchemeHandlerProxyMap.get(handlerIdentifier);
@@ -59,6 +59,7 @@
 #include "UserData.h"
 #include "WebBackForwardListProxy.h"
 #include "WebPageMessagesReplies.h"
+#include "WebPreferencesStore.h"
 #include "WebURLSchemeHandler.h"
 #include "WebUndoStepID.h"
 #include "WebUserContentController.h"
@@ -309,7 +310,6 @@ struct UserMessage;
 struct WebAutocorrectionData;
 struct WebAutocorrectionContext;
 struct WebPageCreationParameters;
-struct WebPreferencesStore;
 struct WebsitePoliciesData;
 
 #if ENABLE(UI_SIDE_COMPOSITING)
@@ -804,6 +804,7 @@ public:
         Printing                = 1 << 4,
         ProcessSwap             = 1 << 5,
         SwipeAnimation          = 1 << 6,
+        TiledSnapshot           = 1 << 7,
     };
     void freezeLayerTree(LayerTreeFreezeReason);
     void unfreezeLayerTree(LayerTreeFreezeReason);
@@ -1565,14 +1566,27 @@ private:
     void getSelectionAsWebArchiveData(CallbackID);
     void getSourceForFrame(WebCore::FrameIdentifier, CallbackID);
     void getWebArchiveOfFrame(WebCore::FrameIdentifier, CallbackID);
+    void streamContentsAsString(ContentAsStringIncludesChildFrames, uint64_t streamID);
+#if ENABLE(MHTML)
+    void streamContentsAsMHTMLData(uint64_t streamID);
+#endif
+    void streamWebArchiveOfFrame(WebCore::FrameIdentifier, uint64_t streamID);
     void runJavaScript(WebFrame*, WebCore::RunJavaScriptParameters&&, ContentWorldIdentifier, CompletionHandler<void(const IPC::DataReference&, const Optional<WebCore::ExceptionDetails>&)>&&);
     void runJavaScriptInFrameInScriptWorld(WebCore::RunJavaScriptParameters&&, Optional<WebCore::FrameIdentifier>, const std::pair<ContentWorldIdentifier, String>& worldData, CompletionHandler<void(const IPC::DataReference&, const Optional<WebCore::ExceptionDetails>&)>&&);
     void forceRepaint(CompletionHandler<void()>&&);
     void takeSnapshot(WebCore::IntRect snapshotRect, WebCore::IntSize bitmapSize, uint32_t options, CallbackID);
+    void beginTiledSnapshot(uint64_t snapshotID);
+    void takeSnapshotTile(WebCore::IntRect snapshotRect, WebCore::IntSize bitmapSize, WebCore::IntRect tileRect, uint32_t options, CompletionHandler<void(const ShareableBitmap::Handle&)>&&);
+    void endTiledSnapshot(uint64_t snapshotID);
+    void tiledSnapshotTimeoutTimerFired();
+    void getMainFrameScrollGeometry(CompletionHandler<void(const WebCore::IntRect&, const WebCore::IntSize&)>&&);
 
     void preferencesDidChange(const WebPreferencesStore&);
+    void preferencesDidChangeDelta(const WebPreferencesStore::Delta&);
     void updatePreferences(const WebPreferencesStore&);
+    void updatePreferencesNotGenerated(const WebPreferencesStore&);
     void updateSettingsGenerated(const WebPreferencesStore&);
+    void updateChangedPreferencesGenerated(const WebPreferencesStore&, const Vector<WebPreferencesKey::Index>&);
 
 #if PLATFORM(IOS_FAMILY)
     bool parentProcessHasServiceWorkerEntitlement() const;
@@ -1762,6 +1776,7 @@ private:
     void urlSchemeTaskDidPerformRedirection(uint64_t handlerIdentifier, uint64_t taskIdentifier, WebCore::ResourceResponse&&, WebCore::ResourceRequest&&);
     void urlSchemeTaskDidReceiveResponse(uint64_t handlerIdentifier, uint64_t taskIdentifier, const WebCore::ResourceResponse&);
     void urlSchemeTaskDidReceiveData(uint64_t handlerIdentifier, uint64_t taskIdentifier, const IPC::DataReference&);
+    void urlSchemeTaskDidReceiveSharedData(uint64_t handlerIdentifier, uint64_t taskIdentifier, SharedMemory::IPCHandle&&);
     void urlSchemeTaskDidComplete(uint64_t handlerIdentifier, uint64_t taskIdentifier, const WebCore::ResourceError&);
 
     void setIsTakingSnapshotsForApplicationSuspension(bool);
@@ -1770,6 +1785,8 @@ private:
     void setIsSuspended(bool);
 
     RefPtr<WebImage> snapshotAtSize(const WebCore::IntRect&, const WebCore::IntSize& bitmapSize, SnapshotOptions);
+    // Renders the part of the snapshotAtSize() bitmap covered by tileRect, given in bitmap coordinates.
+    RefPtr<WebImage> snapshotTileAtSize(const WebCore::IntRect&, const WebCore::IntSize& bitmapSize, const WebCore::IntRect& tileRect, SnapshotOptions);
     RefPtr<WebImage> snapshotNode(WebCore::Node&, SnapshotOptions, unsigned maximumPixelCount = std::numeric_limits<unsigned>::max());
 #if PLATFORM(COCOA)
     RetainPtr<CFDataRef> pdfSnapshotAtSize(WebCore::IntRect, WebCore::IntSize bitmapSize, SnapshotOptions);
@@ -1787,7 +1804,7 @@ private:
 
     void updateMockAccessibilityElementAfterCommittingLoad();
 
-    void paintSnapshotAtSize(const WebCore::IntRect&, const WebCore::IntSize&, SnapshotOptions, WebCore::Frame&, WebCore::FrameView&, WebCore::GraphicsContext&);
+    void paintSnapshotAtSize(const WebCore::IntRect&, const WebCore::IntSize&, SnapshotOptions, WebCore::Frame&, WebCore::FrameView&, WebCore::GraphicsContext&, const WebCore::IntRect& tileRect = { });
 
 #if PLATFORM(GTK) || PLATFORM(WPE)
     void sendMessageToWebExtension(UserMessage&&);
@@ -1810,6 +1827,9 @@ private:
 
     RefPtr<WebPageGroupProxy> m_pageGroup;
 
+    // Last store received from the UI process; PreferencesDidChangeDelta messages are applied against it.
+    WebPreferencesStore m_preferencesStore;
+
     String m_userAgent;
 
     WebCore::IntSize m_viewSize;
@@ -2153,6 +2173,9 @@ private:
 
     OptionSet<LayerTreeFreezeReason> m_layerTreeFreezeReasons;
     bool m_isSuspended { false };
+    // The page stays frozen while any of these tiled snapshots is being taken.
+    HashSet<uint64_t> m_tiledSnapshots;
+    RunLoop::Timer<WebPage> m_tiledSnapshotTimeoutTimer;
     bool m_needsFontAttributes { false };
     bool m_firstFlushAfterCommit { false };
 #if PLATFORM(COCOA)
@@ -356,6 +356,10 @@ void WebProcess::initializeWebProcess(WebProcessCreationParameters&& parameters)
     // Match the QoS of the UIProcess and the scrolling thread but use a slightly lower priority.
     WTF::Thread::setCurrentThreadIsUserInteractive(-1);
 
+#if ENABLE(IOS_TOUCH_EVENTS)
+    m_eventDispatcher->setCoalescesTouchMovesWithinDisplayFrame(parameters.coalescesTouchMovesWithinDisplayFrame);
+#endif
+
     m_suppressMemoryPressureHandler = parameters.shouldSuppressMemoryPressureHandler;
     if (!m_suppressMemoryPressureHandler) {
         auto& memoryPressureHandler = MemoryPressureHandler::singleton();